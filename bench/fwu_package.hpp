@@ -0,0 +1,145 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "utils.hpp"
+
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pldm
+{
+namespace bench
+{
+struct PackageComponent
+{
+    uint16_t classification;
+    uint16_t identifier;
+    uint32_t comparisonStamp;
+    size_t size;
+};
+
+/** @brief Firmware device targeted by a generated package */
+struct PackageDevice
+{
+    std::vector<std::pair<uint16_t, std::vector<uint8_t>>> descriptors;
+    std::vector<PackageComponent> components;
+    std::string pkgVersion = "pldmd-bench";
+    std::string imageSetVersion = "2.0.0";
+};
+
+template <typename T>
+inline void put(std::vector<uint8_t>& buffer, const T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        buffer.emplace_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+inline void putString(std::vector<uint8_t>& buffer, const std::string& str)
+{
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+/** @brief Build a DSP0267 1.0 package with a single device ID record
+ *
+ * All components of the device, at most eight, are applicable to the record
+ * and are followed by generated component images.
+ */
+inline std::vector<uint8_t> makeFirmwarePackage(const PackageDevice& device)
+{
+    constexpr std::array<uint8_t, 16> pkgHeaderIdentifier = {
+        0xF0, 0x18, 0x87, 0x8C, 0xCB, 0x7D, 0x49, 0x43,
+        0x98, 0x00, 0xA0, 0x2F, 0x05, 0x9A, 0xCA, 0x02};
+    constexpr uint8_t asciiString = 1;
+    constexpr size_t fwDevIdRecordSize = 11;
+    constexpr size_t checksumSize = 4;
+
+    std::vector<uint8_t> pkg(pkgHeaderIdentifier.begin(),
+                             pkgHeaderIdentifier.end());
+    put<uint8_t>(pkg, 1); // PackageHeaderFormatRevision
+    const size_t headerSizeOffset = pkg.size();
+    put<uint16_t>(pkg, 0);
+    pkg.insert(pkg.end(), 13, 0); // PackageReleaseDateTime
+    put<uint16_t>(pkg, 8);        // ComponentBitmapBitLength
+    put(pkg, asciiString);
+    put(pkg, static_cast<uint8_t>(device.pkgVersion.size()));
+    putString(pkg, device.pkgVersion);
+
+    std::vector<uint8_t> descriptors;
+    for (const auto& [type, data] : device.descriptors)
+    {
+        put(descriptors, type);
+        put(descriptors, static_cast<uint16_t>(data.size()));
+        descriptors.insert(descriptors.end(), data.begin(), data.end());
+    }
+    put<uint8_t>(pkg, 1); // DeviceIDRecordCount
+    put(pkg, static_cast<uint16_t>(fwDevIdRecordSize + 1 +
+                                   device.imageSetVersion.size() +
+                                   descriptors.size()));
+    put(pkg, static_cast<uint8_t>(device.descriptors.size()));
+    put<uint32_t>(pkg, 0); // DeviceUpdateOptionFlags
+    put(pkg, asciiString);
+    put(pkg, static_cast<uint8_t>(device.imageSetVersion.size()));
+    put<uint16_t>(pkg, 0); // FirmwareDevicePackageDataLength
+    put(pkg, static_cast<uint8_t>((1 << device.components.size()) - 1));
+    putString(pkg, device.imageSetVersion);
+    pkg.insert(pkg.end(), descriptors.begin(), descriptors.end());
+
+    std::vector<size_t> locationOffsets;
+    put(pkg, static_cast<uint16_t>(device.components.size()));
+    for (const PackageComponent& component : device.components)
+    {
+        put(pkg, component.classification);
+        put(pkg, component.identifier);
+        put(pkg, component.comparisonStamp);
+        put<uint16_t>(pkg, 0); // ComponentOptions
+        put<uint16_t>(pkg, 0); // RequestedComponentActivationMethod
+        locationOffsets.emplace_back(pkg.size());
+        put<uint32_t>(pkg, 0);
+        put(pkg, static_cast<uint32_t>(component.size));
+        put(pkg, asciiString);
+        put(pkg, static_cast<uint8_t>(device.imageSetVersion.size()));
+        putString(pkg, device.imageSetVersion);
+    }
+
+    const size_t headerSize = pkg.size() + checksumSize;
+    pkg[headerSizeOffset] = static_cast<uint8_t>(headerSize);
+    pkg[headerSizeOffset + 1] = static_cast<uint8_t>(headerSize >> 8);
+    size_t location = headerSize;
+    for (size_t i = 0; i < device.components.size(); i++)
+    {
+        for (size_t j = 0; j < sizeof(uint32_t); j++)
+        {
+            pkg[locationOffsets[i] + j] =
+                static_cast<uint8_t>(location >> (8 * j));
+        }
+        location += device.components[i].size;
+    }
+    put(pkg, utils::crc32Update(0, pkg.data(), pkg.size()));
+
+    pkg.reserve(location);
+    for (size_t i = headerSize; i < location; i++)
+    {
+        pkg.emplace_back(static_cast<uint8_t>(i * 31));
+    }
+    return pkg;
+}
+} // namespace bench
+} // namespace pldm
@@ -0,0 +1,497 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fru.hpp"
+#include "fwu_package.hpp"
+#include "platform.hpp"
+#include "platform_association.hpp"
+#include "pldm.hpp"
+#include "simulated_transport.hpp"
+#include "transport.hpp"
+#include "utils.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <phosphor-logging/log.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <xyz/openbmc_project/PLDM/FWU/FWUBase/server.hpp>
+
+extern void setIoContext(const std::shared_ptr<boost::asio::io_context>& newIo);
+extern void
+    setSdBus(const std::shared_ptr<sdbusplus::asio::connection>& newBus);
+extern void setObjServer(
+    const std::shared_ptr<sdbusplus::asio::object_server>& newServer);
+
+namespace pldm
+{
+namespace bench
+{
+using FWUBase = sdbusplus::xyz::openbmc_project::PLDM::FWU::server::FWUBase;
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* pldmService = "xyz.openbmc_project.pldm";
+constexpr const char* fwuPath = "/xyz/openbmc_project/pldm/fwu";
+constexpr mctpw::eid_t firstEid = 8;
+constexpr size_t numericSensorsPerTerminus = 16;
+constexpr size_t stateSensorsPerTerminus = 4;
+constexpr std::chrono::minutes firmwareUpdateTimeout{30};
+
+struct Options
+{
+    std::vector<size_t> discoveryTermini = {1, 4, 16};
+    std::vector<size_t> pdrRecordCounts = {16, 64, 256};
+    std::vector<size_t> fruRecordCounts = {1, 16, 64};
+    size_t pollTermini = 4;
+    std::chrono::seconds pollWindow{10};
+    size_t firmwareSize = 1024 * 1024;
+    std::chrono::microseconds latency{0};
+    std::string output;
+};
+
+/** @brief One JSON object of the benchmark report */
+class Result
+{
+  public:
+    explicit Result(const std::string& scenario)
+    {
+        add("scenario", scenario);
+    }
+
+    Result& add(const std::string& key, const double value)
+    {
+        std::ostringstream str;
+        str << value;
+        return addField(key, str.str());
+    }
+
+    Result& add(const std::string& key, const std::string& value)
+    {
+        return addField(key, "\"" + value + "\"");
+    }
+
+    std::string str() const
+    {
+        return "{" + fields + "}";
+    }
+
+  private:
+    Result& addField(const std::string& key, const std::string& value)
+    {
+        fields += (fields.empty() ? "\"" : ", \"") + key + "\": " + value;
+        return *this;
+    }
+
+    std::string fields;
+};
+
+static Options options;
+static std::vector<Result> results;
+static uint16_t scenarioCount = 0;
+// Replaced transports may still have simulated messages in flight
+static std::vector<std::unique_ptr<Transport>> retiredTransports;
+
+static double toSeconds(const Clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+static double getSpan(const simulator::CommandStats& stats)
+{
+    return stats.count ? toSeconds(stats.last - stats.first) : 0.0;
+}
+
+static void sleepFor(boost::asio::yield_context yield,
+                     const Clock::duration duration)
+{
+    boost::asio::steady_timer timer(*getIoContext(), duration);
+    boost::system::error_code ec;
+    timer.async_wait(yield[ec]);
+}
+
+static simulator::TerminusConfig makeTerminus(const size_t index,
+                                              const size_t numericSensors,
+                                              const size_t stateSensors)
+{
+    simulator::TerminusConfig config = simulator::makeDefaultTerminus(
+        static_cast<mctpw::eid_t>(firstEid + index), numericSensors,
+        stateSensors);
+    // A fresh UUID per scenario keeps the base discovery cache cold
+    config.uuid[8] = static_cast<uint8_t>(scenarioCount >> 8);
+    config.uuid[9] = static_cast<uint8_t>(scenarioCount);
+    config.latency = options.latency;
+    return config;
+}
+
+static simulator::SimulatedTransport&
+    installTransport(std::vector<simulator::TerminusConfig> termini)
+{
+    scenarioCount++;
+    if (transport)
+    {
+        retiredTransports.emplace_back(std::move(transport));
+    }
+    auto simulated = std::make_unique<simulator::SimulatedTransport>(
+        *getIoContext(), std::move(termini), msgRecvCallback);
+    simulator::SimulatedTransport& ref = *simulated;
+    transport = std::move(simulated);
+    return ref;
+}
+
+static double discoverAll(boost::asio::yield_context yield)
+{
+    const auto start = Clock::now();
+    for (const mctpw::eid_t eid : transport->getEndpoints())
+    {
+        platform::pauseSensorPolling();
+        initDevice(eid, yield);
+        platform::resumeSensorPolling();
+    }
+    return toSeconds(Clock::now() - start);
+}
+
+static void removeAll()
+{
+    for (const auto& [tid, eid] : tidMapper.getTIDMap())
+    {
+        deleteDevice(tid);
+    }
+    // Every scenario starts with the full TID pool
+    base::resetTIDMapping();
+}
+
+static void benchDiscovery(boost::asio::yield_context yield)
+{
+    for (const size_t count : options.discoveryTermini)
+    {
+        std::vector<simulator::TerminusConfig> termini;
+        for (size_t i = 0; i < count; i++)
+        {
+            termini.emplace_back(makeTerminus(i, numericSensorsPerTerminus,
+                                              stateSensorsPerTerminus));
+        }
+        installTransport(std::move(termini));
+        const double seconds = discoverAll(yield);
+        results.emplace_back(
+            Result("discovery")
+                .add("termini", static_cast<double>(count))
+                .add("seconds", seconds)
+                .add("ms_per_terminus",
+                     seconds * 1000 / static_cast<double>(count)));
+        removeAll();
+    }
+}
+
+static void benchSensorPolling(boost::asio::yield_context yield)
+{
+    std::vector<simulator::TerminusConfig> termini;
+    for (size_t i = 0; i < options.pollTermini; i++)
+    {
+        termini.emplace_back(makeTerminus(i, numericSensorsPerTerminus,
+                                          stateSensorsPerTerminus));
+    }
+    simulator::SimulatedTransport& sim = installTransport(std::move(termini));
+    discoverAll(yield);
+
+    sim.resetStats();
+    sleepFor(yield, options.pollWindow);
+    const double readings =
+        static_cast<double>(sim.getCommandStats(PLDM_PLATFORM,
+                                                simulator::command::
+                                                    getSensorReading)
+                                .count +
+                            sim.getCommandStats(PLDM_PLATFORM,
+                                                simulator::command::
+                                                    getStateSensorReadings)
+                                .count);
+    const double sensors =
+        static_cast<double>(options.pollTermini *
+                            (numericSensorsPerTerminus +
+                             stateSensorsPerTerminus));
+    const double readingsPerSecond =
+        readings / static_cast<double>(options.pollWindow.count());
+    results.emplace_back(
+        Result("sensor_polling")
+            .add("termini", static_cast<double>(options.pollTermini))
+            .add("sensors", sensors)
+            .add("readings_per_second", readingsPerSecond)
+            .add("refresh_period_seconds",
+                 readingsPerSecond > 0 ? sensors / readingsPerSecond : 0.0));
+    removeAll();
+}
+
+static void benchPDRDownload(boost::asio::yield_context yield)
+{
+    for (const size_t count : options.pdrRecordCounts)
+    {
+        simulator::SimulatedTransport& sim =
+            installTransport({makeTerminus(0, count, 0)});
+        discoverAll(yield);
+        simulator::CommandStats stats =
+            sim.getCommandStats(PLDM_PLATFORM, simulator::command::getPDR);
+        const double seconds = getSpan(stats);
+        results.emplace_back(
+            Result("pdr_download")
+                .add("records", static_cast<double>(count))
+                .add("get_pdr_commands", static_cast<double>(stats.count))
+                .add("seconds", seconds)
+                .add("records_per_second",
+                     seconds > 0 ? static_cast<double>(count) / seconds
+                                 : 0.0));
+        removeAll();
+    }
+}
+
+static void benchFRUFetch(boost::asio::yield_context yield)
+{
+    for (const size_t count : options.fruRecordCounts)
+    {
+        simulator::TerminusConfig config = makeTerminus(0, 0, 0);
+        config.fruTable.clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            auto record = simulator::makeGeneralFRURecord(
+                static_cast<uint16_t>(i + 1),
+                {{PLDM_FRU_FIELD_TYPE_MANUFAC, "Intel Corporation"},
+                 {PLDM_FRU_FIELD_TYPE_SN, "BENCH" + std::to_string(i)}});
+            config.fruTable.insert(config.fruTable.end(), record.begin(),
+                                   record.end());
+        }
+        config.fruRecordSetCount = static_cast<uint16_t>(count);
+        config.fruRecordCount = static_cast<uint16_t>(count);
+        const size_t tableSize = config.fruTable.size();
+
+        simulator::SimulatedTransport& sim = installTransport({config});
+        discoverAll(yield);
+        simulator::CommandStats metadata = sim.getCommandStats(
+            PLDM_FRU, simulator::command::getFRURecordTableMetadata);
+        simulator::CommandStats table = sim.getCommandStats(
+            PLDM_FRU, simulator::command::getFRURecordTable);
+        results.emplace_back(
+            Result("fru_fetch")
+                .add("records", static_cast<double>(count))
+                .add("table_bytes", static_cast<double>(tableSize))
+                .add("get_fru_record_table_commands",
+                     static_cast<double>(table.count))
+                .add("seconds", table.count && metadata.count
+                                    ? toSeconds(table.last - metadata.first)
+                                    : 0.0));
+        removeAll();
+    }
+}
+
+static void benchFirmwareUpdate(boost::asio::yield_context yield)
+{
+    simulator::TerminusConfig config = makeTerminus(0, 0, 0);
+    const simulator::FirmwareDevice& fd = *config.firmwareDevice;
+    const simulator::FirmwareComponent& component = fd.components.at(0);
+    PackageDevice device;
+    for (const auto& descriptor : fd.descriptors)
+    {
+        device.descriptors.emplace_back(descriptor.type, descriptor.data);
+    }
+    device.components.emplace_back(PackageComponent{
+        component.classification, component.identifier,
+        component.comparisonStamp + 1, options.firmwareSize});
+    const std::vector<uint8_t> pkg = makeFirmwarePackage(device);
+    const std::filesystem::path pkgPath =
+        std::filesystem::temp_directory_path() / "pldmd-bench.pldm";
+    {
+        std::ofstream file(pkgPath, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(pkg.data()),
+                   static_cast<std::streamsize>(pkg.size()));
+    }
+
+    simulator::SimulatedTransport& sim = installTransport({config});
+    discoverAll(yield);
+    platform::pauseSensorPolling();
+    sim.resetStats();
+
+    boost::system::error_code ec;
+    const auto start = Clock::now();
+    int rc = getSdBus()->yield_method_call<int>(
+        yield, ec, pldmService, fwuPath, FWUBase::interface, "StartFWUpdate",
+        pkgPath.string());
+    bool activated = false;
+    while (!ec && rc == 0 && Clock::now() - start < firmwareUpdateTimeout)
+    {
+        if (sim.getCommandStats(PLDM_FWUP, simulator::command::activateFirmware)
+                .count)
+        {
+            activated = true;
+            break;
+        }
+        sleepFor(yield, std::chrono::milliseconds(100));
+    }
+    const double updateSeconds = toSeconds(Clock::now() - start);
+    simulator::CommandStats transfer = sim.getCommandStats(
+        PLDM_FWUP, simulator::command::requestFirmwareData);
+    const double transferSeconds = getSpan(transfer);
+    results.emplace_back(
+        Result("firmware_update")
+            .add("image_bytes", static_cast<double>(options.firmwareSize))
+            .add("status", activated ? "activated" : "failed")
+            .add("request_firmware_data_commands",
+                 static_cast<double>(transfer.count))
+            .add("transfer_seconds", transferSeconds)
+            .add("transfer_mb_per_second",
+                 transferSeconds > 0
+                     ? static_cast<double>(options.firmwareSize) / 1e6 /
+                           transferSeconds
+                     : 0.0)
+            .add("update_seconds", updateSeconds));
+
+    std::error_code removeEc;
+    std::filesystem::remove(pkgPath, removeEc);
+    platform::resumeSensorPolling();
+    removeAll();
+}
+
+static void writeReport()
+{
+    std::ostringstream report;
+    report << "{\"latency_us\": " << options.latency.count()
+           << ", \"results\": [";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        report << (i ? ",\n  " : "\n  ") << results[i].str();
+    }
+    report << "\n]}\n";
+
+    if (options.output.empty())
+    {
+        std::cout << report.str();
+        return;
+    }
+    std::ofstream file(options.output, std::ios::out | std::ios::trunc);
+    file << report.str();
+}
+
+static std::vector<size_t> parseList(const std::string& value)
+{
+    std::vector<size_t> list;
+    std::istringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        list.emplace_back(std::stoul(item));
+    }
+    return list;
+}
+
+static bool parseOptions(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const size_t separator = arg.find('=');
+        if (separator == std::string::npos)
+        {
+            return false;
+        }
+        const std::string key = arg.substr(0, separator);
+        const std::string value = arg.substr(separator + 1);
+        if (key == "--termini")
+        {
+            options.discoveryTermini = parseList(value);
+        }
+        else if (key == "--pdr-records")
+        {
+            options.pdrRecordCounts = parseList(value);
+        }
+        else if (key == "--fru-records")
+        {
+            options.fruRecordCounts = parseList(value);
+        }
+        else if (key == "--poll-termini")
+        {
+            options.pollTermini = std::stoul(value);
+        }
+        else if (key == "--poll-seconds")
+        {
+            options.pollWindow = std::chrono::seconds(std::stoul(value));
+        }
+        else if (key == "--firmware-bytes")
+        {
+            options.firmwareSize = std::stoul(value);
+        }
+        else if (key == "--latency-us")
+        {
+            options.latency = std::chrono::microseconds(std::stoul(value));
+        }
+        else if (key == "--output")
+        {
+            options.output = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.pollWindow.count() > 0;
+}
+} // namespace bench
+} // namespace pldm
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (!pldm::bench::parseOptions(argc, argv))
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--termini=1,4,16] [--pdr-records=16,64,256]"
+                         " [--fru-records=1,16,64] [--poll-termini=4]"
+                         " [--poll-seconds=10] [--firmware-bytes=1048576]"
+                         " [--latency-us=0] [--output=report.json]\n";
+            return 1;
+        }
+    }
+    catch (const std::exception&)
+    {
+        std::cerr << "Invalid argument\n";
+        return 1;
+    }
+
+    // Caches and checkpoints of an earlier run would skip the work measured
+    std::error_code ec;
+    std::filesystem::remove_all(utils::stateDir, ec);
+
+    auto ioc = std::make_shared<boost::asio::io_context>();
+    setIoContext(ioc);
+    auto conn = std::make_shared<sdbusplus::asio::connection>(*ioc);
+    auto objectServer = std::make_shared<sdbusplus::asio::object_server>(conn);
+    objectServer->add_manager("/xyz/openbmc_project/sensors");
+    conn->request_name(pldm::bench::pldmService);
+    setSdBus(conn);
+    setObjServer(objectServer);
+    pldm::platform::association::init();
+
+    boost::asio::spawn(*ioc, [ioc](boost::asio::yield_context yield) {
+        pldm::bench::benchDiscovery(yield);
+        pldm::bench::benchSensorPolling(yield);
+        pldm::bench::benchPDRDownload(yield);
+        pldm::bench::benchFRUFetch(yield);
+        pldm::bench::benchFirmwareUpdate(yield);
+        pldm::bench::writeReport();
+        ioc->stop();
+    });
+    ioc->run();
+    return 0;
+}
@@ -0,0 +1,384 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fru.hpp"
+#include "fwu_package.hpp"
+#include "fwu_utils.hpp"
+#include "numeric_sensor.hpp"
+#include "packet_capture.hpp"
+#include "pdr_manager.hpp"
+#include "pdr_utils.hpp"
+#include "pldm_fwu_image.hpp"
+#include "thresholds.hpp"
+#include "utils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern void setIoContext(const std::shared_ptr<boost::asio::io_context>& newIo);
+extern void
+    setSdBus(const std::shared_ptr<sdbusplus::asio::connection>& newBus);
+extern void setObjServer(
+    const std::shared_ptr<sdbusplus::asio::object_server>& newServer);
+
+namespace pldm
+{
+namespace fwu
+{
+extern std::map<pldm_tid_t, FDProperties> terminusFwuProperties;
+} // namespace fwu
+
+namespace bench
+{
+using DescriptorIdentifierType = fwu::DescriptorIdentifierType;
+constexpr auto pciVendorIDType =
+    static_cast<uint16_t>(DescriptorIdentifierType::pciVendorID);
+constexpr auto pciDeviceIDType =
+    static_cast<uint16_t>(DescriptorIdentifierType::pciDeviceID);
+constexpr auto pciSubsystemVendorIDType =
+    static_cast<uint16_t>(DescriptorIdentifierType::pciSubsystemVendorID);
+constexpr auto pciSubsystemIDType =
+    static_cast<uint16_t>(DescriptorIdentifierType::pciSubsystemID);
+constexpr size_t firmwareImageSize = 4096;
+// Distinct packages used to miss the parsed package header cache
+constexpr size_t coldPackageCount = 8;
+
+static pldm_numeric_sensor_value_pdr makeNumericSensorPDR()
+{
+    pldm_numeric_sensor_value_pdr pdr = {};
+    pdr.sensor_data_size = PLDM_SENSOR_DATA_SIZE_UINT16;
+    pdr.resolution = 0.5;
+    pdr.offset = -40;
+    pdr.unit_modifier = -3;
+    return pdr;
+}
+
+static void BM_FetchSensorValue(benchmark::State& state)
+{
+    const pldm_numeric_sensor_value_pdr pdr = makeNumericSensorPDR();
+    union_sensor_data_size data = {};
+    for (auto _ : state)
+    {
+        data.value_u16++;
+        benchmark::DoNotOptimize(pdr::sensor::fetchSensorValue(pdr, data));
+    }
+}
+BENCHMARK(BM_FetchSensorValue);
+
+static void BM_CalculateSensorValue(benchmark::State& state)
+{
+    const pldm_numeric_sensor_value_pdr pdr = makeNumericSensorPDR();
+    float reading = 0;
+    for (auto _ : state)
+    {
+        reading += 1;
+        benchmark::DoNotOptimize(
+            pdr::sensor::calculateSensorValue(pdr, reading));
+    }
+}
+BENCHMARK(BM_CalculateSensorValue);
+
+/** @brief Alternate between a nominal reading and one crossing the
+ * thresholds selected by the benchmark argument, 0 for none and 1 for the
+ * high critical threshold.
+ */
+static void BM_CheckThresholds(benchmark::State& state)
+{
+    std::vector<thresholds::Threshold> thresholdData = {
+        {thresholds::Level::warning, thresholds::Direction::high, 80},
+        {thresholds::Level::critical, thresholds::Direction::high, 90},
+        {thresholds::Level::warning, thresholds::Direction::low, 5},
+        {thresholds::Level::critical, thresholds::Direction::low, 0}};
+    NumericSensor sensor("bench_threshold_" + std::to_string(state.range(0)),
+                         thresholdData, 127, -128, 1, SensorUnit::DegreesC,
+                         false, "");
+    const double crossing = state.range(0) ? 95 : 40;
+    bool toggle = false;
+    for (auto _ : state)
+    {
+        toggle = !toggle;
+        sensor.value = toggle ? crossing : 40;
+        benchmark::DoNotOptimize(thresholds::checkThresholds(sensor));
+    }
+}
+BENCHMARK(BM_CheckThresholds)->Arg(0)->Arg(1);
+
+static std::vector<uint8_t> makeFRUTable(const size_t recordCount)
+{
+    const std::vector<std::pair<uint8_t, std::string>> fields = {
+        {PLDM_FRU_FIELD_TYPE_MANUFAC, "Intel Corporation"},
+        {PLDM_FRU_FIELD_TYPE_NAME, "Bench Device"},
+        {PLDM_FRU_FIELD_TYPE_PN, "PN0123456789"},
+        {PLDM_FRU_FIELD_TYPE_SN, "SN0123456789"},
+        {PLDM_FRU_FIELD_TYPE_VERSION, "1.0.0"}};
+    std::vector<uint8_t> table;
+    for (size_t i = 0; i < recordCount; i++)
+    {
+        put(table, static_cast<uint16_t>(i + 1));
+        put<uint8_t>(table, PLDM_FRU_RECORD_TYPE_GENERAL);
+        put(table, static_cast<uint8_t>(fields.size()));
+        put<uint8_t>(table, PLDM_FRU_ENCODING_ASCII);
+        for (const auto& [type, value] : fields)
+        {
+            put(table, type);
+            put(table, static_cast<uint8_t>(value.size()));
+            putString(table, value);
+        }
+    }
+    // Pad and CRC32 as returned by GetFRURecordTable
+    table.insert(table.end(), (4 - table.size() % 4) % 4, 0);
+    put(table, utils::crc32Update(0, table.data(), table.size()));
+    return table;
+}
+
+static void BM_ParseFRUTable(benchmark::State& state)
+{
+    const std::vector<uint8_t> table =
+        makeFRUTable(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        fru::PLDMFRUTable fruTable(table, 1);
+        benchmark::DoNotOptimize(fruTable.parseTable());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(table.size()));
+}
+BENCHMARK(BM_ParseFRUTable)->Arg(1)->Arg(16)->Arg(64);
+
+static PackageDevice makePackageDevice(const size_t componentCount)
+{
+    PackageDevice device;
+    device.descriptors = {{pciVendorIDType, {0x86, 0x80}},
+                          {pciDeviceIDType, {0x34, 0x12}}};
+    for (size_t i = 0; i < componentCount; i++)
+    {
+        device.components.emplace_back(
+            PackageComponent{0x000A, static_cast<uint16_t>(i + 1), 2,
+                             firmwareImageSize});
+    }
+    return device;
+}
+
+static void addFirmwareDevice()
+{
+    fwu::DescriptorsMap descriptors = {
+        {"PCIVendorID", static_cast<uint16_t>(0x8086)},
+        {"PCIDeviceID", static_cast<uint16_t>(0x1234)}};
+    fwu::terminusFwuProperties[1] =
+        std::make_tuple(fwu::FWUProperties{}, descriptors,
+                        fwu::CompPropertiesMap{});
+}
+
+static std::filesystem::path writePackage(const std::vector<uint8_t>& pkg,
+                                          const size_t index)
+{
+    std::filesystem::path path =
+        std::filesystem::temp_directory_path() /
+        ("pldmd-microbench-" + std::to_string(index) + ".pldm");
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char*>(pkg.data()),
+               static_cast<std::streamsize>(pkg.size()));
+    return path;
+}
+
+/** @brief Parse package headers, cycling through more packages than the
+ * parsed header cache holds when the benchmark argument is 1. Runs the same
+ * path as StartFWUpdate, including the hops to the worker pool.
+ */
+static void BM_ProcessPkgHdr(benchmark::State& state)
+{
+    addFirmwareDevice();
+    const size_t packageCount = state.range(0) ? coldPackageCount : 1;
+    std::vector<std::filesystem::path> paths;
+    for (size_t i = 0; i < packageCount; i++)
+    {
+        PackageDevice device = makePackageDevice(4);
+        device.pkgVersion = "pldmd-microbench-" + std::to_string(i);
+        paths.emplace_back(writePackage(makeFirmwarePackage(device), i));
+    }
+
+    auto ioc = getIoContext();
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        fwu::PLDMImg img(paths[next].string());
+        std::optional<bool> processed;
+        boost::asio::spawn(
+            *ioc, [&img, &processed](boost::asio::yield_context yield) {
+                processed = img.processPkgHdr(yield);
+            });
+        // The D-Bus connection keeps the io_context busy, run until done
+        while (!processed)
+        {
+            ioc->run_one();
+        }
+        if (!*processed)
+        {
+            state.SkipWithError("processPkgHdr failed");
+            break;
+        }
+        next = (next + 1) % paths.size();
+    }
+
+    std::error_code ec;
+    for (const auto& path : paths)
+    {
+        std::filesystem::remove(path, ec);
+    }
+    fwu::terminusFwuProperties.clear();
+}
+BENCHMARK(BM_ProcessPkgHdr)->Arg(0)->Arg(1);
+
+static void BM_UnpackDescriptors(benchmark::State& state)
+{
+    std::vector<uint8_t> data;
+    for (const uint16_t type : {pciVendorIDType, pciDeviceIDType,
+                                pciSubsystemVendorIDType, pciSubsystemIDType})
+    {
+        put(data, type);
+        put<uint16_t>(data, sizeof(uint16_t));
+        put<uint16_t>(data, 0x8086);
+    }
+    for (auto _ : state)
+    {
+        uint16_t initialDescriptorType = 0;
+        fwu::DescriptorsMap descriptors;
+        fwu::unpackDescriptors(4, data, initialDescriptorType, descriptors);
+        benchmark::DoNotOptimize(descriptors);
+    }
+}
+BENCHMARK(BM_UnpackDescriptors);
+
+/** @brief Hex dump of a message, with PLDM_DEBUG disabled and enabled as
+ * selected by the second benchmark argument
+ */
+static void BM_PrintVect(benchmark::State& state)
+{
+    std::vector<uint8_t> message(static_cast<size_t>(state.range(0)));
+    for (size_t i = 0; i < message.size(); i++)
+    {
+        message[i] = static_cast<uint8_t>(i);
+    }
+    debug = state.range(1);
+    for (auto _ : state)
+    {
+        utils::printVect("PLDM message received(MCTP payload):", message);
+    }
+    debug = false;
+}
+BENCHMARK(BM_PrintVect)->ArgsProduct({{16, 256}, {0, 1}});
+
+static void BM_CapturePacket(benchmark::State& state)
+{
+    std::vector<uint8_t> message(static_cast<size_t>(state.range(0)));
+    if (state.range(1))
+    {
+        capture::startCapture(capture::defaultCaptureEntries);
+    }
+    for (auto _ : state)
+    {
+        capture::capturePacket(capture::Direction::received, 8, false, 0,
+                               message);
+    }
+    capture::stopCapture();
+}
+BENCHMARK(BM_CapturePacket)->ArgsProduct({{16, 256}, {0, 1}});
+
+using EntityMap = std::unordered_map<pldm_entity, std::string,
+                                     platform::EntityHash,
+                                     platform::EntityComparator>;
+
+/** @brief Entities laid out like a terminus PDR repository, a few entity
+ * types with consecutive instance numbers in consecutive containers.
+ */
+static std::vector<pldm_entity> makeEntities(const size_t count)
+{
+    constexpr size_t instancesPerContainer = 8;
+    constexpr uint16_t entityTypes[] = {64, 66, 67, 135, 137};
+    std::vector<pldm_entity> entities;
+    for (size_t i = 0; i < count; i++)
+    {
+        pldm_entity entity = {};
+        entity.entity_type = entityTypes[i % std::size(entityTypes)];
+        entity.entity_instance_num =
+            static_cast<uint16_t>(i % instancesPerContainer + 1);
+        entity.entity_container_id =
+            static_cast<uint16_t>(i / instancesPerContainer + 1);
+        entities.emplace_back(entity);
+    }
+    return entities;
+}
+
+static void BM_EntityMapInsert(benchmark::State& state)
+{
+    const std::vector<pldm_entity> entities =
+        makeEntities(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        EntityMap map;
+        for (const pldm_entity& entity : entities)
+        {
+            map.emplace(entity, "Entity");
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EntityMapInsert)->Arg(16)->Arg(256)->Arg(1024);
+
+static void BM_EntityMapFind(benchmark::State& state)
+{
+    const std::vector<pldm_entity> entities =
+        makeEntities(static_cast<size_t>(state.range(0)));
+    EntityMap map;
+    for (const pldm_entity& entity : entities)
+    {
+        map.emplace(entity, "Entity");
+    }
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find(entities[next]));
+        next = (next + 1) % entities.size();
+    }
+}
+BENCHMARK(BM_EntityMapFind)->Arg(16)->Arg(256)->Arg(1024);
+} // namespace bench
+} // namespace pldm
+
+int main(int argc, char** argv)
+{
+    // NumericSensor publishes its interfaces, give it a bus to talk to
+    auto ioc = std::make_shared<boost::asio::io_context>();
+    setIoContext(ioc);
+    auto conn = std::make_shared<sdbusplus::asio::connection>(*ioc);
+    setSdBus(conn);
+    setObjServer(std::make_shared<sdbusplus::asio::object_server>(conn));
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
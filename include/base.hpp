@@ -17,7 +17,11 @@
 #pragma once
 
 #include <boost/asio/spawn.hpp>
+#include <array>
 #include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include "base.h"
 
@@ -50,6 +54,9 @@ namespace pldm
 {
 namespace base
 {
+using SupportedPLDMTypes = std::array<bitfield8_t, 8>;
+using PLDMVersions = std::vector<ver32_t>;
+using VersionSupportTable = std::unordered_map<uint8_t, PLDMVersions>;
 // For bitfield8[N], where N = 0 to 31;
 // (bit M is set) => PLDM Command (N*8+M) Supported
 using SupportedCommands = std::array<bitfield8_t, 32>;
@@ -87,5 +94,21 @@ bool isSupported(pldm_tid_t tid, const uint8_t type, const uint8_t cmd);
  */
 bool isSupported(pldm_tid_t tid, const uint8_t type);
 
+/** @brief API that gets the UUID of a discovered terminus
+ *
+ * @param tid PLDM TID of device
+ * @return UUID reported by GetTerminusUID; std::nullopt if the terminus did
+ * not report one
+ */
+std::optional<std::array<uint8_t, 16>> getTerminusUUID(const pldm_tid_t tid);
+
+#ifdef PLDM_BENCH
+/** @brief API that forgets all UUID-TID and TID-EID mappings and returns every
+ * TID to the pool without waiting for the reclaim window. Used between
+ * benchmark scenarios.
+ */
+void resetTIDMapping();
+#endif
+
 } // namespace base
 } // namespace pldm
@@ -0,0 +1,62 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "base.hpp"
+#include "platform.hpp"
+
+#include <optional>
+
+namespace pldm
+{
+namespace base
+{
+constexpr uint32_t baseCacheMagic = 0x43534142; // "BASC"
+constexpr uint8_t baseCacheVersion = 1;
+constexpr size_t maxBaseCacheEntries = 255;
+
+struct BaseCacheHeader
+{
+    uint32_t magic;
+    uint8_t version;
+    uint16_t entryCount;
+} __attribute__((packed));
+
+/** @brief API that gets the persisted CommandSupportTable of a terminus
+ *
+ * Base discovery results are cached by terminus UUID. A cached entry is only
+ * returned while the PLDM types bitmap and the PLDM base versions reported by
+ * the terminus still match the ones seen when the entry was stored. Versions
+ * of other PLDM types are not compared, entries are dropped instead whenever
+ * pldmd activates new firmware on the terminus.
+ */
+std::optional<CommandSupportTable>
+    getCachedCommandSupportTable(const pldm::platform::UUID& uuid,
+                                 const SupportedPLDMTypes& pldmTypes,
+                                 const PLDMVersions& baseVersions);
+
+/** @brief API that persists the CommandSupportTable of a terminus
+ */
+void cacheCommandSupportTable(const pldm::platform::UUID& uuid,
+                              const SupportedPLDMTypes& pldmTypes,
+                              const PLDMVersions& baseVersions,
+                              const CommandSupportTable& cmdSupportTable);
+
+/** @brief API that drops the persisted CommandSupportTable of a terminus
+ */
+void removeCachedCommandSupportTable(const pldm::platform::UUID& uuid);
+} // namespace base
+} // namespace pldm
@@ -0,0 +1,89 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <array>
+#include <chrono>
+
+namespace pldm
+{
+namespace stats
+{
+// Latency histogram buckets are log-linear: every power of two microseconds
+// is split into 2^subBucketBits linear buckets.
+constexpr size_t subBucketBits = 2;
+constexpr size_t subBucketCount = 1 << subBucketBits;
+// Buckets cover latencies up to 2^25us(~33s), the last one also collects
+// everything above
+constexpr size_t maxLatencyBits = 25;
+constexpr size_t latencyBucketCount =
+    (maxLatencyBits - subBucketBits + 1) * subBucketCount;
+
+using LatencyHistogram = std::array<uint64_t, latencyBucketCount>;
+
+/** @brief Counters of a command. Failed sends and requests that got no
+ * response count as timeouts. Responses that don't match the request count as
+ * invalid responses.
+ */
+struct CommandCounters
+{
+    uint64_t requests = 0;
+    uint64_t retries = 0;
+    uint64_t timeouts = 0;
+    uint64_t ccErrors = 0;
+    uint64_t invalidResponses = 0;
+    uint64_t latencySum = 0;
+    LatencyHistogram latency = {};
+};
+
+/** @brief Identifies the counters of a command sent to a terminus */
+struct CommandKey
+{
+    pldm_tid_t tid;
+    uint8_t pldmType;
+    uint8_t command;
+};
+
+/** @brief API that gets the CommandKey of a PLDM message without MCTP type*/
+CommandKey getCommandKey(const pldm_tid_t tid,
+                         const std::vector<uint8_t>& pldmMsg);
+
+/** @brief API that gets the histogram bucket of a latency in microseconds*/
+size_t getLatencyBucket(const uint64_t latency);
+
+/** @brief API that gets the lowest latency in microseconds of a bucket*/
+uint64_t getLatencyBucketLowerBound(const size_t bucket);
+
+void recordRequest(const CommandKey& key);
+void recordRetry(const CommandKey& key);
+void recordTimeout(const CommandKey& key);
+void recordInvalidResponse(const CommandKey& key);
+
+/** @brief Record a response and its completion code, if any */
+void recordResponse(const CommandKey& key,
+                    const std::chrono::steady_clock::duration latency,
+                    const std::vector<uint8_t>& pldmResp);
+
+/** @brief Record the completion of a message sent without response */
+void recordSent(const CommandKey& key,
+                const std::chrono::steady_clock::duration latency);
+
+/** @brief Expose the counters on xyz.openbmc_project.PLDM.Statistics */
+void initializeStatisticsIntf();
+} // namespace stats
+} // namespace pldm
@@ -0,0 +1,155 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <functional>
+#include <memory>
+#include <tuple>
+
+namespace pldm
+{
+namespace platform
+{
+/** @brief Requests, sets sent, superseded requests and current depth*/
+using WriteQueueStatistics = std::tuple<uint64_t, uint64_t, uint64_t, uint32_t>;
+
+/** @brief Last-writer-wins queue of effecter writes
+ *
+ * Only one set is in flight per effecter. A write arriving meanwhile waits
+ * in the single pending slot, replacing the value already waiting there. The
+ * replaced writer returns success without sending as its value would be
+ * overwritten right away.
+ */
+template <typename Value>
+class EffecterWriteQueue
+{
+  public:
+    using Writer = std::function<bool(boost::asio::yield_context, Value)>;
+
+    EffecterWriteQueue() = default;
+    EffecterWriteQueue(const EffecterWriteQueue&) = delete;
+    EffecterWriteQueue& operator=(const EffecterWriteQueue&) = delete;
+
+    /** @brief Wake the pending writer, which fails without touching the
+     * destroyed queue
+     */
+    ~EffecterWriteQueue()
+    {
+        *alive = false;
+        if (pending)
+        {
+            pending->timer.cancel();
+        }
+    }
+
+    /** @brief Send value through writer once the in-flight set completes.
+     * Returns the result of writer, true if value got superseded, or false if
+     * the queue was destroyed meanwhile.
+     */
+    bool write(boost::asio::yield_context yield, const Value value,
+               const Writer& writer)
+    {
+        std::shared_ptr<bool> queueAlive = alive;
+        requests++;
+        if (inFlight)
+        {
+            if (pending)
+            {
+                pending->superseded = true;
+                pending->timer.cancel();
+                superseded++;
+            }
+            auto waiter = std::make_shared<Waiter>();
+            pending = waiter;
+            boost::system::error_code ec;
+            waiter->timer.async_wait(yield[ec]);
+            if (!*queueAlive)
+            {
+                return false;
+            }
+            if (waiter->superseded)
+            {
+                return true;
+            }
+            // The completed set handed over, inFlight stays set
+        }
+        inFlight = true;
+        InFlightGuard guard{*this, std::move(queueAlive)};
+
+        writes++;
+        return writer(yield, value);
+    }
+
+    WriteQueueStatistics getStatistics() const
+    {
+        const uint32_t depth = (inFlight ? 1U : 0U) + (pending ? 1U : 0U);
+        return {requests, writes, superseded, depth};
+    }
+
+  private:
+    struct Waiter
+    {
+        boost::asio::steady_timer timer{
+            *getIoContext(), boost::asio::steady_timer::time_point::max()};
+        bool superseded = false;
+    };
+
+    /** @brief Ends the in-flight set on every exit path of write, including
+     * the writer throwing, unless the queue was destroyed during the set
+     */
+    struct InFlightGuard
+    {
+        EffecterWriteQueue& queue;
+        std::shared_ptr<bool> queueAlive;
+
+        ~InFlightGuard()
+        {
+            if (*queueAlive)
+            {
+                queue.finishWrite();
+            }
+        }
+    };
+
+    /** @brief Hand over to the pending writer, if any, else go idle */
+    void finishWrite()
+    {
+        if (pending)
+        {
+            std::shared_ptr<Waiter> next = std::move(pending);
+            pending.reset();
+            next->timer.cancel();
+        }
+        else
+        {
+            inFlight = false;
+        }
+    }
+
+    // Shared with the suspended writers, cleared on destruction
+    std::shared_ptr<bool> alive = std::make_shared<bool>(true);
+    std::shared_ptr<Waiter> pending;
+    bool inFlight = false;
+    uint64_t requests = 0;
+    uint64_t writes = 0;
+    uint64_t superseded = 0;
+};
+} // namespace platform
+} // namespace pldm
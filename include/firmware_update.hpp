@@ -15,9 +15,11 @@
  */
 #pragma once
 
+#include "fwu_checkpoint.hpp"
 #include "fwu_utils.hpp"
 
 #include <boost/asio/steady_timer.hpp>
+#include <optional>
 #include <sdbusplus/asio/object_server.hpp>
 #include <set>
 
@@ -48,6 +50,9 @@ class FWUpdate
 
   private:
     bool isComponentApplicable();
+    bool isComponentCompleted();
+    bool resumeFromCheckpoint(const boost::asio::yield_context yield);
+    int startUpdateSession(const boost::asio::yield_context yield);
     boost::system::error_code startTimer(const boost::asio::yield_context yield,
                                          const uint32_t interval);
     uint32_t findMaxNumReq(const uint32_t size)
@@ -69,11 +74,11 @@ class FWUpdate
                           uint32_t& nextDataTransferHandle,
                           uint8_t& transferFlag);
     int processSendPackageData(const boost::asio::yield_context yield);
-    int sendPackageData(const boost::asio::yield_context yield, size_t& offset,
-                        size_t& length, std::set<uint32_t>& recvdRequests);
+    int sendFDData(const boost::asio::yield_context yield,
+                   const uint8_t command, const std::vector<uint8_t>& data,
+                   FWUDataTransfer& transfer);
     uint8_t setTransferFlag(const size_t offset, const size_t length,
                             const size_t dataSize);
-    size_t calcMaxNumReq(const size_t dataSize);
     int processPassComponentTable(const boost::asio::yield_context yield);
     int passComponentTable(
         const boost::asio::yield_context yield,
@@ -97,7 +102,8 @@ class FWUpdate
                             const std ::vector<uint8_t>& pldmReq,
                             uint32_t& offset, uint32_t& length,
                             const uint32_t componentSize,
-                            const uint32_t componentOffset);
+                            const uint32_t componentOffset,
+                            FWUDataTransfer& transfer);
     uint8_t validateTransferComplete(const uint8_t transferResult);
     int processTransferComplete(const boost::asio::yield_context yield,
                                 const std::vector<uint8_t>& pldmReq,
@@ -121,7 +127,6 @@ class FWUpdate
     int applyComplete(const boost::asio::yield_context yield,
                       const std::vector<uint8_t>& pldmReq, uint8_t& applyResult,
                       bitfield16_t& compActivationMethodsModification);
-    int sendMetaData(const boost::asio::yield_context yield);
     int processActivateFirmware(
         const boost::asio::yield_context yield,
         bool8_t selfContainedActivationReq,
@@ -153,8 +158,6 @@ class FWUpdate
     void compUpdateProgress(const boost::asio::yield_context yield);
 
     int processSendMetaData(const boost::asio::yield_context yield);
-    int sendMetaData(const boost::asio::yield_context yield, size_t& offset,
-                     size_t& length, std::set<uint32_t>& recvdRequests);
     uint16_t passCompCount = 0;
     pldm_tid_t currentTid;
     uint8_t expectedCmd;
@@ -165,6 +168,8 @@ class FWUpdate
     std::unique_ptr<boost::asio::steady_timer> reserveBWTimer = nullptr;
     bool isComponentAvailableForUpdate = false;
     uint8_t currentDeviceIDRecord;
+    // Checkpoint key of the FD, FDs without a UUID are not checkpointed
+    std::optional<UUID> currentUUID;
     bool updateMode = false;
     uint8_t fdState = FD_IDLE;
     pldm_firmware_update_state state;
@@ -174,6 +179,8 @@ class FWUpdate
     uint16_t compCount = 0;
     uint8_t fdWillSendGetPkgDataCmd = 0;
     uint64_t applicableComponentsVal = 0;
+    // Components already applied in an interrupted earlier session
+    uint64_t completedComponentsVal = 0;
     uint8_t currentState = 0;
     uint8_t previousState = 0;
     uint8_t auxState = 0;
@@ -18,7 +18,9 @@
 
 #include "pldm.hpp"
 
+#include <array>
 #include <phosphor-logging/log.hpp>
+#include <span>
 
 #include "fru.h"
 #include "pldm_types.h"
@@ -54,6 +56,78 @@ static inline const std::map<uint8_t, const char*> fruRecordTypes{
  */
 std::optional<FRUProperties> getProperties(const pldm_tid_t tid);
 
+enum class FRUFieldFormat : uint8_t
+{
+    unsupported,
+    string,
+    timestamp104,
+    uint32
+};
+
+struct FRUFieldInfo
+{
+    const char* name;
+    FRUFieldFormat format;
+};
+
+/** @brief General FRU record fields exposed on D-Bus, indexed by field type
+ */
+constexpr std::array<FRUFieldInfo, PLDM_FRU_FIELD_TYPE_IANA + 1> fruFieldInfo =
+    [] {
+        std::array<FRUFieldInfo, PLDM_FRU_FIELD_TYPE_IANA + 1> info = {};
+        info[PLDM_FRU_FIELD_TYPE_CHASSIS] = {"ChassisType",
+                                             FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_MODEL] = {"Model", FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_PN] = {"PN", FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_SN] = {"SN", FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_MANUFAC] = {"Manufacturer",
+                                             FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_MANUFAC_DATE] = {
+            "ManufacturerDate", FRUFieldFormat::timestamp104};
+        info[PLDM_FRU_FIELD_TYPE_VENDOR] = {"Vendor", FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_NAME] = {"Name", FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_SKU] = {"SKU", FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_VERSION] = {"Version",
+                                             FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_ASSET_TAG] = {"AssetTag",
+                                               FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_DESC] = {"Description",
+                                          FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_EC_LVL] = {"ECLevel", FRUFieldFormat::string};
+        info[PLDM_FRU_FIELD_TYPE_IANA] = {"IANA", FRUFieldFormat::uint32};
+        return info;
+    }();
+
+/** @brief Location of a field value in the FRU record table. Values always
+ * follow a record header, so offset 0 marks a field the table does not have.
+ */
+struct FRUFieldRef
+{
+    uint32_t offset;
+    uint8_t length;
+};
+
+/** @brief General FRU fields of a terminus, indexed by field type. The values
+ * stay in the FRU record table the record was parsed from.
+ */
+struct FRURecord
+{
+    std::array<FRUFieldRef, fruFieldInfo.size()> fields = {};
+};
+
+/** @brief API that formats a FRU field value as exposed on D-Bus
+ *
+ * @return formatted value; std::nullopt if the record does not have the field
+ */
+std::optional<std::string> getFieldValue(std::span<const uint8_t> table,
+                                         const FRURecord& record,
+                                         const uint8_t fieldType);
+
+/** @brief API that builds the D-Bus properties of a parsed FRU record table
+ */
+FRUProperties getDBusProperties(std::span<const uint8_t> table,
+                                const FRURecord& record);
+
 class GetPLDMFRU
 {
   public:
@@ -89,7 +163,15 @@ class GetPLDMFRU
      * @return PLDM_SUCCESS on success and corresponding error completion code
      * on failure
      */
-    int getFRURecordTableCmd(FRUProperties& fruProperties);
+    int getFRURecordTableCmd(std::vector<uint8_t>& fruRecordTableData);
+
+    /** @brief parse a verified FRU record table and publish it on D-Bus
+     *
+     * @return PLDM_SUCCESS on success and corresponding error completion code
+     * on failure
+     */
+    int loadFRURecordTable(std::vector<uint8_t> fruRecordTableData,
+                           FRURecord& fruRecord);
 
     /** @brief verify Integrity checksum on the FRU Table Data with metadata
      * checksum value
@@ -123,198 +205,38 @@ class SetPLDMFRU
                         const std::vector<uint8_t>& setFruData);
     int sendFruData(boost::asio::yield_context yield,
                     const std::vector<uint8_t>& setFruData);
+
+    /** @brief transfer setFruData in portions of up to transferSize bytes
+     *
+     * @return PLDM_SUCCESS on success, PLDM_ERROR_INVALID_LENGTH if the
+     * terminus rejected the portion size and PLDM_ERROR on other failures
+     */
+    int sendFruPortions(boost::asio::yield_context yield,
+                        const std::vector<uint8_t>& setFruData,
+                        const size_t transferSize,
+                        std::vector<uint8_t>& requestMsg,
+                        std::vector<uint8_t>& responseMsg);
 };
 
 class PLDMFRUTable
 {
   public:
     PLDMFRUTable() = delete;
-    PLDMFRUTable(const std::vector<uint8_t> tableVal, const pldm_tid_t tidVal);
+    PLDMFRUTable(std::span<const uint8_t> tableVal, const pldm_tid_t tidVal);
     ~PLDMFRUTable();
 
-    std::optional<FRUProperties> parseTable();
+    /** @brief locate the General record fields of the table
+     *
+     * @return FRURecord referencing the table on success; std::nullopt if the
+     * table is malformed
+     */
+    std::optional<FRURecord> parseTable();
 
   private:
-    using FRUFieldParser =
-        std::function<std::string(const uint8_t* value, uint8_t length)>;
-
-    using FieldType = uint8_t;
-    using RecordType = uint8_t;
-    using FieldName = std::string;
-    using FRUFieldTypes =
-        std::map<FieldType, std::pair<FieldName, FRUFieldParser>>;
-
     bool isTableEnd(const uint8_t* pTable);
 
-    std::string typeToString(std::map<uint8_t, const char*> typeMap,
-                             uint8_t type)
-    {
-        auto typeString = std::to_string(type);
-        auto typeFound = typeMap.find(type);
-        if (typeFound != typeMap.end())
-        {
-            return typeString + "(" + typeFound->second + ")";
-        }
-        return typeString;
-    }
-
-    static std::string fruFieldParserString(const uint8_t* value,
-                                            uint8_t length)
-    {
-        assert(value != NULL);
-        if (length < 1)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Invalid FRU field length");
-            return std::string("");
-        }
-        std::string strVal(reinterpret_cast<const char*>(value), length);
-        // non printable characters cause sdbusplus exceptions, so better to
-        // handle it by replacing with space
-        std::replace_if(
-            strVal.begin(), strVal.end(),
-            [](const char& c) { return !isprint(c); }, ' ');
-        return strVal;
-    }
-
-    static std::string
-        convertTStamp104ToCIMFormat(const timestamp104_t& fruStamp)
-    {
-        std::stringstream timeStampStr;
-
-        enum CIMTimeStampVarLength
-        {
-            width2 = 2,
-            width3 = 3,
-            width4 = 4,
-            width6 = 6,
-        };
-
-        if (!((fruStamp.year >= 1980 && fruStamp.year <= 9999) &&
-              (fruStamp.month >= 1 && fruStamp.month <= 12) &&
-              (fruStamp.day >= 1 && fruStamp.day <= 31) &&
-              (fruStamp.hour < 24) && (fruStamp.minute < 60) &&
-              (fruStamp.second < 60) &&
-              ((fruStamp.microsecond >= 0) &&
-               (fruStamp.microsecond <= 999999)) &&
-              (fruStamp.utc_offset >= -999 && fruStamp.utc_offset <= 999)))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "TimeStamp is not valid");
-            return timeStampStr.str();
-        }
-        // handle CIM conversions and UTC offset
-        timeStampStr << std::setfill('0') << std::setw(width4) << fruStamp.year
-                     << std::setfill('0') << std::setw(width2)
-                     << static_cast<int>(fruStamp.month) << std::setfill('0')
-                     << std::setw(width2) << static_cast<int>(fruStamp.day)
-                     << std::setfill('0') << std::setw(width2)
-                     << static_cast<int>(fruStamp.hour) << std::setfill('0')
-                     << std::setw(width2) << static_cast<int>(fruStamp.minute)
-                     << std::setfill('0') << std::setw(width2)
-                     << static_cast<int>(fruStamp.second) << "."
-                     << std::setfill('0') << std::setw(width6)
-                     << fruStamp.microsecond;
-        if (fruStamp.utc_offset >= 0)
-        {
-            timeStampStr << "+";
-        }
-        else
-        {
-            timeStampStr << "-";
-        }
-        timeStampStr << std::setfill('0') << std::setw(width3)
-                     << std::to_string(fruStamp.utc_offset);
-
-        return timeStampStr.str();
-    }
-
-    static std::string fruFieldParserTimestamp(const uint8_t* value,
-                                               uint8_t length)
-    {
-        assert(value != NULL);
-        timestamp104_t fruStamp;
-
-        if (length != timeStamp104Size)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Invalid time stamp length");
-            return std::string("");
-        }
-
-        try
-        {
-            std::copy_n(value, timeStamp104Size,
-                        reinterpret_cast<uint8_t*>(&fruStamp));
-        }
-        catch (std::exception& e)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                ("Exception Received FRU timestamp parsing error" +
-                 std::string(e.what()))
-                    .c_str());
-            return std::string("");
-        }
-        catch (...)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Exception Occured FRU timestamp parsing error");
-            return std::string("");
-        }
-
-        return (convertTStamp104ToCIMFormat(fruStamp));
-    }
-
-    static std::string fruFieldParserU32(const uint8_t* value, uint8_t length)
-    {
-        assert(value != NULL);
-        if (length == 4)
-        {
-            uint32_t v;
-            std::memcpy(&v, value, length);
-            return std::to_string(le32toh(*reinterpret_cast<uint32_t*>(v)));
-        }
-        else
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Vendor IANA should be of length 4");
-            return std::string("");
-        }
-    }
-
-    static inline const FRUFieldTypes fruGeneralFieldTypes = {
-        {PLDM_FRU_FIELD_TYPE_CHASSIS, {"ChassisType", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_MODEL, {"Model", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_PN, {"PN", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_SN, {"SN", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_MANUFAC, {"Manufacturer", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_MANUFAC_DATE,
-         {"ManufacturerDate", fruFieldParserTimestamp}},
-        {PLDM_FRU_FIELD_TYPE_VENDOR, {"Vendor", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_NAME, {"Name", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_SKU, {"SKU", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_VERSION, {"Version", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_ASSET_TAG, {"AssetTag", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_DESC, {"Description", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_EC_LVL, {"ECLevel", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_IANA, {"IANA", fruFieldParserU32}},
-    };
-
-    static inline const FRUFieldTypes fruOEMFieldTypes = {
-        {1, {"Vendor IANA", fruFieldParserU32}},
-
-    };
-
-    static inline const std::map<RecordType, FRUFieldTypes> fruFieldTypes{
-        {PLDM_FRU_RECORD_TYPE_GENERAL, fruGeneralFieldTypes},
-        {PLDM_FRU_RECORD_TYPE_OEM, fruOEMFieldTypes}};
-
-    bool parseFRUField(uint8_t recordType, uint8_t type, uint8_t length,
-                       const uint8_t* value);
-
-    const std::vector<uint8_t> table;
+    std::span<const uint8_t> table;
     pldm_tid_t tid;
-    FRUProperties fruProperties;
 };
 
 } // namespace fru
@@ -0,0 +1,63 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "platform.hpp"
+
+#include <optional>
+
+namespace pldm
+{
+namespace fru
+{
+constexpr uint32_t fruCacheMagic = 0x43555246; // "FRUC"
+constexpr uint8_t fruCacheVersion = 1;
+constexpr size_t maxFRUCacheEntries = 64;
+constexpr size_t maxFRUCacheTableSize = 64 * 1024;
+
+struct FRUCacheHeader
+{
+    uint32_t magic;
+    uint8_t version;
+    uint16_t entryCount;
+} __attribute__((packed));
+
+/** @brief GetFRURecordTableMetadata fields that validate a cached table */
+struct FRUTableValidator
+{
+    uint32_t tableLength;
+    uint16_t totalRecordSets;
+    uint16_t totalRecords;
+    uint32_t checksum;
+} __attribute__((packed));
+
+/** @brief API that gets the persisted FRU record table of a terminus
+ *
+ * FRU record tables are cached by terminus UUID. A cached table is only
+ * returned while the table length, record counts and CRC32 reported by
+ * GetFRURecordTableMetadata match the ones seen when the table was stored.
+ */
+std::optional<std::vector<uint8_t>>
+    getCachedFRUTable(const pldm::platform::UUID& uuid,
+                      const FRUTableValidator& validator);
+
+/** @brief API that persists the FRU record table of a terminus
+ */
+void cacheFRUTable(const pldm::platform::UUID& uuid,
+                   const FRUTableValidator& validator,
+                   const std::vector<uint8_t>& fruTable);
+} // namespace fru
+} // namespace pldm
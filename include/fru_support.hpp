@@ -17,6 +17,7 @@
 #pragma once
 
 #include <map>
+#include <optional>
 #include <sdbusplus/asio/object_server.hpp>
 
 #include "fru.h"
@@ -52,7 +53,8 @@ class IpmiFru
                        std::shared_ptr<sdbusplus::asio::dbus_interface>>
         ipmiFruInterface;
     std::shared_ptr<sdbusplus::asio::dbus_interface> fruIface;
-    std::map<pldm_tid_t, FRUProperties> ipmiFRUProperties;
+    // IPMI FRU images already returned by GetRawFru
+    std::unordered_map<pldm_tid_t, std::vector<uint8_t>> ipmiFRUImages;
 
     /** @brief returns the FRUData in IPMI format
      *
@@ -0,0 +1,129 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "fwu_utils.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+namespace fwu
+{
+constexpr uint32_t fwuCheckpointMagic = 0x50434B46; // "FKCP"
+constexpr uint8_t fwuCheckpointVersion = 2;
+/** @brief Components that fit in the completed components bitmap */
+constexpr uint16_t maxCheckpointComponents = 64;
+
+/** @brief Terminus UUID, which unlike TID survives a pldmd restart */
+using UUID = std::array<uint8_t, 16>;
+
+struct FWUCheckpointHeader
+{
+    uint32_t magic;
+    uint8_t version;
+    uint32_t pkgChecksum;
+    uint64_t pkgSize;
+    uint8_t deviceCount;
+} __attribute__((packed));
+
+struct FWUCheckpointDevice
+{
+    UUID uuid;
+    uint8_t deviceIDRecord;
+    uint8_t activated;
+    uint64_t completedComponents;
+    int32_t updateStatus;
+    uint16_t estimatedTimeForSelfContainedActivation;
+} __attribute__((packed));
+
+/** @brief Firmware update progress persisted at component boundaries
+ *
+ * A checkpoint is bound to one PLDM package, identified by the CRC32 of the
+ * whole package and its size. For every matched FD, keyed by terminus UUID,
+ * it records the components which reached ApplyComplete and, once
+ * ActivateFirmware succeeded, the self-contained activation time. If pldmd
+ * restarts or the update aborts and the FD kept its update session, a later
+ * StartFWUpdate with the same package continues that session from the first
+ * unfinished component instead of transferring the whole package again.
+ */
+class UpdateCheckpoint
+{
+  public:
+    UpdateCheckpoint() = delete;
+    UpdateCheckpoint(const uint32_t pkgChecksum, const uint64_t pkgSize);
+
+    /** @brief API that loads the persisted checkpoint. Checkpoint of a
+     * different package is discarded.
+     */
+    void load();
+
+    /** @brief API that checks whether an earlier update session was started
+     * for the FD
+     */
+    bool hasSession(const UUID& uuid, const uint8_t deviceIDRecord) const;
+
+    /** @brief API that gets the bitmap of components already applied on FD
+     */
+    uint64_t getCompletedComponents(const UUID& uuid,
+                                    const uint8_t deviceIDRecord) const;
+
+    /** @brief API that gets the activation result of an already activated FD
+     */
+    const FWUCheckpointDevice* getActivatedDevice(
+        const UUID& uuid, const uint8_t deviceIDRecord) const;
+
+    /** @brief API that records the start of an update session for the FD
+     */
+    void beginSession(const UUID& uuid, const uint8_t deviceIDRecord);
+
+    /** @brief API that records a component which reached ApplyComplete
+     */
+    void markComponentComplete(const UUID& uuid,
+                               const uint8_t deviceIDRecord,
+                               const uint16_t component);
+
+    /** @brief API that drops components reported as non-functioning by FD
+     */
+    void clearComponents(const UUID& uuid, const uint8_t deviceIDRecord,
+                         const uint64_t components);
+
+    /** @brief API that records the ActivateFirmware result of the FD
+     */
+    void markActivated(const UUID& uuid, const uint8_t deviceIDRecord,
+                       const int updateStatus, const uint16_t activationTime);
+
+    /** @brief API that removes the persisted checkpoint
+     */
+    void remove();
+
+  private:
+    FWUCheckpointDevice* findDevice(const UUID& uuid,
+                                    const uint8_t deviceIDRecord);
+    const FWUCheckpointDevice* findDevice(const UUID& uuid,
+                                          const uint8_t deviceIDRecord) const;
+    FWUCheckpointDevice& getOrAddDevice(const UUID& uuid,
+                                        const uint8_t deviceIDRecord);
+    bool save();
+
+    uint32_t pkgChecksum;
+    uint64_t pkgSize;
+    std::vector<FWUCheckpointDevice> devices;
+};
+} // namespace fwu
+} // namespace pldm
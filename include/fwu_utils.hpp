@@ -17,6 +17,7 @@
 
 #include "pldm.hpp"
 
+#include <deque>
 #include <vector>
 
 #include "utils.h"
@@ -61,6 +62,54 @@ struct DescriptorHeader
 
 constexpr size_t PLDMCCOnlyResponse = sizeof(struct PLDMEmptyRequest) + 1;
 constexpr size_t hdrSize = sizeof(pldm_msg_hdr);
+// Number of encoded responses kept for duplicate or retried FD requests
+constexpr size_t fwuDataTransferWindowSize = 4;
+
+/** @brief Tracks a data transfer driven by FD requests
+ *
+ * Used for GetPackageData, GetMetaData and RequestFirmwareData. Chunks served
+ * are recorded in a bitmap, and the encoded responses of the most recent
+ * requests are kept so that a duplicate or retried request is answered
+ * without reading and encoding the data again.
+ */
+class FWUDataTransfer
+{
+  public:
+    FWUDataTransfer() = delete;
+    FWUDataTransfer(const size_t dataSize, const size_t chunkSize);
+
+    /** @brief API that gets the encoded response of an earlier request for
+     * the same data portion
+     */
+    std::vector<uint8_t>* getResponse(const size_t offset,
+                                      const size_t length);
+
+    /** @brief API that records the encoded response of a request and marks
+     * the chunks it covers as served
+     */
+    std::vector<uint8_t>& addResponse(const size_t offset, const size_t length,
+                                      std::vector<uint8_t>&& response);
+
+    /** @brief API that checks whether every chunk of the data was served
+     */
+    bool isComplete() const
+    {
+        return servedCount == served.size();
+    }
+
+  private:
+    struct EncodedResponse
+    {
+        size_t offset;
+        size_t length;
+        std::vector<uint8_t> response;
+    };
+
+    size_t chunkSize;
+    std::vector<bool> served;
+    size_t servedCount = 0;
+    std::deque<EncodedResponse> window;
+};
 
 void unpackDescriptors(const uint8_t count, const std::vector<uint8_t>& data,
                        uint16_t& initialDescriptorType,
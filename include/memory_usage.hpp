@@ -0,0 +1,55 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <sdbusplus/asio/object_server.hpp>
+#include <string>
+
+namespace pldm
+{
+namespace platform
+{
+/** @brief Memory held by the sensors and effecters of a terminus. Bytes are
+ * an estimate: object sizes plus owned buffers, D-Bus interfaces are counted
+ * by object size only.
+ */
+struct MemoryUsage
+{
+    size_t sensors = 0;
+    size_t effecters = 0;
+    size_t dbusInterfaces = 0;
+    size_t bytes = 0;
+
+    /** @brief Account a string's heap buffer, if not stored inline*/
+    void addString(const std::string& str)
+    {
+        if (str.capacity() > std::string().capacity())
+        {
+            bytes += str.capacity() + 1;
+        }
+    }
+
+    /** @brief Account the D-Bus interfaces that are created*/
+    template <typename... Interfaces>
+    void addInterfaces(const Interfaces&... interfaces)
+    {
+        const size_t count = ((interfaces != nullptr ? 1U : 0U) + ...);
+        dbusInterfaces += count;
+        bytes += count * sizeof(sdbusplus::asio::dbus_interface);
+    }
+};
+} // namespace platform
+} // namespace pldm
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "effecter_write_queue.hpp"
+#include "memory_usage.hpp"
 #include "numeric_effecter.hpp"
 #include "pdr_manager.hpp"
 
@@ -46,6 +48,9 @@ class NumericEffecterHandler
     /** @brief Init NumericEffecterHandler*/
     bool effecterHandlerInit(boost::asio::yield_context yield);
 
+    /** @brief Add the memory held by the effecter to usage*/
+    void addMemoryUsage(MemoryUsage& usage) const;
+
   private:
     /** @brief  Enable effecter*/
     bool enableNumericEffecter(boost::asio::yield_context yield);
@@ -54,16 +59,16 @@ class NumericEffecterHandler
     bool initEffecter();
 
     /** @brief fetch the effecter value*/
-    bool getEffecterReading(boost::asio::yield_context yield);
+    boost::asio::awaitable<bool> getEffecterReading();
 
     /** @brief Decode effecter value and update D-Bus interfaces*/
-    bool handleEffecterReading(boost::asio::yield_context yield,
-                               uint8_t effecterOperationalState,
-                               uint8_t effecterDataSize,
-                               union_effecter_data_size& presentReading);
+    boost::asio::awaitable<bool>
+        handleEffecterReading(uint8_t effecterOperationalState,
+                              uint8_t effecterDataSize,
+                              union_effecter_data_size& presentReading);
 
     /** @brief Read effecter value and update interfaces*/
-    bool populateEffecterValue(boost::asio::yield_context yield);
+    boost::asio::awaitable<bool> populateEffecterValue();
 
     /** @brief Set effecter value*/
     bool setEffecter(boost::asio::yield_context yield, double& value);
@@ -89,6 +94,9 @@ class NumericEffecterHandler
     /** @brief Set Effecter interface*/
     std::shared_ptr<sdbusplus::asio::dbus_interface> setEffecterInterface;
 
+    /** @brief Coalesces SetEffecter calls*/
+    EffecterWriteQueue<double> writeQueue;
+
     /** @brief Timer to wait for trasition interval after
      * SetNumericEffecterValue*/
     std::unique_ptr<boost::asio::steady_timer> transitionIntervalTimer;
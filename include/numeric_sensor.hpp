@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "memory_usage.hpp"
 #include "pldm.hpp"
 #include "thresholds.hpp"
 
@@ -32,6 +33,10 @@ struct ThresholdInterface
     std::string alarm;
 };
 
+/** @brief Numeric sensor state, owned by its handler. The reading fields are
+ * kept inline rather than in a per-terminus struct-of-arrays store, see the
+ * Memory Usage section of the README.
+ */
 struct NumericSensor
 {
     NumericSensor(const std::string& sensorName,
@@ -43,8 +48,6 @@ struct NumericSensor
     ~NumericSensor();
 
     std::string name;
-    double maxValue;
-    double minValue;
     std::vector<thresholds::Threshold> thresholds;
     std::shared_ptr<sdbusplus::asio::dbus_interface> associationInterface =
         nullptr;
@@ -57,8 +60,9 @@ struct NumericSensor
         nullptr;
     std::shared_ptr<sdbusplus::asio::dbus_interface> operationalInterface =
         nullptr;
+    double maxValue;
+    double minValue;
     double value = std::numeric_limits<double>::quiet_NaN();
-    double rawValue = std::numeric_limits<double>::quiet_NaN();
 
     /** @brief hysteresis value to trigger the alarm*/
     double hysteresisTrigger;
@@ -68,8 +72,9 @@ struct NumericSensor
      * change in value*/
     double hysteresisPublish = 0;
 
-    size_t errCount = 0;
     SensorUnit unit;
+    /** @brief Consecutive read failures, saturates at the error threshold*/
+    uint8_t errCount = 0;
 
     /** @brief Increment the error count in case of failure*/
     void incrementError();
@@ -81,6 +86,9 @@ struct NumericSensor
     void updateValue(const double& newValue, const bool isAvaliable,
                      const bool isFunctional);
 
+    /** @brief Add the memory held by the sensor to usage*/
+    void addMemoryUsage(pldm::platform::MemoryUsage& usage) const;
+
     /** @brief Select the threshold interface as per the threshold passed*/
     std::optional<ThresholdInterface>
         selectThresholdInterface(const thresholds::Threshold& threshold);
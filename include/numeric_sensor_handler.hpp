@@ -46,7 +46,7 @@ class NumericSensorHandler
     bool sensorHandlerInit(boost::asio::yield_context yield);
 
     /** @brief Read sensor value and update interfaces*/
-    bool populateSensorValue(boost::asio::yield_context yield);
+    boost::asio::awaitable<bool> populateSensorValue();
 
     /**@brief Check sensor is disabled or not*/
     bool isSensorDisabled()
@@ -57,6 +57,9 @@ class NumericSensorHandler
     /** @brief Check if sensor error threshold crossed*/
     bool sensorErrorCheck();
 
+    /** @brief Add the memory held by the sensor to usage*/
+    void addMemoryUsage(MemoryUsage& usage) const;
+
   private:
     /** @brief  Enable sensor*/
     bool setNumericSensorEnable(boost::asio::yield_context yield);
@@ -66,10 +69,10 @@ class NumericSensorHandler
         std::vector<thresholds::Threshold>& thresholdData);
 
     /** @brief Init sensor*/
-    bool initSensor();
+    bool initSensor(boost::asio::yield_context yield);
 
     /** @brief fetch the sensor value*/
-    bool getSensorReading(boost::asio::yield_context yield);
+    boost::asio::awaitable<bool> getSensorReading();
 
     /** @brief Decode sensor value and D-Bus interfaces*/
     bool handleSensorReading(uint8_t sensorOperationalState,
@@ -89,7 +92,7 @@ class NumericSensorHandler
     std::shared_ptr<pldm_numeric_sensor_value_pdr> _pdr;
 
     /** @brief Sensor*/
-    std::shared_ptr<NumericSensor> _sensor;
+    std::unique_ptr<NumericSensor> _sensor;
 
     /** @brief Sensor disabled flag*/
     bool sensorDisabled = false;
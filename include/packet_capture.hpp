@@ -0,0 +1,82 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <string>
+
+namespace pldm
+{
+namespace capture
+{
+// Bytes of every MCTP payload kept in the capture ring
+constexpr size_t captureSnapLength = 256;
+constexpr size_t defaultCaptureEntries = 1024;
+constexpr size_t maxCaptureEntries = 65536;
+// pcap link type of DSP0236 packets starting with the MCTP transport header
+constexpr uint32_t linkTypeMCTP = 291;
+
+enum class Direction : uint8_t
+{
+    received,
+    sent
+};
+
+/** @brief flag set while the capture ring records packets*/
+extern bool captureEnabled;
+
+/** @brief API that stores an MCTP payload in the capture ring */
+void recordPacket(const Direction direction, const mctpw_eid_t eid,
+                  const bool tagOwner, const uint8_t msgTag,
+                  const std::vector<uint8_t>& payload);
+
+/** @brief Store an MCTP payload if capture is enabled. Costs a single branch
+ * otherwise.
+ */
+inline void capturePacket(const Direction direction, const mctpw_eid_t eid,
+                          const bool tagOwner, const uint8_t msgTag,
+                          const std::vector<uint8_t>& payload)
+{
+    if (captureEnabled)
+    {
+        recordPacket(direction, eid, tagOwner, msgTag, payload);
+    }
+}
+
+/** @brief API that (re)starts capture into an empty ring of entryCount
+ * packets
+ */
+bool startCapture(const size_t entryCount);
+
+/** @brief API that stops capture and frees the capture ring */
+void stopCapture();
+
+/** @brief API that writes the captured packets, oldest first, as a pcap file
+ * named fileName under /run/pldmd. The file must not exist yet.
+ *
+ * The BMC is shown as the null EID. Messages sent through
+ * sendReceivePldmMessage are shown with tag 0 as the tag is allocated by the
+ * transport.
+ */
+bool dumpCapture(const std::string& fileName);
+
+/** @brief Start capture if PLDM_CAPTURE is set to the ring size and expose
+ * xyz.openbmc_project.PLDM.Capture
+ */
+void initializeCaptureIntf();
+} // namespace capture
+} // namespace pldm
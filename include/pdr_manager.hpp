@@ -18,6 +18,10 @@
 #include "pldm.hpp"
 
 #include <boost/asio.hpp>
+#include <boost/container/flat_map.hpp>
+
+#include <bitset>
+#include <memory_resource>
 
 #include "platform.h"
 
@@ -36,15 +40,20 @@ using SensorID = uint16_t;
 using EffecterID = uint16_t;
 using FRURecordSetIdentifier = uint16_t;
 
+/** @brief Pack the three 16 bit fields identifying an entity into one key */
+constexpr uint64_t getEntityKey(const pldm_entity& entity)
+{
+    return static_cast<uint64_t>(entity.entity_type) << 32 |
+           static_cast<uint64_t>(entity.entity_instance_num) << 16 |
+           entity.entity_container_id;
+}
+
 struct EntityComparator
 {
     bool operator()(const pldm_entity& lhsEntity,
                     const pldm_entity& rhsEntity) const
     {
-        return std::tie(lhsEntity.entity_type, lhsEntity.entity_instance_num,
-                        lhsEntity.entity_container_id) ==
-               std::tie(rhsEntity.entity_type, rhsEntity.entity_instance_num,
-                        rhsEntity.entity_container_id);
+        return getEntityKey(lhsEntity) == getEntityKey(rhsEntity);
     }
 };
 
@@ -52,40 +61,104 @@ struct EntityHash
 {
     std::size_t operator()(const pldm_entity& key) const
     {
-        std::hash<uint16_t> hash_function;
-        std::size_t returnValue = hash_function(key.entity_type) +
-                                  hash_function(key.entity_instance_num) +
-                                  hash_function(key.entity_container_id);
-
-        return returnValue;
+        // splitmix64 finalizer, entities differing in any field do not
+        // collide systematically
+        uint64_t hash = getEntityKey(key);
+        hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+        return std::hash<uint64_t>{}(hash ^ (hash >> 31));
     }
 };
 
+/** @brief Map keyed by sensor or effecter ID, kept as a sorted vector */
+template <typename ID, typename Value>
+using IDMap = boost::container::flat_map<ID, Value>;
+
+/** @brief Allocate a shared object, control block included, from arena.
+ * Deallocation is a no-op for a monotonic arena, the memory is released with
+ * the arena.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> allocateShared(std::pmr::memory_resource* arena,
+                                  Args&&... args)
+{
+    return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(arena),
+                                   std::forward<Args>(args)...);
+}
+
 struct EntityNode
 {
     using NodePtr = std::shared_ptr<EntityNode>;
-    using ContainedEntities = std::vector<NodePtr>;
+    using ContainedEntities = std::pmr::vector<NodePtr>;
 
-    pldm_entity containerEntity;
+    explicit EntityNode(std::pmr::memory_resource* arena) :
+        containedEntities(arena)
+    {
+    }
+
+    pldm_entity containerEntity{};
     ContainedEntities containedEntities;
 };
 
+// Max possibleStateSize as per spec DSP0248 Table 81
+constexpr size_t maxPossibleStatesSize = 0x20;
+// Max compositeSensorCount as per spec DSP0248 Table 81
+constexpr uint8_t maxCompositeSensorCount = 0x08;
+
+/** @brief One bit per state value of a state set*/
+using PossibleStateSet = std::bitset<maxPossibleStatesSize * 8>;
+
 struct PossibleStates
 {
     uint16_t stateSetID;
-    std::set<uint8_t> possibleStateSetValues;
+    PossibleStateSet possibleStateSetValues;
 };
 
+/** @brief Get the state values set in stateSet in ascending order*/
+inline std::vector<uint8_t>
+    getPossibleStateValues(const PossibleStateSet& stateSet)
+{
+    std::vector<uint8_t> values;
+    values.reserve(stateSet.count());
+    for (size_t state = 0; state < stateSet.size(); state++)
+    {
+        if (stateSet[state])
+        {
+            values.emplace_back(static_cast<uint8_t>(state));
+        }
+    }
+    return values;
+}
+
+/** @brief Heap bytes held by the possible states of a state sensor or
+ * effecter PDR
+ */
+inline size_t
+    getMemoryUsage(const std::pmr::vector<PossibleStates>& possibleStates)
+{
+    return possibleStates.capacity() * sizeof(PossibleStates);
+}
+
 struct StateSensorPDR
 {
-    pldm_state_sensor_pdr stateSensorData;
-    std::vector<PossibleStates> possibleStates;
+    explicit StateSensorPDR(std::pmr::memory_resource* arena) :
+        possibleStates(arena)
+    {
+    }
+
+    pldm_state_sensor_pdr stateSensorData{};
+    std::pmr::vector<PossibleStates> possibleStates;
 };
 
 struct StateEffecterPDR
 {
-    pldm_state_effecter_pdr stateEffecterData;
-    std::vector<PossibleStates> possibleStates;
+    explicit StateEffecterPDR(std::pmr::memory_resource* arena) :
+        possibleStates(arena)
+    {
+    }
+
+    pldm_state_effecter_pdr stateEffecterData{};
+    std::pmr::vector<PossibleStates> possibleStates;
 };
 
 class PDRManager
@@ -103,7 +176,7 @@ class PDRManager
     bool pdrManagerInit(boost::asio::yield_context yield);
 
     /** @brief Get Sensors list*/
-    const std::unordered_map<SensorID, std::string>& getSensors()
+    const IDMap<SensorID, std::string>& getSensors()
     {
         return _sensorAuxNames;
     };
@@ -117,7 +190,7 @@ class PDRManager
         getStateSensorPDR(const SensorID& sensorID);
 
     /** @brief Get Effecter list*/
-    std::unordered_map<EffecterID, std::string> getEffecters()
+    const IDMap<EffecterID, std::string>& getEffecters()
     {
         return _effecterAuxNames;
     };
@@ -153,15 +226,12 @@ class PDRManager
     /** @brief fetch PDRs from terminus and add to BMC PDR repo*/
     bool constructPDRRepo(boost::asio::yield_context yield);
 
-    /** @brief Parse the Auxiliary Names PDR */
-    void parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData);
-
     /**@brief Create Entity Association Tree from PDRs*/
     void createEntityAssociationTree(
         std::vector<EntityNode::NodePtr>& entityAssociations);
 
-    /**@brief Parse Entity Association PDRs*/
-    void parseEntityAssociationPDR(std::vector<uint8_t>& pdrData);
+    /**@brief Add the entities of a decoded Entity Association PDR*/
+    void addEntityAssociation(const std::vector<pldm_entity>& entities);
 
     /** @brief Get all entity association paths from entity association tree
      * through recursion*/
@@ -180,11 +250,12 @@ class PDRManager
     void initializeInventoryIntf();
 #endif
 
-    /** @brief Parse Sensor Auxiliary Names PDR */
-    void parseSensorAuxNamesPDR(std::vector<uint8_t>& pdrData);
+    /** @brief Cache a decoded Sensor Auxiliary Name */
+    void addSensorAuxName(const SensorID sensorID, const std::string& name);
 
-    /** @brief Parse Effecter Auxiliary Names PDR */
-    void parseEffecterAuxNamesPDR(std::vector<uint8_t>& pdrData);
+    /** @brief Cache a decoded Effecter Auxiliary Name */
+    void addEffecterAuxName(const EffecterID effecterID,
+                            const std::string& name);
 
     /** @brief get Entity D-Bus Object path */
     std::optional<DBusObjectPath>
@@ -198,11 +269,12 @@ class PDRManager
                                                       const SensorID& sensorID,
                                                       const bool8_t auxNamePDR);
 
-    /** @brief Parse Numeric Sensor PDR */
-    void parseNumericSensorPDR(std::vector<uint8_t>& pdrData);
+    /** @brief Cache a decoded Numeric Sensor PDR and expose it on D-Bus */
+    void addNumericSensor(const pldm_numeric_sensor_value_pdr& sensorPDR);
 
-    /** @brief Parse State Sensor PDR */
-    void parseStateSensorPDR(std::vector<uint8_t>& pdrData);
+    /** @brief Cache a decoded State Sensor PDR and expose it on D-Bus */
+    void addStateSensor(const pldm_state_sensor_pdr& sensorPDR,
+                        const std::vector<PossibleStates>& possibleStates);
 
     /** @brief get Effecter Auxiliary name*/
     std::optional<std::string>
@@ -214,18 +286,17 @@ class PDRManager
                               const EffecterID& effecterID,
                               const bool8_t auxNamePDR);
 
-    /** @brief Parse Numeric Effecter PDR */
-    void parseNumericEffecterPDR(std::vector<uint8_t>& pdrData);
+    /** @brief Cache a decoded Numeric Effecter PDR and expose it on D-Bus */
+    void addNumericEffecter(
+        const pldm_numeric_effecter_value_pdr& effecterPDR);
 
-    /** @brief Parse State Effecter PDR */
-    void parseStateEffecterPDR(std::vector<uint8_t>& pdrData);
+    /** @brief Cache a decoded State Effecter PDR and expose it on D-Bus */
+    void addStateEffecter(const pldm_state_effecter_pdr& effecterPDR,
+                          const PossibleStates& possibleStates);
 
-    /** @brief Parse FRU Record Set PDR */
-    void parseFRURecordSetPDR(std::vector<uint8_t>& pdrData);
-
-    /**@brief General parser to each PDR type*/
-    template <pldm_pdr_types pdrType>
-    void parsePDR();
+    /** @brief Expose a decoded FRU Record Set PDR on D-Bus */
+    void addFRURecordSet(const pldm_entity& entity,
+                         const FRURecordSetIdentifier fruRSI);
 
     /** @brief Create sensor name with sensor ID*/
     std::string createSensorName(const SensorID sensorID);
@@ -236,6 +307,12 @@ class PDRManager
     /** @brief Initialize interface to dump PDR repo*/
     void initializePDRDumpIntf();
 
+    /** @brief Arena holding the entity association tree and the cached
+     * sensor and effecter PDRs. Declared first so that it is released last,
+     * in one shot, when the terminus is deleted.
+     */
+    std::pmr::monotonic_buffer_resource _arena;
+
     /** @brief PDR Repository Info of this terminus*/
     pldm_pdr_repository_info pdrRepoInfo;
 
@@ -265,36 +342,34 @@ class PDRManager
     /** @brief Holds Sensor Auxiliary Names.
      * Note:- SensorID is considered as unique within a terminus
      */
-    std::unordered_map<SensorID, std::string> _sensorAuxNames;
+    IDMap<SensorID, std::string> _sensorAuxNames;
 
     /** @brief Holds Effecter Auxiliary Names.
      * Note:- EffecterID is considered as unique within a terminus
      */
-    std::unordered_map<EffecterID, std::string> _effecterAuxNames;
+    IDMap<EffecterID, std::string> _effecterAuxNames;
 
     /** @brief Holds Numeric Sensor PDR */
-    std::map<SensorID, std::shared_ptr<pldm_numeric_sensor_value_pdr>>
+    IDMap<SensorID, std::shared_ptr<pldm_numeric_sensor_value_pdr>>
         _numericSensorPDR;
 
     /** @brief Holds Numeric Sensor D-Bus interfaces and Object paths */
-    std::map<SensorID, std::pair<DBusInterfacePtr, DBusObjectPath>> _sensorIntf;
+    IDMap<SensorID, std::pair<DBusInterfacePtr, DBusObjectPath>> _sensorIntf;
 
     /** @brief Holds Effecter D-Bus interfaces and Object paths */
-    std::map<EffecterID, std::pair<DBusInterfacePtr, DBusObjectPath>>
+    IDMap<EffecterID, std::pair<DBusInterfacePtr, DBusObjectPath>>
         _effecterIntf;
 
     /** @brief Holds Numeric Effecter PDR */
-    std::map<EffecterID, std::shared_ptr<pldm_numeric_effecter_value_pdr>>
+    IDMap<EffecterID, std::shared_ptr<pldm_numeric_effecter_value_pdr>>
         _numericEffecterPDR;
 
     /** @brief Holds FRU Record Set D-Bus interfaces and Object paths */
-    std::map<FRURecordSetIdentifier,
-             std::pair<DBusInterfacePtr, DBusObjectPath>>
+    IDMap<FRURecordSetIdentifier, std::pair<DBusInterfacePtr, DBusObjectPath>>
         _fruRecordSetIntf;
 
     /** @brief Holds State Sensor PDR */
-    std::unordered_map<SensorID, std::shared_ptr<StateSensorPDR>>
-        _stateSensorPDR;
+    IDMap<SensorID, std::shared_ptr<StateSensorPDR>> _stateSensorPDR;
 
 #ifdef EXPOSE_CHASSIS
     /** @brief D-Bus interfaces to inventory */
@@ -305,8 +380,7 @@ class PDRManager
     DBusInterfacePtr pdrDumpInterface;
 
     /** @brief Holds State Effecter PDR */
-    std::unordered_map<EffecterID, std::shared_ptr<StateEffecterPDR>>
-        _stateEffecterPDR;
+    IDMap<EffecterID, std::shared_ptr<StateEffecterPDR>> _stateEffecterPDR;
 
     /** @brief Terminus ID*/
     pldm_tid_t _tid;
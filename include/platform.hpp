@@ -34,7 +34,8 @@ using UUID = std::array<uint8_t, 16>;
 
 std::optional<UUID>
     getTerminusUID(boost::asio::yield_context yield, const pldm_tid_t tid,
-                   std::optional<mctpw_eid_t> eid = std::nullopt);
+                   std::optional<mctpw_eid_t> eid = std::nullopt,
+                   const size_t retryCount = commandRetryCount);
 
 class Platform
 {
@@ -46,11 +47,13 @@ class Platform
     bool deleteTerminus(const pldm_tid_t tid);
 
   private:
-    bool induceAsyncDelay(boost::asio::yield_context yield, int delay);
-    void doPoll(boost::asio::yield_context yield);
+    boost::asio::awaitable<bool> induceAsyncDelay(int delay);
+    boost::asio::awaitable<void> doPoll();
     void pollAllSensors();
     void initializeSensorPollIntf();
     void initializePlatformIntf();
+    std::vector<std::tuple<pldm_tid_t, uint32_t, uint32_t, uint32_t, uint64_t>>
+        getMemoryUsage() const;
     bool isTerminusRemoved(const pldm_tid_t tid);
     void removeTIDFromInitializationList(const pldm_tid_t tid);
 
@@ -18,6 +18,7 @@
 
 #include "pldm.hpp"
 
+#include <boost/asio/spawn.hpp>
 #include <string>
 
 namespace pldm
@@ -26,9 +27,17 @@ namespace platform
 {
 namespace association
 {
-/** @brief Get sensor association path of tid*/
+/** @brief Start tracking inventory changes and prefetch association paths*/
+void init();
+
+/** @brief Get cached sensor association path of tid. Never blocks on D-Bus*/
 std::string getPath(pldm_tid_t tid);
 
+/** @brief Get sensor association path of tid, resolving it asynchronously
+ * when not cached yet
+ */
+std::string getPath(boost::asio::yield_context yield, pldm_tid_t tid);
+
 /** @brief Set sensor association path of tid*/
 void setPath(pldm_tid_t tid, const std::string& path);
 
@@ -40,6 +40,9 @@ struct PlatformTerminus
     std::unordered_map<EffecterID, std::unique_ptr<StateEffecterHandler>>
         stateEffecters;
 
+    /** @brief Estimate the memory held by the sensors and effecters*/
+    MemoryUsage getMemoryUsage() const;
+
   private:
     void initSensors(boost::asio::yield_context yield);
     void initEffecters(boost::asio::yield_context yield);
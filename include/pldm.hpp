@@ -22,6 +22,7 @@
 #include <boost/asio/error.hpp>
 #include <boost/asio/spawn.hpp>
 #include <memory>
+#include <optional>
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/asio/object_server.hpp>
 #include <unordered_map>
@@ -32,11 +33,18 @@
 using mctpw_eid_t = mctpw::eid_t;
 
 std::shared_ptr<boost::asio::io_context> getIoContext();
+boost::asio::thread_pool& getWorkerPool();
 std::shared_ptr<sdbusplus::asio::connection> getSdBus();
 std::shared_ptr<sdbusplus::asio::object_server> getObjServer();
 std::unique_ptr<sdbusplus::asio::dbus_interface>
     addUniqueInterface(const std::string& path, const std::string& name);
 
+/** @brief Discover and initialise the PLDM terminus behind the EID */
+void initDevice(const mctpw_eid_t eid, boost::asio::yield_context yield);
+
+/** @brief Release the resources of the PLDM terminus */
+void deleteDevice(const pldm_tid_t tid);
+
 /** @brief flag to enable debugging*/
 extern bool debug;
 
@@ -97,6 +105,13 @@ extern TIDMapper tidMapper;
  */
 uint8_t createInstanceId(pldm_tid_t tid);
 
+/** @brief Handle a message received from a PLDM terminus
+ *
+ * Messages from EIDs which are not mapped to a TID are discarded.
+ */
+void msgRecvCallback(void*, mctpw_eid_t srcEid, bool tagOwner, uint8_t msgTag,
+                     const std::vector<uint8_t>& data, int);
+
 /** @brief Trigger device discovery scan
  *
  * PLDM terminus can go for reset after certain operations like PLDM firmware
@@ -182,6 +197,20 @@ bool sendReceivePldmMessage(boost::asio::yield_context yield,
                             std::vector<uint8_t>& pldmResp,
                             std::optional<mctpw_eid_t> eid = std::nullopt);
 
+/** @brief Send and Receive PLDM message
+ *
+ * Awaitable variant of sendReceivePldmMessage for C++20 coroutines. The
+ * coroutine frame replaces the stack allocated for every spawned
+ * yield_context, which keeps concurrent operations cheap.
+ *
+ * @return Status of the operation
+ */
+boost::asio::awaitable<bool>
+    sendReceivePldmMessage(const pldm_tid_t tid, const uint16_t timeout,
+                           size_t retryCount, std::vector<uint8_t> pldmReq,
+                           std::vector<uint8_t>& pldmResp,
+                           std::optional<mctpw_eid_t> eid = std::nullopt);
+
 /** @brief Validate PLDM message encode
  *
  * @param tid[in] - TID of the PLDM device
@@ -229,6 +258,105 @@ bool sendPldmMessage(boost::asio::yield_context yield, const pldm_tid_t tid,
                      uint8_t retryCount, const uint8_t msgTag,
                      const bool tagOwner, std::vector<uint8_t> payload);
 
+/** @brief Send PLDM message
+ *
+ * Awaitable variant of sendPldmMessage for C++20 coroutines.
+ *
+ * @return Status of the operation
+ */
+boost::asio::awaitable<bool> sendPldmMessage(const pldm_tid_t tid,
+                                             uint8_t retryCount,
+                                             const uint8_t msgTag,
+                                             const bool tagOwner,
+                                             std::vector<uint8_t> payload);
+
+/** @brief Run a CPU bound function on the worker pool
+ *
+ * Suspends the calling coroutine while the function runs on a worker thread
+ * and resumes it on the io_context with the result, so that parsing large
+ * tables does not delay sensor polling or D-Bus handling. The function must
+ * not touch D-Bus objects or state shared with other io_context handlers.
+ * Exceptions of the function are rethrown in the coroutine.
+ *
+ * @param yield - Context object the represents the currently executing
+ * coroutine
+ * @param func - Function to run
+ *
+ * @return Result of the function
+ */
+template <typename Func>
+std::invoke_result_t<Func> runOnWorker(boost::asio::yield_context yield,
+                                       Func&& func)
+{
+    using Result = std::invoke_result_t<Func>;
+    static_assert(!std::is_void_v<Result>, "Worker function must return");
+    std::optional<Result> result;
+    std::exception_ptr error;
+    // The coroutine stays suspended until the handler is invoked, so the
+    // locals captured by reference outlive the worker
+    boost::asio::async_initiate<boost::asio::yield_context, void()>(
+        [&](auto handler) {
+            auto work = [&, handler = std::move(handler)]() mutable {
+                try
+                {
+                    result.emplace(func());
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                boost::asio::post(*getIoContext(), std::move(handler));
+            };
+            boost::asio::post(getWorkerPool(), std::move(work));
+        },
+        yield);
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return std::move(result.value());
+}
+
+/** @brief Wait from a yield_context coroutine for an awaitable to complete
+ *
+ * Bridges code still running on stackful coroutines to code migrated to
+ * C++20 coroutines. Exceptions of the awaitable are rethrown.
+ *
+ * @param yield - Context object the represents the currently executing
+ * coroutine
+ * @param operation - Awaitable to run
+ *
+ * @return Result of the awaitable
+ */
+template <typename T>
+T awaitFromYield(boost::asio::yield_context yield,
+                 boost::asio::awaitable<T> operation)
+{
+    std::optional<T> result;
+    std::exception_ptr error;
+    bool done = false;
+    boost::asio::steady_timer doneTimer(
+        *getIoContext(), boost::asio::steady_timer::time_point::max());
+    boost::asio::co_spawn(*getIoContext(), std::move(operation),
+                          [&](std::exception_ptr e, T value) {
+                              error = e;
+                              result = std::move(value);
+                              done = true;
+                              doneTimer.cancel();
+                          });
+    // Operations finishing without suspending complete before the wait starts
+    if (!done)
+    {
+        boost::system::error_code ec;
+        doneTimer.async_wait(yield[ec]);
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    return std::move(result.value());
+}
+
 namespace platform
 {
 
@@ -265,6 +393,7 @@ namespace fru
 
 bool fruInit(boost::asio::yield_context yield, const pldm_tid_t tid);
 bool deleteFRUDevice(const pldm_tid_t tid);
+void deleteFRUTransferSize(const pldm_tid_t tid);
 
 } // namespace fru
 
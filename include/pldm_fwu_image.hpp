@@ -18,6 +18,10 @@
 #include "firmware_update.hpp"
 
 #include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
 
 namespace pldm
 {
@@ -62,14 +66,52 @@ struct CompImgInfo
     uint8_t compVerStrLen;
 } __attribute__((packed));
 
+/** @brief Parsed firmware device ID record. Variable length fields are
+ * referenced by their offset in the package header.
+ */
+struct PkgDevIDRecordIndex
+{
+    FWDevIdRecord devIdRecord;
+    uint16_t initialDescriptorType;
+    uint16_t applicableComponentsOffset;
+    uint16_t compImgSetVerStrOffset;
+    uint16_t fwDevPkgDataOffset;
+    DescriptorsMap descriptors;
+};
+
+/** @brief Parsed component image information. Component version string is
+ * referenced by its offset in the package header.
+ */
+struct PkgCompIndex
+{
+    CompImgInfo compImgInfo;
+    uint16_t compVerStrOffset;
+};
+
+/** @brief Parsed PLDM package header. It is cached and shared by all PLDMImg
+ * instances created for packages with an identical header, so that repeated
+ * updates with the same package skip header parsing.
+ */
+struct PkgHdrIndex
+{
+    std::vector<uint8_t> hdrData;
+    uint32_t pkgHdrChecksum = 0;
+    PLDMPkgHeaderInfo pkgHeaderInfo = {};
+    uint16_t pkgVersionStringOffset = 0;
+    std::vector<PkgDevIDRecordIndex> devIDRecords;
+    std::vector<PkgCompIndex> components;
+};
+
 class PLDMImg
 {
   public:
     PLDMImg() = delete;
     explicit PLDMImg(const std::string& pldmImgPath);
-    /** @brief API that process PLDM firmware update package header
+    /** @brief API that process PLDM firmware update package header, reading
+     * and parsing the header on the worker pool. The header index cache and
+     * the FD descriptors are only accessed from the io_context.
      */
-    bool processPkgHdr();
+    bool processPkgHdr(boost::asio::yield_context yield);
     constexpr uint16_t getHeaderLen() const
     {
         return pkgHdrLen;
@@ -83,71 +125,50 @@ class PLDMImg
         return totalCompCount;
     }
 
-    /** @brief API that gets PLDM firmware update package header property
+    /** @brief API that gets the component image information from the parsed
+     * package header. Fields are in little endian as in the package.
      */
-    template <typename T>
-    bool getPkgProperty(T& value, const std::string& name)
+    const CompImgInfo* getCompImgInfo(const uint16_t compCount) const
     {
-        auto it = pkgFWUProperties.find(name);
-        if (it != pkgFWUProperties.end())
+        if (!pkgIndex || compCount >= pkgIndex->components.size())
         {
-            if (auto itr = std::get_if<T>(&it->second))
-            {
-                value = *itr;
-                return true;
-            }
+            return nullptr;
         }
-        return false;
+        return &pkgIndex->components[compCount].compImgInfo;
     }
 
-    /** @brief API that gets PLDM firmware update component property
+    /** @brief API that gets the component version string
      */
-    template <typename T>
-    bool getCompProperty(T& value, const std::string& name, uint16_t compCount)
-    {
-        auto itr = pkgCompProperties.find(compCount);
-        if (itr == pkgCompProperties.end())
-        {
-            return false;
-        }
-        auto& compProps = itr->second;
-        auto it = compProps.find(name);
-        if (compProps.end() != it)
-        {
-            if (auto itr2 = std::get_if<T>(&it->second))
-            {
-                value = *itr2;
-                return true;
-            }
-        }
-        return false;
-    }
+    std::string_view getCompVerStr(const uint16_t compCount) const;
 
-    /** @brief API that gets PLDM firmware update device record property
+    /** @brief API that gets the firmware device ID record from the parsed
+     * package header. Fields are in little endian as in the package.
      */
-    template <typename T>
-    bool getDevIdRcrdProperty(T& value, const std::string& name,
-                              uint8_t recordCount)
+    const FWDevIdRecord* getDevIdRecord(const uint8_t recordCount) const
     {
-        auto itr = pkgDevIDRecords.find(recordCount);
-        if (itr == pkgDevIDRecords.end())
-        {
-            return false;
-        }
-        auto& devRcd = itr->second;
-        auto& dev = devRcd.first;
-        auto it = dev.find(name);
-        if (dev.end() != it)
+        if (!pkgIndex || recordCount >= pkgIndex->devIDRecords.size())
         {
-            if (auto itr2 = std::get_if<T>(&it->second))
-            {
-                value = *itr2;
-                return true;
-            }
+            return nullptr;
         }
-        return false;
+        return &pkgIndex->devIDRecords[recordCount].devIdRecord;
     }
 
+    /** @brief API that gets the applicable components bitfield of the device
+     * ID record
+     */
+    std::span<const uint8_t>
+        getApplicableComponents(const uint8_t recordCount) const;
+
+    /** @brief API that gets the component image set version string of the
+     * device ID record
+     */
+    std::string_view getCompImgSetVerStr(const uint8_t recordCount) const;
+
+    /** @brief API that gets the firmware device package data of the device ID
+     * record
+     */
+    std::span<const uint8_t> getFWDevPkgData(const uint8_t recordCount) const;
+
     /** @brief API that is used to read raw bytes from pldm firmware update
      * image
      */
@@ -162,6 +183,29 @@ class PLDMImg
     {
         return static_cast<size_t>(pldmImgSize - pkgHdrLen);
     };
+    /** @brief API that gets package header checksum
+     */
+    constexpr uint32_t getPkgHdrChecksum() const
+    {
+        return pkgHdrChecksum;
+    }
+    /** @brief API that computes the CRC32 of the whole package and verifies
+     * the payload checksum of DSP0267 v1.3 packages. It only reads the
+     * package, so it can run on the worker pool.
+     */
+    bool computePkgChecksum();
+#ifdef FWU_VERIFY_COMPONENT_IMAGES
+    /** @brief API that reads a component image again and checks it against
+     * the CRC32 recorded by computePkgChecksum
+     */
+    bool verifyCompImage(const uint16_t comp);
+#endif
+    /** @brief API that gets the CRC32 of the whole package
+     */
+    constexpr uint32_t getPkgChecksum() const
+    {
+        return pkgChecksum;
+    }
     std::vector<std::pair<uint8_t, pldm_tid_t>> getMatchedTermini()
     {
         return matchedTermini;
@@ -187,6 +231,15 @@ class PLDMImg
      */
     bool verifyPkgHdrChecksum();
 
+    /** @brief API that gets the offset of the package header checksum
+     */
+    size_t getPkgHdrChecksumOffset() const;
+
+    /** @brief API that gets the package payload checksum, present in DSP0267
+     * v1.3 packages only
+     */
+    std::optional<uint32_t> getPkgPayloadChecksum() const;
+
     /** @brief API that validates package header data
      */
     bool validateHdrDataLen(const size_t bytesLeft, const size_t nextDataSize)
@@ -198,10 +251,50 @@ class PLDMImg
      */
     bool matchPkgHdrIdentifier(const uint8_t* packageHeaderIdentifier);
 
+    /** @brief API that gets the offset of package header iterator
+     */
+    uint16_t getHdrItrOffset()
+    {
+        return static_cast<uint16_t>(
+            std::distance(std::begin(hdrData), hdrItr));
+    }
+
     /** @brief API that advance package header iterator
      */
     bool advanceHdrItr(const size_t dataSize, const size_t nextDataSize);
 
+    /** @brief API that reads the package header into hdrData
+     */
+    bool readPkgHdr();
+
+    /** @brief API that parses the package header into the header index
+     */
+    bool parsePkgHdr();
+
+    /** @brief API that matches the header index with the FDs and checks the
+     * component images
+     */
+    bool processParsedPkgHdr();
+
+    /** @brief API that checks that every component image lies within the
+     * package payload
+     */
+    bool checkCompImgBounds();
+
+    /** @brief API that looks up an already parsed package header with
+     * identical content
+     */
+    bool loadCachedPkgHdrIndex();
+
+    /** @brief API that adds the parsed package header to the cache
+     */
+    void cachePkgHdrIndex();
+
+    /** @brief API that matches the device ID records of the parsed package
+     * header against the discovered FDs
+     */
+    bool processPkgHdrIndex();
+
     /** @brief API that process a postion PLDM firmware update package header
      */
     bool processPkgHdrInfo();
@@ -221,31 +314,20 @@ class PLDMImg
      */
     bool processCompImgInfo();
 
-    /** @brief API that copies package header info to firmware update properties
-     * map.
-     */
-    void copyPkgHdrInfoToMap(const struct PLDMPkgHeaderInfo* headerInfo,
-                             const std::string& pkgVersionString);
-
-    /** @brief API that copies device identification info to firmware update
-     * properties map.
-     */
-    void copyDevIdentificationInfoToMap(
-        const uint8_t deviceIDRecord, const uint16_t initialDescriptorType,
-        const FWDevIdRecord* devIdentificationInfo,
-        const std::vector<uint8_t>& applicableComponents,
-        const std::string& compImgSetVerStr,
-        const std::vector<uint8_t>& fwDevPkgData,
-        DescriptorsMap& pkgDescriptorRecords);
-
-    /** @brief API that copies component data to firmware update properties map.
+    /** @brief API that gets a field of the package header referenced by its
+     * offset
      */
-    void copyCompImgInfoToMap(const uint16_t count, const CompImgInfo* compInfo,
-                              const std::string& compVerStr);
+    std::span<const uint8_t> getHdrField(const uint16_t offset,
+                                         const size_t len) const;
 
     std::uintmax_t pldmImgSize;
     std::ifstream pldmImg;
     uint16_t pkgHdrLen = 0;
+    uint32_t pkgHdrChecksum = 0;
+    uint32_t pkgChecksum = 0;
+#ifdef FWU_VERIFY_COMPONENT_IMAGES
+    std::vector<uint32_t> compChecksums;
+#endif
     std::vector<uint8_t> hdrData;
     std::vector<uint8_t>::iterator hdrItr;
     uint8_t pkgVersionStringLen = 0;
@@ -253,11 +335,9 @@ class PLDMImg
     uint16_t fwDevPkgDataLen = 0;
     uint8_t deviceIDRecordCount = 0;
     uint16_t totalCompCount = 0;
-    FWUProperties pkgFWUProperties;
-    DevIDRecordsMap pkgDevIDRecords;
-    CompPropertiesMap pkgCompProperties;
     std::vector<std::pair<uint8_t, pldm_tid_t>> matchedTermini;
     std::string imagePath;
+    std::shared_ptr<PkgHdrIndex> pkgIndex;
 };
 } // namespace fwu
 } // namespace pldm
@@ -0,0 +1,265 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "transport.hpp"
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+namespace simulator
+{
+// Command codes as defined by DSP0240, DSP0248, DSP0257 and DSP0267
+namespace command
+{
+constexpr uint8_t setTID = 0x01;
+constexpr uint8_t getTID = 0x02;
+constexpr uint8_t getPLDMVersion = 0x03;
+constexpr uint8_t getPLDMTypes = 0x04;
+constexpr uint8_t getPLDMCommands = 0x05;
+
+constexpr uint8_t getTerminusUID = 0x03;
+constexpr uint8_t setEventReceiver = 0x04;
+constexpr uint8_t setNumericSensorEnable = 0x10;
+constexpr uint8_t getSensorReading = 0x11;
+constexpr uint8_t setStateSensorEnables = 0x20;
+constexpr uint8_t getStateSensorReadings = 0x21;
+constexpr uint8_t setNumericEffecterEnable = 0x30;
+constexpr uint8_t setNumericEffecterValue = 0x31;
+constexpr uint8_t getNumericEffecterValue = 0x32;
+constexpr uint8_t setStateEffecterEnables = 0x38;
+constexpr uint8_t setStateEffecterStates = 0x39;
+constexpr uint8_t getStateEffecterStates = 0x3A;
+constexpr uint8_t getPDRRepositoryInfo = 0x50;
+constexpr uint8_t getPDR = 0x51;
+
+constexpr uint8_t getFRURecordTableMetadata = 0x01;
+constexpr uint8_t getFRURecordTable = 0x02;
+
+constexpr uint8_t queryDeviceIdentifiers = 0x01;
+constexpr uint8_t getFirmwareParameters = 0x02;
+constexpr uint8_t requestUpdate = 0x10;
+constexpr uint8_t passComponentTable = 0x13;
+constexpr uint8_t updateComponent = 0x14;
+constexpr uint8_t requestFirmwareData = 0x15;
+constexpr uint8_t transferComplete = 0x16;
+constexpr uint8_t verifyComplete = 0x17;
+constexpr uint8_t applyComplete = 0x18;
+constexpr uint8_t activateFirmware = 0x1A;
+constexpr uint8_t getStatus = 0x1B;
+constexpr uint8_t cancelUpdateComponent = 0x1C;
+constexpr uint8_t cancelUpdate = 0x1D;
+} // namespace command
+
+/** @brief Raw value of a simulated numeric sensor or effecter */
+struct NumericValue
+{
+    uint8_t dataSize; // PLDM sensorDataSize/effecterDataSize encoding
+    uint32_t value;
+};
+
+/** @brief Firmware component exposed by a simulated firmware device */
+struct FirmwareComponent
+{
+    uint16_t classification;
+    uint16_t identifier;
+    uint32_t comparisonStamp;
+    std::string activeVersion;
+    std::string pendingVersion;
+};
+
+/** @brief Descriptor reported in QueryDeviceIdentifiers */
+struct FirmwareDescriptor
+{
+    uint16_t type;
+    std::vector<uint8_t> data;
+};
+
+/** @brief Simulated PLDM firmware update device */
+struct FirmwareDevice
+{
+    std::vector<FirmwareDescriptor> descriptors;
+    std::string activeImageSetVersion;
+    std::string pendingImageSetVersion;
+    std::vector<FirmwareComponent> components;
+};
+
+/** @brief Configuration of a simulated terminus
+ *
+ * Termini sharing a non-zero mux are served one request at a time, the way
+ * devices behind the same SMBus mux segment are. Loss is applied to the
+ * requests sent by pldmd and shows up as a response timeout.
+ */
+struct TerminusConfig
+{
+    mctpw::eid_t eid = 0;
+    std::array<uint8_t, 16> uuid = {};
+    uint8_t mux = 0;
+    std::chrono::microseconds latency{0};
+    double lossRate = 0.0;
+    std::vector<std::vector<uint8_t>> pdrs; // Encoded PDRs including header
+    std::map<uint16_t, NumericValue> numericSensors;
+    std::map<uint16_t, std::vector<uint8_t>> stateSensors;
+    std::map<uint16_t, NumericValue> numericEffecters;
+    std::map<uint16_t, std::vector<uint8_t>> stateEffecters;
+    std::vector<uint8_t> fruTable; // Encoded FRU records without padding
+    uint16_t fruRecordSetCount = 0;
+    uint16_t fruRecordCount = 0;
+    std::optional<FirmwareDevice> firmwareDevice;
+};
+
+/** @brief Messages of one PLDM command handled by the simulated termini
+ *
+ * Counts the requests received from pldmd and, for commands sent by a
+ * simulated firmware device, the responses received from pldmd.
+ */
+struct CommandStats
+{
+    uint64_t count = 0;
+    std::chrono::steady_clock::time_point first{};
+    std::chrono::steady_clock::time_point last{};
+};
+
+class SimulatedTerminus;
+
+/** @brief In-process transport serving simulated PLDM termini
+ *
+ * Responds to the PLDM base, platform, FRU and firmware update commands used
+ * by pldmd. During a firmware update the simulated firmware device drives the
+ * transfer by sending RequestFirmwareData and the completion commands through
+ * the receive callback, just like a real device would.
+ */
+class SimulatedTransport : public Transport
+{
+  public:
+    SimulatedTransport(boost::asio::io_context& ioc,
+                       std::vector<TerminusConfig> termini,
+                       const mctpw::ReceiveMessageCallback& onMessage,
+                       const uint32_t seed = 1);
+    ~SimulatedTransport() override;
+
+    void detectEndpoints(boost::asio::yield_context yield) override;
+    std::vector<mctpw::eid_t> getEndpoints() override;
+    SendReceiveStatus
+        sendReceiveYield(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid,
+                         const std::vector<uint8_t>& request,
+                         const std::chrono::milliseconds timeout) override;
+    void sendReceiveAsync(ReceiveCallback callback, const mctpw::eid_t dstEid,
+                          const std::vector<uint8_t>& request,
+                          const std::chrono::milliseconds timeout) override;
+    SendStatus sendYield(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid, const uint8_t msgTag,
+                         const bool tagOwner,
+                         const std::vector<uint8_t>& payload) override;
+    void sendAsync(SendCallback callback, const mctpw::eid_t dstEid,
+                   const uint8_t msgTag, const bool tagOwner,
+                   const std::vector<uint8_t>& payload) override;
+    int reserveBandwidth(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid,
+                         const uint16_t timeout) override;
+    int releaseBandwidth(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid) override;
+    void triggerDeviceDiscovery(const mctpw::eid_t dstEid) override;
+    std::optional<std::string>
+        getDeviceLocation(const mctpw::eid_t dstEid) override;
+    bool supportsConcurrentRequests(const mctpw::eid_t dstEid) override;
+
+    /** @brief Get the configuration of a simulated terminus
+     *
+     * Sensor and effecter values may be changed through the returned pointer
+     * while the simulation is running.
+     */
+    TerminusConfig* getTerminusConfig(const mctpw::eid_t eid);
+
+    /** @brief Get the statistics of a command summed over all termini */
+    CommandStats getCommandStats(const uint8_t pldmType,
+                                 const uint8_t command) const;
+
+    /** @brief Clear the statistics of all termini */
+    void resetStats();
+
+  private:
+    friend class SimulatedTerminus;
+
+    /** @brief Reserve the bus for one message to or from terminus
+     *
+     * @return time at which the message arrives. Messages to termini on the
+     * same mux are serialised.
+     */
+    std::chrono::steady_clock::time_point
+        reserveSlot(const SimulatedTerminus& terminus);
+    void runAt(const std::chrono::steady_clock::time_point when,
+               std::function<void()> action);
+    void deliverToHost(SimulatedTerminus& terminus, const uint8_t msgTag,
+                       const bool tagOwner, std::vector<uint8_t> message);
+    void deliverToTerminus(SimulatedTerminus& terminus, const uint8_t msgTag,
+                           const bool tagOwner, std::vector<uint8_t> message);
+    bool isLost(const SimulatedTerminus& terminus);
+
+    boost::asio::io_context& ioc;
+    mctpw::ReceiveMessageCallback onMessage;
+    std::map<mctpw::eid_t, std::unique_ptr<SimulatedTerminus>> termini;
+    std::map<uint8_t, std::chrono::steady_clock::time_point> muxBusyUntil;
+    std::mt19937 rng;
+};
+
+/** @brief Encode a numeric sensor PDR with 8 bit unsigned readings */
+std::vector<uint8_t> makeNumericSensorPDR(const uint32_t recordHandle,
+                                          const uint16_t sensorID,
+                                          const uint16_t entityType,
+                                          const uint16_t entityInstance,
+                                          const uint8_t baseUnit);
+
+/** @brief Encode a state sensor PDR with a single state set */
+std::vector<uint8_t> makeStateSensorPDR(const uint32_t recordHandle,
+                                        const uint16_t sensorID,
+                                        const uint16_t entityType,
+                                        const uint16_t entityInstance,
+                                        const uint16_t stateSetID,
+                                        const uint8_t possibleStates);
+
+/** @brief Encode a general FRU record holding the given string fields */
+std::vector<uint8_t> makeGeneralFRURecord(
+    const uint16_t recordSetID,
+    const std::vector<std::pair<uint8_t, std::string>>& fields);
+
+/** @brief Build a terminus with sensors, a FRU table and a firmware device */
+TerminusConfig makeDefaultTerminus(const mctpw::eid_t eid,
+                                   const size_t numericSensorCount,
+                                   const size_t stateSensorCount);
+
+/** @brief Create a simulated transport if requested by the environment
+ *
+ * PLDM_SIMULATOR_TERMINI selects the number of default termini. Latency in
+ * microseconds, loss rate, mux count and random seed are read from
+ * PLDM_SIMULATOR_LATENCY_US, PLDM_SIMULATOR_LOSS, PLDM_SIMULATOR_MUXES and
+ * PLDM_SIMULATOR_SEED. Returns nullptr when the simulator is not requested.
+ */
+std::unique_ptr<Transport>
+    createTransportFromEnvironment(boost::asio::io_context& ioc,
+                                   const mctpw::ReceiveMessageCallback& onMsg);
+} // namespace simulator
+} // namespace pldm
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include "effecter_write_queue.hpp"
+#include "memory_usage.hpp"
 #include "pdr_manager.hpp"
 
 #include <boost/asio.hpp>
@@ -43,6 +45,9 @@ class StateEffecterHandler
     /** @brief Init StateEffecterHandler*/
     bool effecterHandlerInit(boost::asio::yield_context yield);
 
+    /** @brief Add the memory held by the effecter to usage*/
+    void addMemoryUsage(MemoryUsage& usage) const;
+
   private:
     /** @brief Initialize initial D-Bus interfaces and properties*/
     void setInitialProperties();
@@ -98,7 +103,7 @@ class StateEffecterHandler
     std::shared_ptr<StateEffecterPDR> _pdr;
 
     /** @brief Error counter*/
-    size_t errCount = 0;
+    uint8_t errCount = 0;
 
     /** @brief Cache readings for later use*/
     bool isAvailableReading = false;
@@ -119,6 +124,9 @@ class StateEffecterHandler
     std::unique_ptr<sdbusplus::asio::dbus_interface> setEffecterInterface =
         nullptr;
 
+    /** @brief Coalesces SetEffecter calls*/
+    EffecterWriteQueue<uint8_t> writeQueue;
+
     /** @brief Timer to wait for trasition interval after setStateEffecter*/
     std::unique_ptr<boost::asio::steady_timer> transitionIntervalTimer;
 
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "memory_usage.hpp"
 #include "pdr_manager.hpp"
 
 #include <boost/asio.hpp>
@@ -44,7 +45,7 @@ class StateSensorHandler
     bool sensorHandlerInit(boost::asio::yield_context yield);
 
     /** @brief Read sensor value and update interfaces*/
-    bool populateSensorValue(boost::asio::yield_context yield);
+    boost::asio::awaitable<bool> populateSensorValue();
 
     /**@brief Check sensor is disabled or not*/
     bool isSensorDisabled()
@@ -55,37 +56,72 @@ class StateSensorHandler
     /** @brief Check if sensor error threshold crossed*/
     bool sensorErrorCheck();
 
+    /** @brief Add the memory held by the sensor to usage*/
+    void addMemoryUsage(MemoryUsage& usage) const;
+
   private:
+    /** @brief D-Bus interfaces and cached readings of one composite sensor
+     * offset
+     */
+    struct CompositeSensor
+    {
+        /** @brief Cache readings until the interfaces are initialized*/
+        bool isAvailableReading = false;
+        bool isFuntionalReading = false;
+        uint8_t previousStateReading = PLDM_INVALID_VALUE;
+        uint8_t currentStateReading = PLDM_INVALID_VALUE;
+
+        /** @brief Flag which indicate interfaces are ready*/
+        bool interfaceInitialized = false;
+
+        /** @brief Sensor Interfaces*/
+        std::unique_ptr<sdbusplus::asio::dbus_interface> sensorInterface =
+            nullptr;
+        std::unique_ptr<sdbusplus::asio::dbus_interface> availableInterface =
+            nullptr;
+        std::unique_ptr<sdbusplus::asio::dbus_interface>
+            operationalInterface = nullptr;
+    };
+
     /** @brief Enable/Disable sensor*/
     bool setStateSensorEnables(boost::asio::yield_context yield);
 
     /** @brief fetch the sensor value*/
-    bool getStateSensorReadings(boost::asio::yield_context yield);
+    boost::asio::awaitable<bool> getStateSensorReadings();
+
+    /** @brief Get the D-Bus name of a composite sensor offset*/
+    std::string getCompositeSensorName(const size_t offset) const;
 
     /** @brief Set initial D-Bus interfaces and properties*/
     void setInitialProperties();
 
     /** @brief Initialize D-Bus interfaces*/
-    void initializeInterface();
+    void initializeInterface(CompositeSensor& sensor);
 
     /** @brief Update the sensor functionality*/
-    void markFunctional(bool isFunctional);
+    void markFunctional(CompositeSensor& sensor, bool isFunctional);
 
     /** @brief Update the sensor availability*/
-    void markAvailable(bool isAvailable);
+    void markAvailable(CompositeSensor& sensor, bool isAvailable);
 
     /** @brief Increment the error count in case of failure*/
     void incrementError();
 
-    /** @brief Update sensor state*/
-    void updateState(const uint8_t currentState, const uint8_t previousState,
-                     const bool isAvailable, const bool isFunctional);
+    /** @brief Update sensor state of a composite sensor offset*/
+    void updateState(const size_t offset, const uint8_t currentState,
+                     const uint8_t previousState, const bool isAvailable,
+                     const bool isFunctional);
+
+    /** @brief Update sensor state of all composite sensor offsets*/
+    void updateStates(const uint8_t currentState, const uint8_t previousState,
+                      const bool isAvailable, const bool isFunctional);
 
-    /** @brief Handle sensor reading*/
-    bool handleSensorReading(get_sensor_state_field& stateReading);
+    /** @brief Handle sensor reading of a composite sensor offset*/
+    bool handleSensorReading(const size_t offset,
+                             get_sensor_state_field& stateReading);
 
     /** @brief Log redfish event for sensor state change*/
-    void logStateChangeEvent(const uint8_t currentState,
+    void logStateChangeEvent(const size_t offset, const uint8_t currentState,
                              const uint8_t previousState);
 
     /** @brief Terminus ID*/
@@ -101,26 +137,13 @@ class StateSensorHandler
     std::shared_ptr<StateSensorPDR> _pdr;
 
     /** @brief Error counter*/
-    size_t errCount = 0;
+    uint8_t errCount = 0;
 
     /** @brief Sensor disabled flag*/
     bool sensorDisabled = false;
 
-    /** @brief Cache readings for later use*/
-    bool isAvailableReading = false;
-    bool isFuntionalReading = false;
-    uint8_t previousStateReading = PLDM_INVALID_VALUE;
-    uint8_t currentStateReading = PLDM_INVALID_VALUE;
-
-    /** @brief Flag which indicate interfaces are ready*/
-    bool interfaceInitialized = false;
-
-    /** @brief Sensor Interfaces*/
-    std::unique_ptr<sdbusplus::asio::dbus_interface> sensorInterface = nullptr;
-    std::unique_ptr<sdbusplus::asio::dbus_interface> availableInterface =
-        nullptr;
-    std::unique_ptr<sdbusplus::asio::dbus_interface> operationalInterface =
-        nullptr;
+    /** @brief One entry per composite sensor offset, in PDR order*/
+    std::vector<CompositeSensor> compositeSensors;
 };
 
 } // namespace platform
@@ -0,0 +1,144 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "mctp_wrapper.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+/** @brief Message transport between pldmd and the PLDM termini
+ *
+ * Mirrors the subset of mctpw::MCTPWrapper used by pldmd so that the daemon
+ * can run either on top of mctpwplus or on top of an in-process simulator.
+ * All payloads carry the MCTP message type as the first byte.
+ */
+class Transport
+{
+  public:
+    using SendReceiveStatus =
+        std::pair<boost::system::error_code, std::vector<uint8_t>>;
+    using SendStatus = std::pair<boost::system::error_code, int>;
+    using ReceiveCallback = std::function<void(
+        boost::system::error_code, const std::vector<uint8_t>&)>;
+    using SendCallback = std::function<void(boost::system::error_code, int)>;
+
+    virtual ~Transport() = default;
+
+    /** @brief Discover the endpoints reachable through the transport */
+    virtual void detectEndpoints(boost::asio::yield_context yield) = 0;
+
+    /** @brief Get the EIDs found by detectEndpoints */
+    virtual std::vector<mctpw::eid_t> getEndpoints() = 0;
+
+    /** @brief Send a request and wait for the matching response */
+    virtual SendReceiveStatus
+        sendReceiveYield(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid,
+                         const std::vector<uint8_t>& request,
+                         const std::chrono::milliseconds timeout) = 0;
+
+    /** @brief Send a request and invoke callback with the response */
+    virtual void sendReceiveAsync(ReceiveCallback callback,
+                                  const mctpw::eid_t dstEid,
+                                  const std::vector<uint8_t>& request,
+                                  const std::chrono::milliseconds timeout) = 0;
+
+    /** @brief Send a message without waiting for a response */
+    virtual SendStatus sendYield(boost::asio::yield_context yield,
+                                 const mctpw::eid_t dstEid,
+                                 const uint8_t msgTag, const bool tagOwner,
+                                 const std::vector<uint8_t>& payload) = 0;
+
+    /** @brief Send a message and invoke callback once it is sent */
+    virtual void sendAsync(SendCallback callback, const mctpw::eid_t dstEid,
+                           const uint8_t msgTag, const bool tagOwner,
+                           const std::vector<uint8_t>& payload) = 0;
+
+    /** @brief Reserve the transport for exclusive use with dstEid */
+    virtual int reserveBandwidth(boost::asio::yield_context yield,
+                                 const mctpw::eid_t dstEid,
+                                 const uint16_t timeout) = 0;
+
+    /** @brief Release a reservation taken with reserveBandwidth */
+    virtual int releaseBandwidth(boost::asio::yield_context yield,
+                                 const mctpw::eid_t dstEid) = 0;
+
+    /** @brief Ask the transport to rediscover dstEid */
+    virtual void triggerDeviceDiscovery(const mctpw::eid_t dstEid) = 0;
+
+    /** @brief Get the physical location of dstEid if known */
+    virtual std::optional<std::string>
+        getDeviceLocation(const mctpw::eid_t dstEid) = 0;
+
+    /** @brief Check whether dstEid may be sent requests of different PLDM
+     * types at the same time. Devices behind an SMBus mux may not.
+     */
+    virtual bool supportsConcurrentRequests(const mctpw::eid_t dstEid) = 0;
+};
+
+/** @brief Transport backed by mctpwplus */
+class MCTPTransport : public Transport
+{
+  public:
+    MCTPTransport(std::shared_ptr<sdbusplus::asio::connection> conn,
+                  const mctpw::MCTPConfiguration& config,
+                  const mctpw::ReconfigurationCallback& onDeviceUpdate,
+                  const mctpw::ReceiveMessageCallback& onMessage);
+
+    void detectEndpoints(boost::asio::yield_context yield) override;
+    std::vector<mctpw::eid_t> getEndpoints() override;
+    SendReceiveStatus
+        sendReceiveYield(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid,
+                         const std::vector<uint8_t>& request,
+                         const std::chrono::milliseconds timeout) override;
+    void sendReceiveAsync(ReceiveCallback callback, const mctpw::eid_t dstEid,
+                          const std::vector<uint8_t>& request,
+                          const std::chrono::milliseconds timeout) override;
+    SendStatus sendYield(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid, const uint8_t msgTag,
+                         const bool tagOwner,
+                         const std::vector<uint8_t>& payload) override;
+    void sendAsync(SendCallback callback, const mctpw::eid_t dstEid,
+                   const uint8_t msgTag, const bool tagOwner,
+                   const std::vector<uint8_t>& payload) override;
+    int reserveBandwidth(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid,
+                         const uint16_t timeout) override;
+    int releaseBandwidth(boost::asio::yield_context yield,
+                         const mctpw::eid_t dstEid) override;
+    void triggerDeviceDiscovery(const mctpw::eid_t dstEid) override;
+    std::optional<std::string>
+        getDeviceLocation(const mctpw::eid_t dstEid) override;
+    bool supportsConcurrentRequests(const mctpw::eid_t dstEid) override;
+
+  private:
+    mctpw::MCTPWrapper wrapper;
+    // mctpwplus does not tell whether an SMBus endpoint is behind a mux
+    bool smbusBinding;
+};
+
+/** @brief Transport used for all PLDM messaging of the daemon */
+extern std::unique_ptr<Transport> transport;
+} // namespace pldm
@@ -16,22 +16,54 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
 #include <sstream>
+#include <string_view>
 #include <vector>
 
+/** @brief flag to enable debugging*/
+extern bool debug;
+
 namespace utils
 {
 
+/** @brief Directory of the caches and checkpoints kept across restarts.
+ * Benchmark builds use a scratch directory to leave the BMC state alone.
+ */
+#ifdef PLDM_BENCH
+constexpr const char* stateDir = "/tmp/pldmd_bench";
+#else
+constexpr const char* stateDir = "/var/lib/pldmd";
+#endif
+
+/** @brief Helper to log a hex dump of a vector with log level DEBUG
+ *
+ * @param msg[in] - Message to print along the vector
+ * @param vec[in] - Vector of bytes to print
+ *
+ */
+void dumpVect(std::string_view msg, const std::vector<uint8_t>& vec);
+
 /** @brief Helper to print vector
  *
  * Helper to print an array of bytes(eg: Request,Response) with log level DEBUG
+ * when PLDM_DEBUG is enabled. Costs a single branch otherwise.
  *
  * @param msg[in] - Message to print along the vector
  * @param vec[in] - Vector of bytes to print
  *
  */
-void printVect(const std::string& msg, const std::vector<uint8_t>& vec);
+inline void printVect(std::string_view msg, const std::vector<uint8_t>& vec)
+{
+    if (debug)
+    {
+        dumpVect(msg, vec);
+    }
+}
 
 /** @brief Helper to convert a number to uint32
  *
@@ -61,4 +93,72 @@ inline uint32_t to_uint32(uint64_t num)
     return static_cast<uint32_t>(num);
 }
 
+/** @brief Helper to calculate CRC32 incrementally
+ *
+ * Calculates the same CRC-32 (ISO 3309) as crc32() of libpldm, but processes
+ * eight bytes per step using slicing tables, so that large images can be
+ * checksummed in chunks.
+ *
+ * @param crc[in] - CRC32 of the preceding data, 0 for the first chunk
+ * @param data[in] - Pointer to the data
+ * @param size[in] - Size of the data in bytes
+ * @return - CRC32 of the preceding data followed by this chunk
+ *
+ */
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size);
+
+/** @brief Helper to append the raw bytes of a trivially copyable value
+ *
+ * @param buffer[out] - Buffer to append to
+ * @param value[in] - Value to append
+ *
+ */
+template <typename T>
+void appendRaw(std::vector<uint8_t>& buffer, const T& value)
+{
+    auto ptr = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+}
+
+/** @brief Helper to read a trivially copyable value and advance the buffer
+ *
+ * @param buffer[in,out] - Remaining bytes, advanced past the value on success
+ * @param value[out] - Value read
+ * @return - false if the buffer is too short
+ *
+ */
+template <typename T>
+bool readRaw(std::span<const uint8_t>& buffer, T& value)
+{
+    if (buffer.size() < sizeof(T))
+    {
+        return false;
+    }
+    std::memcpy(&value, buffer.data(), sizeof(T));
+    buffer = buffer.subspan(sizeof(T));
+    return true;
+}
+
+/** @brief Helper to read a whole file
+ *
+ * @param path[in] - File to read
+ * @return - Contents of the file, empty if it can't be opened
+ *
+ */
+std::vector<uint8_t> readFile(const std::filesystem::path& path);
+
+/** @brief Helper to replace a file without leaving a partial write behind
+ *
+ * Creates the parent directory if needed, writes data to a temporary file and
+ * renames it over path.
+ *
+ * @param path[in] - File to replace
+ * @param data[in] - New contents
+ * @param name[in] - Description of the file used in log messages
+ * @return - true on success
+ *
+ */
+bool writeFileAtomic(const std::filesystem::path& path,
+                     const std::vector<uint8_t>& data, std::string_view name);
+
 } // namespace utils
@@ -15,9 +15,12 @@
  */
 #include "base.hpp"
 
+#include "base_cache.hpp"
 #include "platform.hpp"
 #include "pldm.hpp"
+#include "transport.hpp"
 
+#include <boost/asio/steady_timer.hpp>
 #include <numeric>
 #include <phosphor-logging/log.hpp>
 #include <unordered_map>
@@ -59,9 +62,6 @@ constexpr uint8_t defaultTID = 0x00;
 constexpr size_t maxTIDPoolSize = 254;
 constexpr std::chrono::minutes tidReclaimWindow{3};
 
-using SupportedPLDMTypes = std::array<bitfield8_t, 8>;
-using PLDMVersions = std::vector<ver32_t>;
-using VersionSupportTable = std::unordered_map<uint8_t, PLDMVersions>;
 struct BaseInterfaces
 {
     DBusInterfacePtr msgTypeInterface;
@@ -231,7 +231,8 @@ bool getSupportedPLDMTypes(boost::asio::yield_context yield,
 }
 
 bool getPLDMVersions(boost::asio::yield_context yield, const mctpw_eid_t eid,
-                     const uint8_t pldmType, PLDMVersions& supportedVersions)
+                     const uint8_t pldmType, PLDMVersions& supportedVersions,
+                     bool* noResponse = nullptr)
 {
     int8_t maxTransfers = 16;
     uint8_t instanceID = createInstanceId(defaultTID);
@@ -271,6 +272,10 @@ bool getPLDMVersions(boost::asio::yield_context yield, const mctpw_eid_t eid,
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "Send or receive error while getting supported PLDM Versions",
                 phosphor::logging::entry("EID=0x%X", eid));
+            if (noResponse)
+            {
+                *noResponse = true;
+            }
             return false;
         }
 
@@ -342,7 +347,8 @@ bool getPLDMVersions(boost::asio::yield_context yield, const mctpw_eid_t eid,
 
 std::optional<SupportedCommands>
     getPLDMCommands(boost::asio::yield_context yield, const mctpw_eid_t eid,
-                    const uint8_t pldmType, const ver32_t& version)
+                    const uint8_t pldmType, const ver32_t& version,
+                    bool* noResponse = nullptr)
 {
     uint8_t instanceID = createInstanceId(defaultTID);
     std::vector<uint8_t> getCommandsRequest(
@@ -362,6 +368,10 @@ std::optional<SupportedCommands>
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Send or receive error during GetPLDMCommands request",
             phosphor::logging::entry("EID=0x%X", eid));
+        if (noResponse)
+        {
+            *noResponse = true;
+        }
         return std::nullopt;
     }
 
@@ -466,28 +476,143 @@ bool setTID(boost::asio::yield_context yield, const mctpw_eid_t eid,
     return true;
 }
 
+// Outcome of a per-type query. Only a missing response hints that the
+// responder can't handle outstanding requests of different PLDM types.
+enum class TypeQueryStatus
+{
+    success,
+    failed,
+    noResponse
+};
+
+// Runs the handler once per PLDM type in its own coroutine, so that requests
+// of different types are outstanding at the same time, and waits until all of
+// them have finished. Returns the types the handler got no response for, the
+// types it failed for otherwise are added to failedTypes.
+template <typename Handler>
+static std::vector<uint8_t>
+    forEachTypeConcurrently(boost::asio::yield_context yield,
+                            const std::vector<uint8_t>& pldmTypes,
+                            Handler&& handler,
+                            std::vector<uint8_t>& failedTypes)
+{
+    std::vector<uint8_t> noResponseTypes;
+    if (pldmTypes.empty())
+    {
+        return noResponseTypes;
+    }
+    auto pending = std::make_shared<size_t>(pldmTypes.size());
+    auto joinTimer = std::make_shared<boost::asio::steady_timer>(
+        *getIoContext(), boost::asio::steady_timer::time_point::max());
+    for (uint8_t pldmType : pldmTypes)
+    {
+        boost::asio::spawn(
+            *getIoContext(),
+            [pldmType, pending, joinTimer, &handler, &failedTypes,
+             &noResponseTypes](boost::asio::yield_context typeYield) {
+                TypeQueryStatus status = TypeQueryStatus::failed;
+                try
+                {
+                    status = handler(typeYield, pldmType);
+                }
+                catch (const std::exception& e)
+                {
+                    phosphor::logging::log<phosphor::logging::level::ERR>(
+                        e.what(),
+                        phosphor::logging::entry("TYPE=0x%X", pldmType));
+                }
+                if (status == TypeQueryStatus::noResponse)
+                {
+                    noResponseTypes.emplace_back(pldmType);
+                }
+                else if (status != TypeQueryStatus::success)
+                {
+                    failedTypes.emplace_back(pldmType);
+                }
+                if (--(*pending) == 0)
+                {
+                    joinTimer->cancel();
+                }
+            });
+    }
+    // Handlers finishing without suspending complete before the wait starts
+    if (*pending > 0)
+    {
+        boost::system::error_code ec;
+        joinTimer->async_wait(yield[ec]);
+    }
+    return noResponseTypes;
+}
+
+// Runs the handler for every PLDM type, concurrently while concurrentQueries
+// is set. Types left without a response concurrently are retried one at a
+// time and concurrentQueries is cleared for the rest of the device init, so
+// that the timeout is paid only once. Returns the types the handler finally
+// failed for.
+template <typename Handler>
+static std::vector<uint8_t> forEachType(boost::asio::yield_context yield,
+                                        const mctpw_eid_t eid,
+                                        const std::vector<uint8_t>& pldmTypes,
+                                        bool& concurrentQueries,
+                                        Handler&& handler)
+{
+    std::vector<uint8_t> failedTypes;
+    std::vector<uint8_t> retryTypes = pldmTypes;
+    if (concurrentQueries)
+    {
+        retryTypes =
+            forEachTypeConcurrently(yield, pldmTypes, handler, failedTypes);
+        if (retryTypes.empty())
+        {
+            return failedTypes;
+        }
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Falling back to sequential queries",
+            phosphor::logging::entry("EID=0x%X", eid));
+        concurrentQueries = false;
+    }
+
+    for (auto pldmType : retryTypes)
+    {
+        if (handler(yield, pldmType) != TypeQueryStatus::success)
+        {
+            failedTypes.emplace_back(pldmType);
+        }
+    }
+    return failedTypes;
+}
+
 VersionSupportTable
     createVersionSupportTable(boost::asio::yield_context yield,
                               const mctpw_eid_t eid,
-                              const SupportedPLDMTypes& pldmTypes)
+                              const SupportedPLDMTypes& pldmTypes,
+                              bool& concurrentQueries)
 {
     VersionSupportTable versionSupportTable;
     auto typeCodes = getTypeCodesFromSupportedTypes(pldmTypes);
-    for (auto pldmType : typeCodes)
-    {
+    auto getVersions = [&](boost::asio::yield_context typeYield,
+                           const uint8_t pldmType) {
         PLDMVersions versions;
-        if (getPLDMVersions(yield, eid, pldmType, versions))
+        bool noResponse = false;
+        if (!getPLDMVersions(typeYield, eid, pldmType, versions, &noResponse))
         {
-            versionSupportTable.emplace(pldmType, versions);
-        }
-        else
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Error getting supported PLDM Versions",
-                phosphor::logging::entry("EID=0x%X", eid),
-                phosphor::logging::entry("TYPE=0x%X", pldmType));
-            // Continue scanning next PLDM type
+            return noResponse ? TypeQueryStatus::noResponse
+                              : TypeQueryStatus::failed;
         }
+        versionSupportTable.emplace(pldmType, std::move(versions));
+        return TypeQueryStatus::success;
+    };
+
+    for (auto pldmType :
+         forEachType(yield, eid,
+                     std::vector<uint8_t>(typeCodes.begin(), typeCodes.end()),
+                     concurrentQueries, getVersions))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Error getting supported PLDM Versions",
+            phosphor::logging::entry("EID=0x%X", eid),
+            phosphor::logging::entry("TYPE=0x%X", pldmType));
+        // Continue scanning next PLDM type
     }
     return versionSupportTable;
 }
@@ -495,9 +620,11 @@ VersionSupportTable
 CommandSupportTable
     createCommandSupportTable(boost::asio::yield_context yield,
                               const mctpw_eid_t eid,
-                              const VersionSupportTable& versionSupportTable)
+                              const VersionSupportTable& versionSupportTable,
+                              bool& concurrentQueries)
 {
     CommandSupportTable cmdSupportTable;
+    std::vector<uint8_t> pldmTypes;
     for (const auto& versionTable : versionSupportTable)
     {
         if (versionTable.second.size() == 0)
@@ -505,23 +632,33 @@ CommandSupportTable
             // No versions supported for this type
             continue;
         }
-        // Only the first PLDM version type given out for the type is
-        // processed
-        ver32_t firstVersion = versionTable.second.front();
-        auto supportedCommands =
-            getPLDMCommands(yield, eid, versionTable.first, firstVersion);
-        if (supportedCommands)
-        {
-            cmdSupportTable[versionTable.first].emplace(
-                firstVersion, supportedCommands.value());
-        }
-        else
+        pldmTypes.emplace_back(versionTable.first);
+    }
+
+    // Only the first PLDM version type given out for the type is processed
+    auto getCommands = [&](boost::asio::yield_context typeYield,
+                           const uint8_t pldmType) {
+        ver32_t firstVersion = versionSupportTable.at(pldmType).front();
+        bool noResponse = false;
+        auto supportedCommands = getPLDMCommands(typeYield, eid, pldmType,
+                                                 firstVersion, &noResponse);
+        if (!supportedCommands)
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "GetPLDMCommands failed",
-                phosphor::logging::entry("TYPE=0x%X", versionTable.first),
-                phosphor::logging::entry("EID=0x%X", eid));
+            return noResponse ? TypeQueryStatus::noResponse
+                              : TypeQueryStatus::failed;
         }
+        cmdSupportTable[pldmType].emplace(firstVersion,
+                                          supportedCommands.value());
+        return TypeQueryStatus::success;
+    };
+
+    for (auto pldmType : forEachType(yield, eid, pldmTypes, concurrentQueries,
+                                     getCommands))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "GetPLDMCommands failed",
+            phosphor::logging::entry("TYPE=0x%X", pldmType),
+            phosphor::logging::entry("EID=0x%X", eid));
     }
     return cmdSupportTable;
 }
@@ -605,11 +742,42 @@ void releaseTIDAfterReclaimInterval(const pldm_tid_t tid)
     tidReclaimWindowTimers.emplace(tid, std::move(tidReclaimTimer));
 }
 
+std::optional<std::array<uint8_t, 16>> getTerminusUUID(const pldm_tid_t tid)
+{
+    auto itr = std::find_if(uuidMapping.begin(), uuidMapping.end(),
+                            [&tid](const auto& uuidTID) {
+                                auto const& [uuid, mappedTID] = uuidTID;
+                                return mappedTID == tid;
+                            });
+    if (itr == uuidMapping.end())
+    {
+        return std::nullopt;
+    }
+    return itr->first;
+}
+
 bool isTerminusUnregistered(const pldm_tid_t tid)
 {
     return tidReclaimWindowTimers.count(tid) == 1;
 }
 
+#ifdef PLDM_BENCH
+void resetTIDMapping()
+{
+    for (const auto& [tid, reclaimTimer] : tidReclaimWindowTimers)
+    {
+        reclaimTimer->cancel();
+    }
+    tidReclaimWindowTimers.clear();
+    for (const auto& [tid, eid] : tidMapper.getTIDMap())
+    {
+        tidMapper.removeEntry(tid);
+    }
+    uuidMapping.clear();
+    tidPool = TIDPool(maxTIDPoolSize);
+}
+#endif
+
 static std::string formatUUID(const pldm::platform::UUID& uuid)
 {
     constexpr size_t safeBufferLength = 50;
@@ -792,10 +960,60 @@ bool baseInit(boost::asio::yield_context yield, const mctpw_eid_t eid,
         "GetTypes processed successfully",
         phosphor::logging::entry("EID=%d", eid));
 
-    auto versionSupportTable = createVersionSupportTable(yield, eid, pldmTypes);
+    // UUID and PLDM base versions identify a terminus already discovered
+    // earlier, in which case GetPLDMVersion and GetPLDMCommands of every other
+    // PLDM type are skipped
+    std::optional<pldm::platform::UUID> uuid;
+    std::optional<CommandSupportTable> cachedCmdSupportTable;
+    PLDMVersions baseVersions;
+    if (getPldmMsgTypes(pldmTypes).platform)
+    {
+        // Support of GetTerminusUID is not known yet. Probe it without
+        // retries, so that a terminus lacking it costs a single timeout.
+        uuid = pldm::platform::getTerminusUID(yield, defaultTID, eid, 0);
+    }
+    if (uuid && getPLDMVersions(yield, eid, PLDM_BASE, baseVersions))
+    {
+        cachedCmdSupportTable =
+            getCachedCommandSupportTable(uuid.value(), pldmTypes, baseVersions);
+    }
 
-    cmdSupportTable =
-        createCommandSupportTable(yield, eid, versionSupportTable);
+    if (cachedCmdSupportTable)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Using cached base discovery data",
+            phosphor::logging::entry("EID=%d", eid));
+        cmdSupportTable = std::move(cachedCmdSupportTable.value());
+    }
+    else
+    {
+        // Devices behind an SMBus mux fail outstanding requests, query them
+        // one PLDM type at a time
+        bool concurrentQueries = transport->supportsConcurrentRequests(eid);
+        auto versionSupportTable =
+            createVersionSupportTable(yield, eid, pldmTypes, concurrentQueries);
+
+        cmdSupportTable = createCommandSupportTable(
+            yield, eid, versionSupportTable, concurrentQueries);
+
+        const bool uuidSupported =
+            isSupported(cmdSupportTable, PLDM_PLATFORM, PLDM_GET_TERMINUS_UID);
+        if (!uuid && uuidSupported)
+        {
+            uuid = pldm::platform::getTerminusUID(yield, defaultTID, eid);
+        }
+        auto itBaseVersions = versionSupportTable.find(PLDM_BASE);
+        if (uuid && itBaseVersions != versionSupportTable.end() &&
+            uuidSupported)
+        {
+            cacheCommandSupportTable(uuid.value(), pldmTypes,
+                                     itBaseVersions->second, cmdSupportTable);
+        }
+    }
+    if (!isSupported(cmdSupportTable, PLDM_PLATFORM, PLDM_GET_TERMINUS_UID))
+    {
+        uuid.reset();
+    }
 
     auto assignedTID = getTID(yield, eid);
     if (!assignedTID.has_value())
@@ -817,19 +1035,14 @@ bool baseInit(boost::asio::yield_context yield, const mctpw_eid_t eid,
     }
 
     bool prevTIDExists = false;
-    std::optional<pldm::platform::UUID> uuid;
     tid = 0x00;
-    if (isSupported(cmdSupportTable, PLDM_PLATFORM, PLDM_GET_TERMINUS_UID))
+    if (uuid)
     {
-        uuid = pldm::platform::getTerminusUID(yield, tid, eid);
-        if (uuid)
+        auto itTID = uuidMapping.find(uuid.value());
+        if (uuidMapping.end() != itTID)
         {
-            auto itTID = uuidMapping.find(uuid.value());
-            if (uuidMapping.end() != itTID)
-            {
-                tid = itTID->second;
-                prevTIDExists = true;
-            }
+            tid = itTID->second;
+            prevTIDExists = true;
         }
     }
 
@@ -0,0 +1,233 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "base_cache.hpp"
+
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <phosphor-logging/log.hpp>
+#include <span>
+
+namespace pldm
+{
+namespace base
+{
+struct CachedCapabilities
+{
+    SupportedPLDMTypes pldmTypes;
+    PLDMVersions baseVersions;
+    CommandSupportTable cmdSupportTable;
+};
+
+static const std::filesystem::path baseCacheFile =
+    std::filesystem::path(utils::stateDir) / "base_cache";
+static std::map<pldm::platform::UUID, CachedCapabilities> capabilityCache;
+static bool capabilityCacheLoaded = false;
+
+using utils::appendRaw;
+using utils::readRaw;
+
+static bool readVersions(std::span<const uint8_t>& buffer,
+                         PLDMVersions& versions)
+{
+    uint8_t versionCount = 0;
+    if (!readRaw(buffer, versionCount))
+    {
+        return false;
+    }
+    versions.resize(versionCount);
+    for (auto& version : versions)
+    {
+        if (!readRaw(buffer, version))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool readEntry(std::span<const uint8_t>& buffer,
+                      pldm::platform::UUID& uuid, CachedCapabilities& entry)
+{
+    uint8_t typeCount = 0;
+    if (!readRaw(buffer, uuid) || !readRaw(buffer, entry.pldmTypes) ||
+        !readVersions(buffer, entry.baseVersions) ||
+        !readRaw(buffer, typeCount))
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < typeCount; i++)
+    {
+        uint8_t type = 0;
+        uint8_t versionCount = 0;
+        if (!readRaw(buffer, type) || !readRaw(buffer, versionCount))
+        {
+            return false;
+        }
+        auto& versionTable = entry.cmdSupportTable[type];
+        for (uint8_t j = 0; j < versionCount; j++)
+        {
+            ver32_t version = {};
+            SupportedCommands commands = {};
+            if (!readRaw(buffer, version) || !readRaw(buffer, commands))
+            {
+                return false;
+            }
+            versionTable.emplace(version, commands);
+        }
+    }
+    return true;
+}
+
+static void loadCapabilityCache()
+{
+    capabilityCacheLoaded = true;
+    std::vector<uint8_t> data = utils::readFile(baseCacheFile);
+    if (data.empty())
+    {
+        return;
+    }
+
+    std::span<const uint8_t> buffer(data);
+    BaseCacheHeader header = {};
+    if (!readRaw(buffer, header) || header.magic != baseCacheMagic ||
+        header.version != baseCacheVersion)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Discarding invalid base discovery cache");
+        return;
+    }
+    for (uint16_t i = 0; i < header.entryCount; i++)
+    {
+        pldm::platform::UUID uuid = {};
+        CachedCapabilities entry;
+        if (!readEntry(buffer, uuid, entry))
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Base discovery cache is truncated");
+            capabilityCache.clear();
+            return;
+        }
+        capabilityCache.insert_or_assign(uuid, std::move(entry));
+    }
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Loaded base discovery cache. ENTRY_COUNT: " +
+         std::to_string(capabilityCache.size()))
+            .c_str());
+}
+
+static bool saveCapabilityCache()
+{
+    std::vector<uint8_t> data;
+    BaseCacheHeader header = {};
+    header.magic = baseCacheMagic;
+    header.version = baseCacheVersion;
+    header.entryCount = static_cast<uint16_t>(capabilityCache.size());
+    appendRaw(data, header);
+    for (const auto& [uuid, entry] : capabilityCache)
+    {
+        appendRaw(data, uuid);
+        appendRaw(data, entry.pldmTypes);
+        appendRaw(data, static_cast<uint8_t>(entry.baseVersions.size()));
+        for (const auto& version : entry.baseVersions)
+        {
+            appendRaw(data, version);
+        }
+        appendRaw(data, static_cast<uint8_t>(entry.cmdSupportTable.size()));
+        for (const auto& [type, versionTable] : entry.cmdSupportTable)
+        {
+            appendRaw(data, type);
+            appendRaw(data, static_cast<uint8_t>(versionTable.size()));
+            for (const auto& [version, commands] : versionTable)
+            {
+                appendRaw(data, version);
+                appendRaw(data, commands);
+            }
+        }
+    }
+
+    return utils::writeFileAtomic(baseCacheFile, data,
+                                  "base discovery cache");
+}
+
+static bool isSameVersions(const PLDMVersions& v1, const PLDMVersions& v2)
+{
+    return std::equal(v1.begin(), v1.end(), v2.begin(), v2.end(),
+                      std::equal_to<ver32_t>{});
+}
+
+std::optional<CommandSupportTable>
+    getCachedCommandSupportTable(const pldm::platform::UUID& uuid,
+                                 const SupportedPLDMTypes& pldmTypes,
+                                 const PLDMVersions& baseVersions)
+{
+    if (!capabilityCacheLoaded)
+    {
+        loadCapabilityCache();
+    }
+    auto it = capabilityCache.find(uuid);
+    if (it == capabilityCache.end())
+    {
+        return std::nullopt;
+    }
+    const CachedCapabilities& entry = it->second;
+    if (std::memcmp(entry.pldmTypes.data(), pldmTypes.data(),
+                    sizeof(SupportedPLDMTypes)) != 0 ||
+        !isSameVersions(entry.baseVersions, baseVersions))
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Terminus capabilities changed, ignoring base discovery cache");
+        return std::nullopt;
+    }
+    return entry.cmdSupportTable;
+}
+
+void cacheCommandSupportTable(const pldm::platform::UUID& uuid,
+                              const SupportedPLDMTypes& pldmTypes,
+                              const PLDMVersions& baseVersions,
+                              const CommandSupportTable& cmdSupportTable)
+{
+    if (!capabilityCacheLoaded)
+    {
+        loadCapabilityCache();
+    }
+    if (capabilityCache.size() >= maxBaseCacheEntries &&
+        capabilityCache.find(uuid) == capabilityCache.end())
+    {
+        // Cache is only an optimisation, drop an arbitrary entry to make room
+        capabilityCache.erase(capabilityCache.begin());
+    }
+    capabilityCache.insert_or_assign(
+        uuid, CachedCapabilities{pldmTypes, baseVersions, cmdSupportTable});
+    saveCapabilityCache();
+}
+
+void removeCachedCommandSupportTable(const pldm::platform::UUID& uuid)
+{
+    if (!capabilityCacheLoaded)
+    {
+        loadCapabilityCache();
+    }
+    if (capabilityCache.erase(uuid) != 0)
+    {
+        saveCapabilityCache();
+    }
+}
+} // namespace base
+} // namespace pldm
@@ -0,0 +1,173 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "command_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <phosphor-logging/log.hpp>
+#include <tuple>
+
+namespace pldm
+{
+namespace stats
+{
+using CommandStatistics =
+    std::tuple<pldm_tid_t, uint8_t, uint8_t, uint64_t, uint64_t, uint64_t,
+               uint64_t, uint64_t, uint64_t, std::vector<uint64_t>>;
+
+// Counters are kept since daemon start or the last Reset, TIDs reassigned to
+// another terminus keep accumulating into the same counters
+static std::unordered_map<uint32_t, CommandCounters> commandCounters;
+
+static CommandCounters& getCounters(const CommandKey& key)
+{
+    return commandCounters[static_cast<uint32_t>(key.tid) << 16 |
+                           static_cast<uint32_t>(key.pldmType) << 8 |
+                           key.command];
+}
+
+CommandKey getCommandKey(const pldm_tid_t tid,
+                         const std::vector<uint8_t>& pldmMsg)
+{
+    // Malformed messages are accounted to command 0 of type 0
+    if (pldmMsg.size() < sizeof(pldm_msg_hdr))
+    {
+        return CommandKey{tid, 0, 0};
+    }
+    auto hdr = reinterpret_cast<const pldm_msg_hdr*>(pldmMsg.data());
+    return CommandKey{tid, hdr->type, hdr->command};
+}
+
+size_t getLatencyBucket(const uint64_t latency)
+{
+    if (latency < subBucketCount)
+    {
+        return latency;
+    }
+    const size_t msb = std::bit_width(latency) - 1U;
+    const size_t bucket = (msb - subBucketBits + 1) * subBucketCount +
+                          ((latency >> (msb - subBucketBits)) &
+                           (subBucketCount - 1));
+    return std::min(bucket, latencyBucketCount - 1);
+}
+
+uint64_t getLatencyBucketLowerBound(const size_t bucket)
+{
+    if (bucket < subBucketCount)
+    {
+        return bucket;
+    }
+    const size_t msb = bucket / subBucketCount + subBucketBits - 1;
+    return (subBucketCount + bucket % subBucketCount) << (msb - subBucketBits);
+}
+
+void recordRequest(const CommandKey& key)
+{
+    getCounters(key).requests++;
+}
+
+void recordRetry(const CommandKey& key)
+{
+    getCounters(key).retries++;
+}
+
+void recordTimeout(const CommandKey& key)
+{
+    getCounters(key).timeouts++;
+}
+
+void recordInvalidResponse(const CommandKey& key)
+{
+    getCounters(key).invalidResponses++;
+}
+
+void recordSent(const CommandKey& key,
+                const std::chrono::steady_clock::duration latency)
+{
+    CommandCounters& counters = getCounters(key);
+    const auto latencyUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(latency)
+            .count());
+    counters.latencySum += latencyUs;
+    counters.latency[getLatencyBucket(latencyUs)]++;
+}
+
+void recordResponse(const CommandKey& key,
+                    const std::chrono::steady_clock::duration latency,
+                    const std::vector<uint8_t>& pldmResp)
+{
+    recordSent(key, latency);
+    constexpr size_t completionCodeIndex = sizeof(pldm_msg_hdr);
+    if (pldmResp.size() > completionCodeIndex &&
+        pldmResp[completionCodeIndex] != PLDM_SUCCESS)
+    {
+        getCounters(key).ccErrors++;
+    }
+}
+
+static std::vector<CommandStatistics> getCommandStatistics()
+{
+    std::vector<CommandStatistics> statistics;
+    statistics.reserve(commandCounters.size());
+    for (const auto& [key, counters] : commandCounters)
+    {
+        // Trailing empty buckets are left out
+        auto last = std::find_if(counters.latency.rbegin(),
+                                 counters.latency.rend(),
+                                 [](const uint64_t count) { return count; });
+        statistics.emplace_back(
+            static_cast<pldm_tid_t>(key >> 16), static_cast<uint8_t>(key >> 8),
+            static_cast<uint8_t>(key), counters.requests, counters.retries,
+            counters.timeouts, counters.ccErrors, counters.invalidResponses,
+            counters.latencySum,
+            std::vector<uint64_t>(counters.latency.begin(), last.base()));
+    }
+    return statistics;
+}
+
+void initializeStatisticsIntf()
+{
+    static std::unique_ptr<sdbusplus::asio::dbus_interface> statsInterface =
+        nullptr;
+    if (statsInterface != nullptr)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "statsInterface already initialized");
+        return;
+    }
+
+    const char* objPath = "/xyz/openbmc_project/pldm";
+    statsInterface =
+        addUniqueInterface(objPath, "xyz.openbmc_project.PLDM.Statistics");
+    // Returns TID, PLDM type, command, requests, retries, timeouts, completion
+    // code errors, invalid responses, latency sum(us) and latency histogram of
+    // every command
+    statsInterface->register_method("GetCommandStatistics",
+                                    []() { return getCommandStatistics(); });
+    statsInterface->register_method("GetLatencyBuckets", []() {
+        std::vector<uint64_t> lowerBounds(latencyBucketCount);
+        for (size_t bucket = 0; bucket < latencyBucketCount; bucket++)
+        {
+            lowerBounds[bucket] = getLatencyBucketLowerBound(bucket);
+        }
+        return lowerBounds;
+    });
+    statsInterface->register_method("Reset",
+                                    []() { commandCounters.clear(); });
+    statsInterface->initialize();
+}
+} // namespace stats
+} // namespace pldm
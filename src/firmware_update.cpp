@@ -15,6 +15,8 @@
  */
 #include "firmware_update.hpp"
 
+#include "base_cache.hpp"
+#include "fwu_checkpoint.hpp"
 #include "fwu_inventory.hpp"
 #include "platform.hpp"
 #include "pldm.hpp"
@@ -60,6 +62,7 @@ using FWUBase = sdbusplus::xyz::openbmc_project::PLDM::FWU::server::FWUBase;
 extern std::map<pldm_tid_t, FDProperties> terminusFwuProperties;
 std::shared_ptr<boost::asio::steady_timer> expectedCommandTimer = nullptr;
 std::unique_ptr<PLDMImg> pldmImg = nullptr;
+std::unique_ptr<UpdateCheckpoint> updateCheckpoint = nullptr;
 std::unique_ptr<FWUpdate> fwUpdate = nullptr;
 std::unique_ptr<sdbusplus::asio::dbus_interface> associationsIntf = nullptr;
 std::map<uint8_t, std::string> inventoryPaths;
@@ -67,7 +70,8 @@ std::map<uint8_t, std::string> inventoryPaths;
 FWUpdate::FWUpdate(const pldm_tid_t _tid, const uint8_t _deviceIDRecord) :
     reserveBWTimer(
         std::make_unique<boost::asio::steady_timer>(*getIoContext())),
-    currentTid(_tid), currentDeviceIDRecord(_deviceIDRecord), state(FD_IDLE)
+    currentTid(_tid), currentDeviceIDRecord(_deviceIDRecord),
+    currentUUID(base::getTerminusUUID(_tid)), state(FD_IDLE)
 {
 }
 
@@ -194,37 +198,24 @@ uint16_t FWUpdate::getApplicableComponentsCount(uint64_t val) const
 
 bool FWUpdate::prepareRequestUpdateCommand()
 {
-    uint16_t tempShort = 0;
     updateProperties.max_transfer_size = PLDM_FWU_BASELINE_TRANSFER_SIZE;
     applicableComponentsVal = getApplicableComponents();
     updateProperties.no_of_comp =
         getApplicableComponentsCount(applicableComponentsVal);
     updateProperties.max_outstand_transfer_req = 1;
-    if (!pldmImg->getDevIdRcrdProperty<uint16_t>(tempShort, "FWDevPkgDataLen",
-                                                 currentDeviceIDRecord))
-    {
-        return false;
-    }
-    updateProperties.pkg_data_len = tempShort;
-    if (!pldmImg->getDevIdRcrdProperty<uint8_t>(
-            updateProperties.comp_image_set_ver_str_len, "ComImgSetVerStrLen",
-            currentDeviceIDRecord))
-    {
-        return false;
-    }
-    if (!pldmImg->getDevIdRcrdProperty<uint8_t>(
-            updateProperties.comp_image_set_ver_str_type, "ComImgSetVerStrType",
-            currentDeviceIDRecord))
-    {
-        return false;
-    }
-
-    if (!pldmImg->getDevIdRcrdProperty<std::string>(
-            componentImageSetVersionString, "CompImgSetVerStr",
-            currentDeviceIDRecord))
+    const FWDevIdRecord* devIdRecord =
+        pldmImg->getDevIdRecord(currentDeviceIDRecord);
+    if (!devIdRecord)
     {
         return false;
     }
+    updateProperties.pkg_data_len = le16toh(devIdRecord->fwDevPkgDataLen);
+    updateProperties.comp_image_set_ver_str_len =
+        devIdRecord->comImgSetVerStrLen;
+    updateProperties.comp_image_set_ver_str_type =
+        devIdRecord->comImgSetVerStrType;
+    componentImageSetVersionString =
+        pldmImg->getCompImgSetVerStr(currentDeviceIDRecord);
     return true;
 }
 
@@ -232,43 +223,20 @@ bool FWUpdate::preparePassComponentRequest(
     struct pass_component_table_req& componentTable,
     std::string& compVersionString, const uint16_t compCnt)
 {
-    uint16_t tempShort = 0;
-    uint32_t tempLong = 0;
-
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompClassification",
-                                            compCnt))
+    const CompImgInfo* compInfo = pldmImg->getCompImgInfo(compCnt);
+    if (!compInfo)
     {
         return false;
     }
-    componentTable.comp_classification = tempShort;
+    componentTable.comp_classification =
+        le16toh(compInfo->compClassification);
     componentTable.comp_classification_index = 0;
-    if (!pldmImg->getCompProperty<uint32_t>(tempLong, "CompComparisonStamp",
-                                            compCnt))
-    {
-        return false;
-    }
-    componentTable.comp_comparison_stamp = tempLong;
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompIdentifier",
-                                            compCnt))
-    {
-        return false;
-    }
-    componentTable.comp_identifier = tempShort;
-    if (!pldmImg->getCompProperty<uint8_t>(componentTable.comp_ver_str_len,
-                                           "CompVerStrLen", compCnt))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<uint8_t>(componentTable.comp_ver_str_type,
-                                           "CmpVerStrType", compCnt))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<std::string>(compVersionString, "CompVerStr",
-                                               compCnt))
-    {
-        return false;
-    }
+    componentTable.comp_comparison_stamp =
+        le32toh(compInfo->compComparisonStamp);
+    componentTable.comp_identifier = le16toh(compInfo->compIdentifier);
+    componentTable.comp_ver_str_len = compInfo->compVerStrLen;
+    componentTable.comp_ver_str_type = compInfo->compVerStrType;
+    compVersionString = pldmImg->getCompVerStr(compCnt);
     return initPassComponentTableTransferFlag(componentTable.transfer_flag);
 }
 
@@ -305,49 +273,20 @@ bool FWUpdate::initPassComponentTableTransferFlag(uint8_t& flag)
 bool FWUpdate::prepareUpdateComponentRequest(
     std::string& compVersionString, struct update_component_req& component)
 {
-    uint16_t tempShort = 0;
-    uint32_t tempLong = 0;
-
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompClassification",
-                                            currentComp))
+    const CompImgInfo* compInfo = pldmImg->getCompImgInfo(currentComp);
+    if (!compInfo)
     {
         return false;
     }
-    component.comp_classification = tempShort;
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompIdentifier",
-                                            currentComp))
-    {
-        return false;
-    }
-    component.comp_identifier = tempShort;
+    component.comp_classification = le16toh(compInfo->compClassification);
+    component.comp_identifier = le16toh(compInfo->compIdentifier);
     component.comp_classification_index = 0;
-    if (!pldmImg->getCompProperty<uint32_t>(tempLong, "CompComparisonStamp",
-                                            currentComp))
-    {
-        return false;
-    }
-    component.comp_comparison_stamp = tempLong;
-    if (!pldmImg->getCompProperty<uint32_t>(tempLong, "CompSize", currentComp))
-    {
-        return false;
-    }
-    component.comp_image_size = tempLong;
+    component.comp_comparison_stamp = le32toh(compInfo->compComparisonStamp);
+    component.comp_image_size = le32toh(compInfo->compSize);
     component.update_option_flags = {};
-    if (!pldmImg->getCompProperty<uint8_t>(component.comp_ver_str_type,
-                                           "CmpVerStrType", currentComp))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<uint8_t>(component.comp_ver_str_len,
-                                           "CompVerStrLen", currentComp))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<std::string>(compVersionString, "CompVerStr",
-                                               currentComp))
-    {
-        return false;
-    }
+    component.comp_ver_str_type = compInfo->compVerStrType;
+    component.comp_ver_str_len = compInfo->compVerStrLen;
+    compVersionString = pldmImg->getCompVerStr(currentComp);
     return true;
 }
 
@@ -558,18 +497,14 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
     transferHandle = 0; // Resetting transferHandle
     expectedCmd = PLDM_GET_META_DATA;
 
-    size_t offset = 0;
     int retVal = 0;
 
-    size_t length = PLDM_FWU_BASELINE_TRANSFER_SIZE; // max payload size
-
     // Calculate based on size of payload and maximum transfer size
     // Max number of requests including the requeries
     size_t maxNumReq = findMaxNumReq(fwDeviceMetaData.size());
-    // Max number of unique requests (excluding requeries)
-    size_t numExpectedRequests = calcMaxNumReq(fwDeviceMetaData.size());
 
-    std::set<uint32_t> recvdRequests;
+    FWUDataTransfer transfer(fwDeviceMetaData.size(),
+                             PLDM_FWU_BASELINE_TRANSFER_SIZE);
 
     if (maxNumReq == 0)
     {
@@ -588,7 +523,8 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
             break;
         }
 
-        retVal = sendMetaData(yield, offset, length, recvdRequests);
+        retVal = sendFDData(yield, PLDM_GET_META_DATA, fwDeviceMetaData,
+                            transfer);
         if (retVal != PLDM_SUCCESS)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -604,7 +540,7 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
         fdReqMatched = false;
 
         // Confirm if meta data is been transferred completely
-        if (recvdRequests.size() == numExpectedRequests)
+        if (transfer.isComplete())
         {
             phosphor::logging::log<phosphor::logging::level::INFO>(
                 "sendMetaData successful");
@@ -626,133 +562,6 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
     return retVal;
 }
 
-int FWUpdate::sendMetaData(const boost::asio::yield_context yield,
-                           size_t& offset, size_t& length,
-                           std::set<uint32_t>& recvdRequests)
-{
-
-    const struct pldm_msg* msgReq =
-        reinterpret_cast<const pldm_msg*>(fdReq.data());
-
-    uint32_t dataTransferHandle = 1;
-    uint8_t transferOperationFlag = PLDM_GET_FIRSTPART;
-
-    size_t dataSize = 0;
-
-    int retVal =
-        decode_get_meta_data_req(msgReq, sizeof(struct get_fd_data_req),
-                                 &dataTransferHandle, &transferOperationFlag);
-    if (retVal != PLDM_SUCCESS)
-    {
-
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("sendMetaData: decode request failed"
-             "RETVAL=" +
-             std::to_string(retVal))
-                .c_str());
-
-        if (!sendErrorCompletionCode(yield, msgReq->hdr.instance_id,
-                                     static_cast<uint8_t>(retVal),
-                                     PLDM_GET_META_DATA))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "sendMetaData: Failed to send PLDM message");
-        }
-        return retVal;
-    }
-    // GetFirstPart can be received in 2 cases
-    // 1. first request to start the data transfer
-    // 2. If the FD sends GetFirstPart in any upcoming request of the same
-    // command
-    // then we are supposed to start the transfer starting from
-    // start of the meta data again.
-    // In both the cases transfer should start from start of meta data.
-    if (transferOperationFlag == PLDM_GET_FIRSTPART)
-    {
-        offset = 0;
-        length = PLDM_FWU_BASELINE_TRANSFER_SIZE;
-        // Ignoring the very first dataTransferHandle received and setting it as
-        // 0.
-        recvdRequests.insert(0);
-    }
-    else
-    {
-        offset = dataTransferHandle * PLDM_FWU_BASELINE_TRANSFER_SIZE;
-        recvdRequests.insert(dataTransferHandle);
-    }
-
-    dataSize = fwDeviceMetaData.size();
-
-    // If dataSize is not multiple of max tranfer unit, last packet will have
-    // payload which is less that max transfer unit
-
-    if (offset + length > dataSize)
-    {
-        if (offset < dataSize)
-        {
-            length = dataSize -
-                     offset; // To calculate actual length depending on the what
-                             // data size  left and what offset position
-        }
-        else
-        {
-            if (!sendErrorCompletionCode(yield, msgReq->hdr.instance_id,
-                                         PLDM_ERROR, PLDM_GET_META_DATA))
-            {
-                phosphor::logging::log<phosphor::logging::level::ERR>(
-                    "sendMetaData: Failed to send PLDM message");
-            }
-            return PLDM_ERROR;
-        }
-    }
-
-    struct get_fd_data_resp dataHeader;
-    dataHeader.completion_code = PLDM_SUCCESS;
-    // Add a member variable and increment
-    dataHeader.next_data_transfer_handle = ++dataTransferHandle;
-
-    // Setting the Transfer flag that indiates what part of the transfer this
-    // response represents
-    dataHeader.transfer_flag = setTransferFlag(offset, length, dataSize);
-
-    // Set the Portion of Metadata using offset and length
-    struct variable_field portionOfData = {};
-
-    portionOfData.length = length;
-    portionOfData.ptr = fwDeviceMetaData.data() + offset;
-
-    offset += length;
-
-    /* header plus requested data length */
-    size_t respLen = sizeof(struct PLDMEmptyRequest) +
-                     sizeof(struct get_fd_data_resp) + length;
-
-    std::vector<uint8_t> pldmResp(respLen);
-    struct pldm_msg* msgResp = reinterpret_cast<pldm_msg*>(pldmResp.data());
-    retVal = encode_get_meta_data_resp(msgReq->hdr.instance_id, respLen,
-                                       msgResp, &dataHeader, &portionOfData);
-
-    if (retVal != PLDM_SUCCESS)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("sendMetaData: encode request failed"
-             "RETVAL=" +
-             std::to_string(retVal))
-                .c_str());
-        return retVal;
-    }
-
-    if (!sendPldmMessage(yield, currentTid, retryCount, msgTag, false,
-                         pldmResp))
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "sendMetaData: Failed to send PLDM message");
-        return PLDM_ERROR;
-    }
-
-    return PLDM_SUCCESS;
-}
-
 int FWUpdate::processPassComponentTable(const boost::asio::yield_context yield)
 {
     if (!updateMode)
@@ -1223,28 +1032,20 @@ int FWUpdate::processRequestFirmwareData(const boost::asio::yield_context yield)
     int prevProgress = 0;
     // Log interval for progess percentage
     constexpr int progressPercentLogLimit = 25;
-    uint32_t componentSize;
-    uint32_t componentOffset;
-    if (!pldmImg->getCompProperty<uint32_t>(componentSize, "CompSize",
-                                            currentComp))
+    const CompImgInfo* compInfo = pldmImg->getCompImgInfo(currentComp);
+    if (!compInfo)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
-            ("Failed to get component size. COMPONENT: " +
-             std::to_string(currentComp))
-                .c_str());
-        return PLDM_ERROR;
-    }
-    if (!pldmImg->getCompProperty<uint32_t>(componentOffset,
-                                            "CompLocationOffset", currentComp))
-    {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            ("Failed to get component location offset. COMPONENT: " +
+            ("Failed to get component image information. COMPONENT: " +
              std::to_string(currentComp))
                 .c_str());
         return PLDM_ERROR;
     }
+    const uint32_t componentSize = le32toh(compInfo->compSize);
+    const uint32_t componentOffset = le32toh(compInfo->compLocationOffset);
     uint32_t maxNumReq = findMaxNumReq(componentSize);
     initialize_fw_update(updateProperties.max_transfer_size, componentSize);
+    FWUDataTransfer transfer(componentSize, updateProperties.max_transfer_size);
 
     while (--maxNumReq)
     {
@@ -1265,7 +1066,7 @@ int FWUpdate::processRequestFirmwareData(const boost::asio::yield_context yield)
             break;
         }
         retVal = requestFirmwareData(yield, fdReq, offset, length,
-                                     componentSize, componentOffset);
+                                     componentSize, componentOffset, transfer);
         if (retVal != PLDM_SUCCESS)
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
@@ -1309,7 +1110,8 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
                                   const std ::vector<uint8_t>& pldmReq,
                                   uint32_t& offset, uint32_t& length,
                                   const uint32_t componentSize,
-                                  const uint32_t componentOffset)
+                                  const uint32_t componentOffset,
+                                  FWUDataTransfer& transfer)
 {
     const struct pldm_msg* msgReq =
         reinterpret_cast<const pldm_msg*>(pldmReq.data());
@@ -1334,9 +1136,8 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
 
     /* completion code plus requested data length */
     size_t payload_length = 1 + length;
+    const size_t requestedLength = length;
 
-    std::vector<uint8_t> pldmResp(PLDMCCOnlyResponse + length);
-    std ::vector<uint8_t> data(length);
     if (offset + length > componentSize)
     {
         if (offset < componentSize)
@@ -1357,6 +1158,26 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
         }
     }
 
+    std::vector<uint8_t>* cachedResp =
+        transfer.getResponse(offset, requestedLength);
+    if (cachedResp)
+    {
+        // Duplicate or retried request, only the instance ID differs
+        reinterpret_cast<pldm_msg*>(cachedResp->data())->hdr.instance_id =
+            msgReq->hdr.instance_id;
+        if (!sendPldmMessage(yield, currentTid, retryCount, msgTag, false,
+                             *cachedResp))
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "requestFirmwareData: Failed to send PLDM message",
+                phosphor::logging::entry("TID=%d", currentTid));
+            return PLDM_ERROR;
+        }
+        return PLDM_SUCCESS;
+    }
+
+    std::vector<uint8_t> pldmResp(PLDMCCOnlyResponse + requestedLength);
+    std ::vector<uint8_t> data(requestedLength);
     if (!pldmImg->readData(offset + componentOffset, data, length))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -1390,8 +1211,9 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
     }
 
     // tag Owner bit cleared to false for respose message
-    if (!sendPldmMessage(yield, currentTid, retryCount, msgTag, false,
-                         pldmResp))
+    if (!sendPldmMessage(
+            yield, currentTid, retryCount, msgTag, false,
+            transfer.addResponse(offset, requestedLength, std::move(pldmResp))))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "requestFirmwareData: Failed to send PLDM message",
@@ -1402,23 +1224,6 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
     return PLDM_SUCCESS;
 }
 
-size_t FWUpdate::calcMaxNumReq(const size_t dataSize)
-{
-    if (!dataSize)
-    {
-        return 0;
-    }
-
-    size_t maxNumReq = dataSize / PLDM_FWU_BASELINE_TRANSFER_SIZE;
-
-    if (dataSize % PLDM_FWU_BASELINE_TRANSFER_SIZE > 0)
-    {
-        maxNumReq = maxNumReq + 1;
-    }
-
-    return maxNumReq;
-}
-
 int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
 {
     if (fdState != FD_LEARN_COMPONENTS || !updateMode)
@@ -1434,9 +1239,9 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
     }
 
     // get package data from pldmImg
-    if (!pldmImg->getDevIdRcrdProperty<std::vector<uint8_t>>(
-            packageData, "FirmwareDevicePackageData", currentDeviceIDRecord) ||
-        !packageData.size())
+    auto fwDevPkgData = pldmImg->getFWDevPkgData(currentDeviceIDRecord);
+    packageData.assign(fwDevPkgData.begin(), fwDevPkgData.end());
+    if (!packageData.size())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to get FirmwareDevicePackageData or packageData size is 0");
@@ -1444,18 +1249,14 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
     }
     expectedCmd = PLDM_GET_PACKAGE_DATA;
 
-    size_t offset = 0;
     int retVal = 0;
-    size_t length = PLDM_FWU_BASELINE_TRANSFER_SIZE; // max payload size
     const size_t dataSize = packageData.size();
 
     // Calculate based on size of payload and maximum transfer size
     // Max number of requests including the requeries
     size_t maxNumReq = findMaxNumReq(dataSize);
-    // Max number of unique requests (excluding requeries)
-    size_t numExpectedRequests = calcMaxNumReq(dataSize);
 
-    std::set<uint32_t> recvdRequests;
+    FWUDataTransfer transfer(dataSize, PLDM_FWU_BASELINE_TRANSFER_SIZE);
 
     while (maxNumReq--)
     {
@@ -1467,7 +1268,8 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
             break;
         }
 
-        retVal = sendPackageData(yield, offset, length, recvdRequests);
+        retVal =
+            sendFDData(yield, PLDM_GET_PACKAGE_DATA, packageData, transfer);
         if (retVal != PLDM_SUCCESS)
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
@@ -1483,7 +1285,7 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
         fdReqMatched = false;
 
         // Confirm if complete package data is been transferred
-        if (recvdRequests.size() == numExpectedRequests)
+        if (transfer.isComplete())
         {
             phosphor::logging::log<phosphor::logging::level::INFO>(
                 "sendPackageData successful");
@@ -1503,35 +1305,42 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
     return retVal;
 }
 
-int FWUpdate::sendPackageData(const boost::asio::yield_context yield,
-                              size_t& offset, size_t& length,
-                              std::set<uint32_t>& recvdRequests)
+int FWUpdate::sendFDData(const boost::asio::yield_context yield,
+                         const uint8_t command,
+                         const std::vector<uint8_t>& data,
+                         FWUDataTransfer& transfer)
 {
-    uint32_t dataTransferHandle = 1;
+    uint32_t dataTransferHandle = 0;
     uint8_t transferOperationFlag = PLDM_GET_FIRSTPART;
-    size_t dataSize = 0;
 
     const struct pldm_msg* msgReq =
         reinterpret_cast<const pldm_msg*>(fdReq.data());
 
-    int retVal = decode_get_pacakge_data_req(
-        msgReq, sizeof(struct get_fd_data_req), &dataTransferHandle,
-        &transferOperationFlag);
-
+    int retVal = PLDM_ERROR;
+    if (command == PLDM_GET_PACKAGE_DATA)
+    {
+        retVal = decode_get_pacakge_data_req(
+            msgReq, sizeof(struct get_fd_data_req), &dataTransferHandle,
+            &transferOperationFlag);
+    }
+    else
+    {
+        retVal = decode_get_meta_data_req(
+            msgReq, sizeof(struct get_fd_data_req), &dataTransferHandle,
+            &transferOperationFlag);
+    }
     if (retVal != PLDM_SUCCESS)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("sendPackageData: decode request failed"
-             "RETVAL=" +
-             std::to_string(retVal))
-                .c_str());
+            "sendFDData: decode request failed",
+            phosphor::logging::entry("COMMAND=%d", command),
+            phosphor::logging::entry("RETVAL=%d", retVal));
 
         if (!sendErrorCompletionCode(yield, msgReq->hdr.instance_id,
-                                     static_cast<uint8_t>(retVal),
-                                     PLDM_GET_PACKAGE_DATA))
+                                     static_cast<uint8_t>(retVal), command))
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
-                "sendPackageData: Failed to send PLDM message");
+                "sendFDData: Failed to send PLDM message");
         }
         return retVal;
     }
@@ -1540,85 +1349,88 @@ int FWUpdate::sendPackageData(const boost::asio::yield_context yield,
     // 2. If the FD sends GetFirstPart in any upcoming request of the same
     // command
     //   then we are supposed to start the transfer starting from
-    //   start of the package data again.
-    // In both the cases transfer should start from start of the package data.
+    //   start of the data again.
+    // In both the cases transfer should start from start of the data and the
+    // received dataTransferHandle is ignored.
     if (transferOperationFlag == PLDM_GET_FIRSTPART)
     {
-        offset = 0;
-        length = PLDM_FWU_BASELINE_TRANSFER_SIZE;
-        // Ignoring the very first dataTransferHandle received and setting it as
-        // 0.
-        recvdRequests.insert(0);
+        dataTransferHandle = 0;
     }
-    else
+    const size_t offset = static_cast<size_t>(dataTransferHandle) *
+                          PLDM_FWU_BASELINE_TRANSFER_SIZE;
+    if (offset >= data.size())
     {
-        offset = dataTransferHandle * PLDM_FWU_BASELINE_TRANSFER_SIZE;
-        recvdRequests.insert(dataTransferHandle);
-    }
-
-    dataSize = packageData.size();
-
-    // If dataSize is not multiple of max transfer unit, last packet will have
-    // payload which is less that max transfer unit
-    if (offset + length > dataSize)
-    {
-        if (offset < dataSize)
-        {
-            length = dataSize - offset; // To calculate actual length depending
-                                        // on the data size and offset
-        }
-        else
+        if (!sendErrorCompletionCode(yield, msgReq->hdr.instance_id,
+                                     PLDM_ERROR, command))
         {
-            if (!sendErrorCompletionCode(yield, msgReq->hdr.instance_id,
-                                         PLDM_ERROR, PLDM_GET_PACKAGE_DATA))
-            {
-                phosphor::logging::log<phosphor::logging::level::ERR>(
-                    ("sendPackageData: Failed to send PLDM message"));
-            }
-            return PLDM_ERROR;
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "sendFDData: Failed to send PLDM message");
         }
+        return PLDM_ERROR;
     }
+    // If data size is not multiple of max transfer unit, last packet will have
+    // payload which is less that max transfer unit
+    const size_t length = std::min(
+        static_cast<size_t>(PLDM_FWU_BASELINE_TRANSFER_SIZE),
+        data.size() - offset);
 
-    struct get_fd_data_resp dataHeader;
-    dataHeader.completion_code = PLDM_SUCCESS;
-    dataHeader.next_data_transfer_handle = ++dataTransferHandle;
-
-    // Setting the Transfer flag that indiates what part of the transfer this
-    // response represents
-    dataHeader.transfer_flag = setTransferFlag(offset, length, dataSize);
-
-    struct variable_field portionOfData = {};
-    portionOfData.length = length;
-    portionOfData.ptr = packageData.data() + offset;
+    std::vector<uint8_t>* pldmResp = transfer.getResponse(offset, length);
+    if (pldmResp)
+    {
+        // Duplicate or retried request, only the instance ID differs
+        reinterpret_cast<pldm_msg*>(pldmResp->data())->hdr.instance_id =
+            msgReq->hdr.instance_id;
+    }
+    else
+    {
+        struct get_fd_data_resp dataHeader;
+        dataHeader.completion_code = PLDM_SUCCESS;
+        dataHeader.next_data_transfer_handle = dataTransferHandle + 1;
 
-    // Set the Portion of Metadata using offset and length
-    offset = offset + length;
+        // Setting the Transfer flag that indiates what part of the transfer
+        // this response represents
+        dataHeader.transfer_flag = setTransferFlag(offset, length, data.size());
 
-    // header plus requested data length
-    size_t respLen = sizeof(struct PLDMEmptyRequest) +
-                     sizeof(struct get_fd_data_resp) + length;
+        struct variable_field portionOfData = {};
+        portionOfData.length = length;
+        portionOfData.ptr = data.data() + offset;
 
-    std::vector<uint8_t> pldmResp(respLen);
-    struct pldm_msg* msgResp = reinterpret_cast<pldm_msg*>(pldmResp.data());
-    retVal = encode_get_package_data_resp(msgReq->hdr.instance_id, respLen,
-                                          msgResp, &dataHeader, &portionOfData);
+        // header plus requested data length
+        size_t respLen = sizeof(struct PLDMEmptyRequest) +
+                         sizeof(struct get_fd_data_resp) + length;
 
-    if (retVal != PLDM_SUCCESS)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("sendPackageData: encode request failed"
-             "RETVAL=" +
-             std::to_string(retVal))
-                .c_str());
-        return retVal;
+        std::vector<uint8_t> resp(respLen);
+        struct pldm_msg* msgResp = reinterpret_cast<pldm_msg*>(resp.data());
+        if (command == PLDM_GET_PACKAGE_DATA)
+        {
+            retVal = encode_get_package_data_resp(msgReq->hdr.instance_id,
+                                                  respLen, msgResp,
+                                                  &dataHeader, &portionOfData);
+        }
+        else
+        {
+            retVal = encode_get_meta_data_resp(msgReq->hdr.instance_id,
+                                               respLen, msgResp, &dataHeader,
+                                               &portionOfData);
+        }
+        if (retVal != PLDM_SUCCESS)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "sendFDData: encode response failed",
+                phosphor::logging::entry("COMMAND=%d", command),
+                phosphor::logging::entry("RETVAL=%d", retVal));
+            return retVal;
+        }
+        pldmResp = &transfer.addResponse(offset, length, std::move(resp));
     }
 
     // tag Owner bit cleared to false for respose message
     if (!sendPldmMessage(yield, currentTid, retryCount, msgTag, false,
-                         pldmResp))
+                         *pldmResp))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("sendPackageData: Failed to send PLDM message"));
+            "sendFDData: Failed to send PLDM message",
+            phosphor::logging::entry("COMMAND=%d", command));
         return PLDM_ERROR;
     }
 
@@ -1880,10 +1692,9 @@ int FWUpdate::cancelUpdate(const boost::asio::yield_context yield,
 
 uint64_t FWUpdate::getApplicableComponents()
 {
-    std::vector<uint8_t> applicableComp;
     uint64_t value = 0;
-    pldmImg->getDevIdRcrdProperty(applicableComp, "ApplicableComponents",
-                                  currentDeviceIDRecord);
+    auto applicableComp =
+        pldmImg->getApplicableComponents(currentDeviceIDRecord);
     int byteCount = 0;
     for (auto byte : applicableComp)
     {
@@ -1904,6 +1715,12 @@ bool FWUpdate::isComponentApplicable()
     return (applicableComponentsVal >> currentComp) & 1;
 }
 
+bool FWUpdate::isComponentCompleted()
+{
+    return currentComp < maxCheckpointComponents &&
+           ((completedComponentsVal >> currentComp) & 1);
+}
+
 constexpr uint32_t convertSecondsToMilliseconds(const uint16_t seconds)
 {
     return (seconds * 1000);
@@ -2003,11 +1820,75 @@ struct SelfContainedActivationCache
     std::unordered_map<pldm_tid_t, Device> cache{};
 };
 
-int FWUpdate::runUpdate(
-    const boost::asio::yield_context yield,
-    SelfContainedActivationCache& selfContainedActivationCache)
+bool FWUpdate::resumeFromCheckpoint(const boost::asio::yield_context yield)
+{
+    if (!currentUUID ||
+        !updateCheckpoint->hasSession(*currentUUID, currentDeviceIDRecord))
+    {
+        return false;
+    }
+    completedComponentsVal = updateCheckpoint->getCompletedComponents(
+        *currentUUID, currentDeviceIDRecord);
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "Found interrupted firmware update",
+        phosphor::logging::entry("TID=%d", currentTid),
+        phosphor::logging::entry("COMPLETED_COMPONENTS=0x%llX",
+                                 static_cast<unsigned long long>(
+                                     completedComponentsVal)));
+
+    // Applied components are only activated by an ActivateFirmware within the
+    // same update session. Continue the earlier session if FD still holds it.
+    int retVal = getStatus(yield);
+    if (retVal == PLDM_SUCCESS)
+    {
+        if (cancelUpdateComponentState.count(currentState) &&
+            cancelUpdateComponent(yield) == PLDM_SUCCESS)
+        {
+            // The interrupted component is transferred again
+            currentState = FD_READY_XFER;
+        }
+        if (currentState == FD_READY_XFER && prepareRequestUpdateCommand())
+        {
+            // Device metadata of the earlier session is lost, SendMetaData
+            // is skipped for the continued session
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                ("Continuing the interrupted update session for TID: " +
+                 std::to_string(currentTid))
+                    .c_str());
+            updateMode = true;
+            fdState = FD_READY_XFER;
+            activateReserveBandwidth();
+            return true;
+        }
+    }
+
+    if (retVal != PLDM_SUCCESS || currentState != FD_IDLE)
+    {
+        bool8_t nonFunctioningComponentIndication = false;
+        bitfield64_t nonFunctioningComponentBitmap = {};
+        if (cancelUpdate(yield, nonFunctioningComponentIndication,
+                         nonFunctioningComponentBitmap) == PLDM_SUCCESS)
+        {
+            createAsyncDelay(yield, delayBtw);
+        }
+        else
+        {
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                ("No stale update session to cancel for TID: " +
+                 std::to_string(currentTid))
+                    .c_str());
+        }
+    }
+    // Components applied in the earlier session will never be activated,
+    // transfer all of them again in a new session
+    completedComponentsVal = 0;
+    updateCheckpoint->clearComponents(*currentUUID, currentDeviceIDRecord,
+                                      std::numeric_limits<uint64_t>::max());
+    return false;
+}
+
+int FWUpdate::startUpdateSession(const boost::asio::yield_context yield)
 {
-    compCount = pldmImg->getTotalCompCount();
     int retVal = processRequestUpdate(yield);
     if (retVal != PLDM_SUCCESS)
     {
@@ -2018,6 +1899,10 @@ int FWUpdate::runUpdate(
     phosphor::logging::log<phosphor::logging::level::INFO>(
         "RequestUpdate command is success");
     updateMode = true;
+    if (currentUUID)
+    {
+        updateCheckpoint->beginSession(*currentUUID, currentDeviceIDRecord);
+    }
     fdState = FD_LEARN_COMPONENTS;
     phosphor::logging::log<phosphor::logging::level::INFO>(
         "FD changed state to LEARN COMPONENTS");
@@ -2053,6 +1938,45 @@ int FWUpdate::runUpdate(
     fdState = FD_READY_XFER;
     phosphor::logging::log<phosphor::logging::level::INFO>(
         "FD changed state to READY XFER");
+    return PLDM_SUCCESS;
+}
+
+int FWUpdate::runUpdate(
+    const boost::asio::yield_context yield,
+    SelfContainedActivationCache& selfContainedActivationCache)
+{
+    compCount = pldmImg->getTotalCompCount();
+#ifdef FWU_VERIFY_COMPONENT_IMAGES
+    // Updating every FD may take long, catch the package being modified or
+    // corrupted on storage after StartFWUpdate
+    if (!runOnWorker(yield, [img = pldmImg.get(), count = compCount,
+                             applicable = getApplicableComponents()]() {
+            for (uint16_t comp = 0;
+                 comp < count && comp < std::numeric_limits<uint64_t>::digits;
+                 comp++)
+            {
+                if (((applicable >> comp) & 1) && !img->verifyCompImage(comp))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "runUpdate: Component image verification failed");
+        return PLDM_ERROR;
+    }
+#endif
+    int retVal = PLDM_SUCCESS;
+    if (!resumeFromCheckpoint(yield))
+    {
+        retVal = startUpdateSession(yield);
+        if (retVal != PLDM_SUCCESS)
+        {
+            return retVal;
+        }
+    }
 
     for (uint16_t count = 0; count < compCount; ++count)
     {
@@ -2068,6 +1992,16 @@ int FWUpdate::runUpdate(
             compUpdateProgress(yield);
             continue;
         }
+        if (isComponentCompleted())
+        {
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                ("COMPONENT: " + std::to_string(count) +
+                 " already applied in an earlier session, skipping")
+                    .c_str());
+            isComponentAvailableForUpdate = true;
+            compUpdateProgress(yield);
+            continue;
+        }
 
         retVal = processUpdateComponent(
             yield, compCompatabilityResp, compCompatabilityRespCode,
@@ -2228,6 +2162,11 @@ int FWUpdate::runUpdate(
             continue;
         }
         isComponentAvailableForUpdate = true;
+        if (currentUUID)
+        {
+            updateCheckpoint->markComponentComplete(
+                *currentUUID, currentDeviceIDRecord, count);
+        }
         phosphor::logging::log<phosphor::logging::level::INFO>(
             ("ApplyComplete command is success. COMPONENT: " +
              std::to_string(count))
@@ -2293,6 +2232,14 @@ int FWUpdate::runUpdate(
             .c_str());
     selfContainedActivationCache.updateTime(
         currentTid, retVal, estimatedTimeForSelfContainedActivation);
+    if (currentUUID)
+    {
+        // New firmware may support other PLDM versions and commands
+        base::removeCachedCommandSupportTable(*currentUUID);
+        updateCheckpoint->markActivated(
+            *currentUUID, currentDeviceIDRecord, retVal,
+            estimatedTimeForSelfContainedActivation);
+    }
 
     return PLDM_SUCCESS;
 }
@@ -2439,6 +2386,22 @@ static int initUpdate(const boost::asio::yield_context yield)
         pldm_tid_t matchedTid = it.second;
         uint8_t matchedDevIdRecord = it.first;
         fwUpdate = std::make_unique<FWUpdate>(matchedTid, matchedDevIdRecord);
+        std::optional<UUID> uuid = base::getTerminusUUID(matchedTid);
+        if (const FWUCheckpointDevice* activatedDevice =
+                uuid ? updateCheckpoint->getActivatedDevice(*uuid,
+                                                            matchedDevIdRecord)
+                     : nullptr)
+        {
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                ("initUpdate: Firmware already activated in an earlier "
+                 "session for TID: " +
+                 std::to_string(matchedTid))
+                    .c_str());
+            selfContainedActivationCache.updateTime(
+                matchedTid, activatedDevice->updateStatus,
+                activatedDevice->estimatedTimeForSelfContainedActivation);
+            continue;
+        }
         if (!fwUpdate->setMatchedFDDescriptors())
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -2477,6 +2440,11 @@ static int initUpdate(const boost::asio::yield_context yield)
     }
 
     pldm::platform::resumeSensorPolling();
+    if (fwUpdateStatus)
+    {
+        // Whole package is applied. Nothing left to resume.
+        updateCheckpoint->remove();
+    }
     if (!fwUpdateStatus)
     {
         fwUpdate->updateFWUProperty(
@@ -2501,7 +2469,8 @@ static void initializeFWUBase()
     auto objServer = getObjServer();
     auto fwuBaseIface = objServer->add_interface(objPath, FWUBase::interface);
     fwuBaseIface->register_method(
-        "StartFWUpdate", [](const std::string filePath) {
+        "StartFWUpdate",
+        [](boost::asio::yield_context yield, const std::string filePath) {
             int rc = -1;
             if (pldmImg)
             {
@@ -2512,15 +2481,28 @@ static void initializeFWUBase()
             try
             {
                 pldmImg = std::make_unique<PLDMImg>(filePath);
-                if (!pldmImg->processPkgHdr())
+                if (!pldmImg->processPkgHdr(yield))
                 {
                     phosphor::logging::log<phosphor::logging::level::ERR>(
                         "processPkgHdr: Failed");
+                    pldmImg = nullptr;
+                    return rc;
                 }
-                else
+                // The checkpoint is bound to the whole package, reading it
+                // only touches the image
+                if (!runOnWorker(yield, [img = pldmImg.get()]() {
+                        return img->computePkgChecksum();
+                    }))
                 {
-                    rc = 0;
+                    phosphor::logging::log<phosphor::logging::level::ERR>(
+                        "computePkgChecksum: Failed");
+                    pldmImg = nullptr;
+                    return rc;
                 }
+                updateCheckpoint = std::make_unique<UpdateCheckpoint>(
+                    pldmImg->getPkgChecksum(), pldmImg->getImagesize());
+                updateCheckpoint->load();
+                rc = 0;
             }
             catch (const std::exception&)
             {
@@ -2530,14 +2512,15 @@ static void initializeFWUBase()
                                              filePath.c_str()));
                 return rc;
             }
-            boost::asio::spawn([](boost::asio::yield_context yield) {
-                int ret = initUpdate(yield);
+            boost::asio::spawn([](boost::asio::yield_context yieldCtx) {
+                int ret = initUpdate(yieldCtx);
                 if (ret != PLDM_SUCCESS)
                 {
                     phosphor::logging::log<phosphor::logging::level::ERR>(
                         "StartFWUpdate: initUpdate failed.");
                 }
                 pldmImg = nullptr;
+                updateCheckpoint = nullptr;
             });
             return rc;
         });
@@ -15,8 +15,14 @@
  */
 #include "fru.hpp"
 
+#include "base.hpp"
+#include "fru_cache.hpp"
 #include "fru_support.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
 #include <string>
 #include <xyz/openbmc_project/Inventory/Source/PLDM/FRU/server.hpp>
 
@@ -35,7 +41,7 @@ std::shared_ptr<sdbusplus::asio::dbus_interface> getFRUIface;
 std::vector<std::shared_ptr<sdbusplus::asio::dbus_interface>> fruInterface;
 
 static std::map<pldm_tid_t, FRUMetadata> terminusFRUMetadata;
-static std::map<pldm_tid_t, FRUProperties> terminusFRUProperties;
+static std::map<pldm_tid_t, FRURecord> terminusFRURecords;
 
 // Fru record data is saved in byte format as it is received. This data is
 // used by GetPldmFRU method
@@ -44,6 +50,11 @@ static FRUData fruData;
 
 constexpr size_t pldmHdrSize = sizeof(pldm_msg_hdr);
 constexpr size_t pldmFruBaselineTransferSize = 32;
+// SetFRURecordTable starts with the largest portion and halves it down to the
+// baseline while the terminus rejects the length
+constexpr size_t pldmFruMaxTransferSize = 1024;
+// Largest SetFRURecordTable portion accepted by each terminus
+static std::unordered_map<pldm_tid_t, size_t> setFRUTransferSize;
 
 // IpmiFru object is used to convert PLDM FRU to IPMI Format
 IpmiFru ipmiFru;
@@ -52,116 +63,237 @@ IpmiFru ipmiFru;
 RedfishFru redfishFru;
 #endif
 
-std::optional<FRUProperties> getProperties(const pldm_tid_t tid)
+static std::string fruFieldParserString(const uint8_t* value, uint8_t length)
 {
-    auto it = terminusFRUProperties.find(tid);
-    if (it != terminusFRUProperties.end())
+    if (length < 1)
     {
-        return it->second;
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid FRU field length");
+        return std::string("");
     }
-    return std::nullopt;
+    std::string strVal(reinterpret_cast<const char*>(value), length);
+    // non printable characters cause sdbusplus exceptions, so better to
+    // handle it by replacing with space
+    std::replace_if(
+        strVal.begin(), strVal.end(),
+        [](const char& c) { return !isprint(c); }, ' ');
+    return strVal;
 }
 
-bool PLDMFRUTable::parseFRUField(uint8_t recordType, uint8_t type,
-                                 uint8_t length, const uint8_t* value)
+static std::string convertTStamp104ToCIMFormat(const timestamp104_t& fruStamp)
 {
-    if (value == NULL)
+    std::stringstream timeStampStr;
+
+    enum CIMTimeStampVarLength
     {
-        return false;
+        width2 = 2,
+        width3 = 3,
+        width4 = 4,
+        width6 = 6,
+    };
+
+    if (!((fruStamp.year >= 1980 && fruStamp.year <= 9999) &&
+          (fruStamp.month >= 1 && fruStamp.month <= 12) &&
+          (fruStamp.day >= 1 && fruStamp.day <= 31) && (fruStamp.hour < 24) &&
+          (fruStamp.minute < 60) && (fruStamp.second < 60) &&
+          ((fruStamp.microsecond >= 0) && (fruStamp.microsecond <= 999999)) &&
+          (fruStamp.utc_offset >= -999 && fruStamp.utc_offset <= 999)))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "TimeStamp is not valid");
+        return timeStampStr.str();
     }
-    try
+    // handle CIM conversions and UTC offset
+    timeStampStr << std::setfill('0') << std::setw(width4) << fruStamp.year
+                 << std::setfill('0') << std::setw(width2)
+                 << static_cast<int>(fruStamp.month) << std::setfill('0')
+                 << std::setw(width2) << static_cast<int>(fruStamp.day)
+                 << std::setfill('0') << std::setw(width2)
+                 << static_cast<int>(fruStamp.hour) << std::setfill('0')
+                 << std::setw(width2) << static_cast<int>(fruStamp.minute)
+                 << std::setfill('0') << std::setw(width2)
+                 << static_cast<int>(fruStamp.second) << "."
+                 << std::setfill('0') << std::setw(width6)
+                 << fruStamp.microsecond;
+    if (fruStamp.utc_offset >= 0)
     {
-        auto& [typeString, parser] = fruFieldTypes.at(recordType).at(type);
-        fruProperties[typeString] = parser(value, length);
+        timeStampStr << "+";
     }
-    catch (const std::out_of_range& e)
+    else
     {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "fruFieldTypes key not available in map",
-            phosphor::logging::entry("TID=%d", tid));
-        return false;
+        timeStampStr << "-";
     }
+    timeStampStr << std::setfill('0') << std::setw(width3)
+                 << std::to_string(fruStamp.utc_offset);
 
-    return true;
+    return timeStampStr.str();
 }
 
-bool PLDMFRUTable::isTableEnd(const uint8_t* pTable)
+static std::string fruFieldParserTimestamp(const uint8_t* value,
+                                           uint8_t length)
 {
-    if (pTable == NULL)
+    if (length != timeStamp104Size)
     {
-        return false;
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid time stamp length");
+        return std::string("");
     }
-    constexpr size_t fixedFRUBytes = 7;
-    if (pTable < table.data())
+    timestamp104_t fruStamp;
+    std::memcpy(&fruStamp, value, timeStamp104Size);
+    return convertTStamp104ToCIMFormat(fruStamp);
+}
+
+static std::string fruFieldParserU32(const uint8_t* value, uint8_t length)
+{
+    if (length != sizeof(uint32_t))
     {
-        return false;
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Vendor IANA should be of length 4");
+        return std::string("");
+    }
+    uint32_t v;
+    std::memcpy(&v, value, sizeof(v));
+    return std::to_string(le32toh(v));
+}
+
+std::optional<std::string> getFieldValue(std::span<const uint8_t> table,
+                                         const FRURecord& record,
+                                         const uint8_t fieldType)
+{
+    if (fieldType >= record.fields.size())
+    {
+        return std::nullopt;
+    }
+    const FRUFieldRef& field = record.fields[fieldType];
+    if (field.offset == 0 ||
+        static_cast<size_t>(field.offset) + field.length > table.size())
+    {
+        return std::nullopt;
+    }
+    const uint8_t* value = table.data() + field.offset;
+    switch (fruFieldInfo[fieldType].format)
+    {
+        case FRUFieldFormat::string:
+            return fruFieldParserString(value, field.length);
+        case FRUFieldFormat::timestamp104:
+            return fruFieldParserTimestamp(value, field.length);
+        case FRUFieldFormat::uint32:
+            return fruFieldParserU32(value, field.length);
+        default:
+            return std::nullopt;
+    }
+}
+
+FRUProperties getDBusProperties(std::span<const uint8_t> table,
+                                const FRURecord& record)
+{
+    FRUProperties properties;
+    for (size_t fieldType = 0; fieldType < fruFieldInfo.size(); fieldType++)
+    {
+        if (auto value = getFieldValue(table, record,
+                                       static_cast<uint8_t>(fieldType)))
+        {
+            properties.emplace(fruFieldInfo[fieldType].name,
+                               std::move(value.value()));
+        }
+    }
+    return properties;
+}
+
+std::optional<FRUProperties> getProperties(const pldm_tid_t tid)
+{
+    auto it = terminusFRURecords.find(tid);
+    auto itData = fruData.find(tid);
+    if (it != terminusFRURecords.end() && itData != fruData.end())
+    {
+        return getDBusProperties(itData->second, it->second);
     }
-    auto offset = pTable - table.data();
-    return (table.size() - offset) <= fixedFRUBytes;
+    return std::nullopt;
 }
 
-std::optional<FRUProperties> PLDMFRUTable::parseTable()
+bool PLDMFRUTable::isTableEnd(const uint8_t* pTable)
 {
+    constexpr size_t fixedFRUBytes = 7;
+    auto offset = static_cast<size_t>(pTable - table.data());
+    return offset >= table.size() || (table.size() - offset) <= fixedFRUBytes;
+}
+
+std::optional<FRURecord> PLDMFRUTable::parseTable()
+{
+    constexpr size_t recordHeaderSize =
+        sizeof(pldm_fru_record_data_format) - sizeof(pldm_fru_record_tlv);
+    constexpr size_t tlvHeaderSize = sizeof(pldm_fru_record_tlv) - 1;
+
+    FRURecord fruRecord;
     const uint8_t* pTable = table.data();
+    const uint8_t* tableEnd = table.data() + table.size();
     while (!isTableEnd(pTable))
     {
         auto record =
             reinterpret_cast<const pldm_fru_record_data_format*>(pTable);
-        uint16_t recordSetID = le16toh(record->record_set_id);
-        std::string recordType =
-            typeToString(fruRecordTypes, record->record_type);
-        uint8_t fruFieldNum = static_cast<uint8_t>(record->num_fru_fields);
-        std::string encodeType =
-            typeToString(fruEncodingType, record->encoding_type);
-
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU Record Set Identifier",
-            phosphor::logging::entry("REC_SET_ID=%d", recordSetID));
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU Record Type",
-            phosphor::logging::entry("REC_TYPE=%s", recordType.c_str()));
+        auto recordType = fruRecordTypes.find(record->record_type);
+        auto encodeType = fruEncodingType.find(record->encoding_type);
         phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU field number",
-            phosphor::logging::entry("FRU_FIELD_NUM=%d", fruFieldNum));
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU Encode Type",
-            phosphor::logging::entry("FRU_ENCODE_TYPE=%s", encodeType.c_str()));
-
-        if (fruFieldNum < 1)
+            "FRU Record",
+            phosphor::logging::entry("REC_SET_ID=%d",
+                                     le16toh(record->record_set_id)),
+            phosphor::logging::entry("REC_TYPE=%s",
+                                     recordType != fruRecordTypes.end()
+                                         ? recordType->second
+                                         : "Unknown"),
+            phosphor::logging::entry("FRU_FIELD_NUM=%d",
+                                     record->num_fru_fields),
+            phosphor::logging::entry("FRU_ENCODE_TYPE=%s",
+                                     encodeType != fruEncodingType.end()
+                                         ? encodeType->second
+                                         : "Unknown"));
+
+        if (record->num_fru_fields < 1)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "Number of FRU fields cannot be 0.");
             return std::nullopt;
         }
 
-        auto isGeneralRec = false;
-        if (record->record_type == PLDM_FRU_RECORD_TYPE_GENERAL)
-        {
-            isGeneralRec = true;
-        }
-
-        pTable +=
-            sizeof(pldm_fru_record_data_format) - sizeof(pldm_fru_record_tlv);
-        for (int i = 0; i < record->num_fru_fields; i++)
+        const bool isGeneralRec =
+            record->record_type == PLDM_FRU_RECORD_TYPE_GENERAL;
+        const uint8_t fruFieldNum = record->num_fru_fields;
+        pTable += recordHeaderSize;
+        for (uint8_t i = 0; i < fruFieldNum; i++)
         {
+            const ptrdiff_t remaining = tableEnd - pTable;
             auto tlv = reinterpret_cast<const pldm_fru_record_tlv*>(pTable);
-            if (isGeneralRec)
+            if (remaining < static_cast<ptrdiff_t>(tlvHeaderSize) ||
+                remaining - static_cast<ptrdiff_t>(tlvHeaderSize) <
+                    tlv->length)
             {
-                if (!parseFRUField(record->record_type, tlv->type, tlv->length,
-                                   tlv->value))
-                {
-                    phosphor::logging::log<phosphor::logging::level::WARNING>(
-                        "Failed to parse fru fields",
-                        phosphor::logging::entry("TID=%d", tid));
-                }
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "FRU field exceeds the FRU record table",
+                    phosphor::logging::entry("TID=%d", tid));
+                return std::nullopt;
+            }
+            // Only General record fields are exposed, later records override
+            // fields of earlier ones
+            if (isGeneralRec && tlv->type < fruFieldInfo.size() &&
+                fruFieldInfo[tlv->type].format != FRUFieldFormat::unsupported)
+            {
+                fruRecord.fields[tlv->type] = FRUFieldRef{
+                    static_cast<uint32_t>(tlv->value - table.data()),
+                    tlv->length};
+            }
+            else if (isGeneralRec)
+            {
+                phosphor::logging::log<phosphor::logging::level::WARNING>(
+                    "fruFieldTypes key not available in map",
+                    phosphor::logging::entry("TID=%d", tid));
             }
-            pTable += sizeof(pldm_fru_record_tlv) - 1 + tlv->length;
+            pTable += tlvHeaderSize + tlv->length;
         }
     }
-    return fruProperties;
+    return fruRecord;
 }
 
-PLDMFRUTable::PLDMFRUTable(const std::vector<uint8_t> tableVal,
+PLDMFRUTable::PLDMFRUTable(std::span<const uint8_t> tableVal,
                            const pldm_tid_t tidVal) :
     table(tableVal),
     tid(tidVal)
@@ -208,28 +340,21 @@ bool GetPLDMFRU::verifyCRC(std::vector<uint8_t>& fruTable)
 }
 
 static bool addFRUObjectToDbus(const std::string& fruObjPath,
-                               const pldm_tid_t tid,
-                               FRUProperties& fruProperties)
+                               std::span<const uint8_t> table,
+                               const FRURecord& fruRecord)
 {
     auto objServer = getObjServer();
     std::shared_ptr<sdbusplus::asio::dbus_interface> fruIface =
         objServer->add_interface(fruObjPath, FRU::interface);
 
-    std::string propertyVal = "";
-    for (auto i : fruProperties)
+    for (size_t fieldType = 0; fieldType < fruFieldInfo.size(); fieldType++)
     {
-        try
+        if (auto value = getFieldValue(table, fruRecord,
+                                       static_cast<uint8_t>(fieldType)))
         {
-            propertyVal = std::get<std::string>(i.second);
+            fruIface->register_property(fruFieldInfo[fieldType].name,
+                                        value.value());
         }
-        catch (const std::bad_variant_access&)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Failed to register FRU property",
-                phosphor::logging::entry("TID=%d", tid));
-            continue;
-        }
-        fruIface->register_property(i.first, propertyVal);
     }
 
     fruIface->initialize();
@@ -238,7 +363,7 @@ static bool addFRUObjectToDbus(const std::string& fruObjPath,
     return true;
 }
 
-int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
+int GetPLDMFRU::getFRURecordTableCmd(std::vector<uint8_t>& fruRecordTableData)
 {
     uint32_t dataTransferHandle = 0;
     uint8_t transferOperationFlag = PLDM_GET_FIRSTPART;
@@ -248,7 +373,7 @@ int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
     uint8_t transferFlag = 0;
     uint32_t nextDataTransferHandle = 0;
     size_t fruRecordTableLen = 0;
-    std::vector<uint8_t> fruRecordTableData = {};
+    fruRecordTableData.clear();
 
     while (transferFlag != PLDM_END && transferFlag != PLDM_START_AND_END)
     {
@@ -330,13 +455,37 @@ int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
                   std::back_inserter(fruRecordTableData));
     }
 
-    if (!verifyCRC(fruRecordTableData))
+    // CRC check and table parsing are pure compute, keep them off the
+    // io_context thread
+    if (!runOnWorker(yield,
+                     [this, &fruRecordTableData]() {
+                         return verifyCRC(fruRecordTableData);
+                     }))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed at CRC Match", phosphor::logging::entry("TID=%d", tid));
         return PLDM_ERROR;
     }
 
+    return PLDM_SUCCESS;
+}
+
+int GetPLDMFRU::loadFRURecordTable(std::vector<uint8_t> fruRecordTableData,
+                                   FRURecord& fruRecord)
+{
+    PLDMFRUTable tableParse(fruRecordTableData, tid);
+
+    std::optional<FRURecord> record = runOnWorker(
+        yield, [&tableParse]() { return tableParse.parseTable(); });
+    if (!record.has_value())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to parse fru table data",
+            phosphor::logging::entry("TID=%d", tid));
+        return PLDM_ERROR_INVALID_DATA;
+    }
+    fruRecord = record.value();
+
     auto it = fruData.find(tid);
     if (it != fruData.end())
     {
@@ -346,23 +495,12 @@ int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
         fruData.erase(it);
     }
     // Fru record data is saved in byte format as it is received. This data is
-    // used by GetPldmFRU method
-    fruData.emplace(tid, fruRecordTableData);
-
-    PLDMFRUTable tableParse(std::move(fruRecordTableData), tid);
-
-    std::optional<FRUProperties> fruProp = tableParse.parseTable();
-    if (!fruProp.has_value())
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Failed to parse fru table data",
-            phosphor::logging::entry("TID=%d", tid));
-        return PLDM_ERROR_INVALID_DATA;
-    }
-    fruProperties = std::move(fruProp.value());
+    // used by GetPldmFRU method and holds the field values of fruRecord
+    const std::vector<uint8_t>& table =
+        fruData.emplace(tid, std::move(fruRecordTableData)).first->second;
 
     std::string tidFRUObjPath = fruPath + std::to_string(tid);
-    addFRUObjectToDbus(tidFRUObjPath, tid, fruProperties);
+    addFRUObjectToDbus(tidFRUObjPath, table, fruRecord);
 
     return PLDM_SUCCESS;
 }
@@ -419,6 +557,8 @@ int GetPLDMFRU::getFRURecordTableMetadataCmd()
     fruMetadata["FRUTableMaximumSize"] = fruTableMaximumSize;
     fruMetadata["FRUTableLength"] = fruTableLength;
     fruMetadata["Checksum"] = checksum;
+    fruMetadata["TotalRecordSetIdentifiers"] = totalRecordSetIdentifiers;
+    fruMetadata["TotalTableRecords"] = totalTableRecords;
 
     return PLDM_SUCCESS;
 }
@@ -445,8 +585,38 @@ bool GetPLDMFRU::runGetFRUCommands()
         return false;
     }
 
-    FRUProperties fruProperties;
-    retVal = getFRURecordTableCmd(fruProperties);
+    FRURecord fruRecord;
+    std::optional<platform::UUID> uuid = base::getTerminusUUID(tid);
+    FRUTableValidator validator = {
+        fruMetadata["FRUTableLength"],
+        static_cast<uint16_t>(fruMetadata["TotalRecordSetIdentifiers"]),
+        static_cast<uint16_t>(fruMetadata["TotalTableRecords"]),
+        fruMetadata["Checksum"]};
+    // A table cached for this terminus saves the multipart GetFRURecordTable
+    // transfer when the metadata reports an unchanged table
+    if (uuid)
+    {
+        std::optional<std::vector<uint8_t>> cachedTable =
+            getCachedFRUTable(uuid.value(), validator);
+        if (cachedTable &&
+            runOnWorker(yield,
+                        [this, &cachedTable]() {
+                            return verifyCRC(cachedTable.value());
+                        }) &&
+            loadFRURecordTable(std::move(cachedTable.value()), fruRecord) ==
+                PLDM_SUCCESS)
+        {
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "Using cached FRU record table",
+                phosphor::logging::entry("TID=%d", tid));
+            terminusFRUMetadata.insert_or_assign(tid, fruMetadata);
+            terminusFRURecords.insert_or_assign(tid, fruRecord);
+            return true;
+        }
+    }
+
+    std::vector<uint8_t> fruRecordTableData;
+    retVal = getFRURecordTableCmd(fruRecordTableData);
     if (retVal != PLDM_SUCCESS)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -454,9 +624,18 @@ bool GetPLDMFRU::runGetFRUCommands()
             phosphor::logging::entry("TID=%d", tid));
         return false;
     }
+    if (uuid)
+    {
+        cacheFRUTable(uuid.value(), validator, fruRecordTableData);
+    }
+    retVal = loadFRURecordTable(std::move(fruRecordTableData), fruRecord);
+    if (retVal != PLDM_SUCCESS)
+    {
+        return false;
+    }
 
     terminusFRUMetadata.insert_or_assign(tid, fruMetadata);
-    terminusFRUProperties.insert_or_assign(tid, std::move(fruProperties));
+    terminusFRURecords.insert_or_assign(tid, fruRecord);
     return true;
 }
 
@@ -506,50 +685,28 @@ int SetPLDMFRU::formatSetFruReq(std::vector<uint8_t>& requestMsg,
     return rc;
 }
 
-int SetPLDMFRU::sendFruData(boost::asio::yield_context yield,
-                            const std::vector<uint8_t>& setFruData)
+int SetPLDMFRU::sendFruPortions(boost::asio::yield_context yield,
+                               const std::vector<uint8_t>& setFruData,
+                               const size_t transferSize,
+                               std::vector<uint8_t>& requestMsg,
+                               std::vector<uint8_t>& responseMsg)
 {
-    size_t offset = 0;
-    int retVal = PLDM_SUCCESS;
-    size_t length = pldmFruBaselineTransferSize; // max payload size
     const size_t dataSize = setFruData.size();
-
     // Max number of unique requests (excluding requeries)
-    size_t numExpectedRequests = dataSize / pldmFruBaselineTransferSize;
-
-    if (dataSize % pldmFruBaselineTransferSize > 0)
-    {
-        numExpectedRequests += 1;
-    }
-
-    // Calculate based on size of payload and maximum transfer size
+    const size_t numExpectedRequests =
+        (dataSize + transferSize - 1) / transferSize;
     // Max number of requests including the requeries
-    size_t maxNumReq = numExpectedRequests * 3;
-    std::set<uint32_t> sentRequests;
-    uint32_t dataTransferHandle = 0;
+    const size_t maxNumReq = numExpectedRequests * 3;
 
-    while (maxNumReq--)
+    size_t offset = 0;
+    uint32_t dataTransferHandle = 0;
+    for (size_t numReq = 0; numReq < maxNumReq; numReq++)
     {
-        offset = dataTransferHandle * pldmFruBaselineTransferSize;
-
-        if (offset > dataSize)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "SetFruRecordTable: Offset out of range",
-                phosphor::logging::entry("TID=%d", tid));
-            return PLDM_ERROR;
-        }
-        if (dataSize - offset < pldmFruBaselineTransferSize)
-        {
-            length = dataSize - offset;
-        }
-        else
-        {
-            length = pldmFruBaselineTransferSize;
-        }
-
-        std::vector<uint8_t> requestMsg(
-            pldmHdrSize + sizeof(pldm_set_fru_record_table_req) + length);
+        const size_t length = std::min(transferSize, dataSize - offset);
+        // Capacity is reserved for the largest portion so the encode buffer
+        // is reused across portions. The send still copies the request.
+        requestMsg.resize(pldmHdrSize + sizeof(pldm_set_fru_record_table_req) +
+                          length);
 
         if (formatSetFruReq(requestMsg, dataTransferHandle, offset, length,
                             setFruData) != PLDM_SUCCESS)
@@ -560,10 +717,15 @@ int SetPLDMFRU::sendFruData(boost::asio::yield_context yield,
             return PLDM_ERROR;
         }
 
-        std::vector<uint8_t> responseMsg;
         if (!sendReceivePldmMessage(yield, tid, timeout, retryCount, requestMsg,
                                     responseMsg))
         {
+            // Some termini drop oversized requests instead of returning
+            // INVALID_LENGTH, so fall back to smaller portions as well
+            if (transferSize > pldmFruBaselineTransferSize)
+            {
+                return PLDM_ERROR_INVALID_LENGTH;
+            }
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "SetFruRecordTable: Failed to send or receive PLDM message",
                 phosphor::logging::entry("TID=%d", tid));
@@ -579,31 +741,78 @@ int SetPLDMFRU::sendFruData(boost::asio::yield_context yield,
 
         int rc = decode_set_fru_record_table_resp(responsePtr, payloadLen, &cc,
                                                   &nextDataTransferHandle);
-
+        if (rc == PLDM_SUCCESS && cc == PLDM_ERROR_INVALID_LENGTH &&
+            transferSize > pldmFruBaselineTransferSize)
+        {
+            return PLDM_ERROR_INVALID_LENGTH;
+        }
         if (!validatePLDMRespDecode(tid, rc, cc, "SetFruRecordTable"))
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "SetFruRecordTable: Invalid Response");
             return PLDM_ERROR;
         }
-        sentRequests.insert(dataTransferHandle);
-        dataTransferHandle = nextDataTransferHandle;
-        // Confirm if complete package data is been transferred
-        if (sentRequests.size() == numExpectedRequests)
+
+        if (offset + length == dataSize)
         {
             phosphor::logging::log<phosphor::logging::level::INFO>(
                 "Set fru successful");
-            break;
+            return PLDM_SUCCESS;
+        }
+        // The terminus requeries a portion by returning its handle again
+        if (nextDataTransferHandle != dataTransferHandle)
+        {
+            offset += length;
+            dataTransferHandle = nextDataTransferHandle;
         }
     }
 
-    if (maxNumReq == 0)
+    phosphor::logging::log<phosphor::logging::level::ERR>(
+        ("SetFruRecordTableData: Failed as requests exceed limit "));
+    return PLDM_ERROR;
+}
+
+int SetPLDMFRU::sendFruData(boost::asio::yield_context yield,
+                            const std::vector<uint8_t>& setFruData)
+{
+    if (setFruData.empty())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("SetFruRecordTableData: Failed as requests exceed limit "));
-        retVal = PLDM_ERROR;
+            "SetFruRecordTable: No FRU data to transfer",
+            phosphor::logging::entry("TID=%d", tid));
+        return PLDM_ERROR;
+    }
+
+    size_t transferSize = pldmFruMaxTransferSize;
+    auto it = setFRUTransferSize.find(tid);
+    if (it != setFRUTransferSize.end())
+    {
+        transferSize = it->second;
+    }
+
+    std::vector<uint8_t> requestMsg;
+    requestMsg.reserve(pldmHdrSize + sizeof(pldm_set_fru_record_table_req) +
+                       transferSize);
+    std::vector<uint8_t> responseMsg;
+    while (true)
+    {
+        int rc = sendFruPortions(yield, setFruData, transferSize, requestMsg,
+                                 responseMsg);
+        if (rc != PLDM_ERROR_INVALID_LENGTH)
+        {
+            if (rc == PLDM_SUCCESS)
+            {
+                setFRUTransferSize.insert_or_assign(tid, transferSize);
+            }
+            return rc;
+        }
+        // Restart the transfer with smaller portions
+        transferSize = std::max(transferSize / 2, pldmFruBaselineTransferSize);
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "SetFruRecordTable: Retrying with smaller transfer size",
+            phosphor::logging::entry("TID=%d", tid),
+            phosphor::logging::entry("SIZE=%zu", transferSize));
     }
-    return retVal;
 }
 
 int SetPLDMFRU::setFruRecordTableCmd(boost::asio::yield_context yield,
@@ -667,11 +876,11 @@ int SetPLDMFRU::setFruRecordTableCmd(boost::asio::yield_context yield,
             phosphor::logging::entry("TID=%d", tid));
         return PLDM_ERROR;
     }
-    try
+    if (std::optional<FRUProperties> fruProperties = getProperties(tid))
     {
-        ipmiFru.convertFRUToIpmiFRU(tid, terminusFRUProperties.at(tid));
+        ipmiFru.convertFRUToIpmiFRU(tid, fruProperties.value());
     }
-    catch (const std::out_of_range&)
+    else
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Failed to map PLDM Fru to IPMI fru",
@@ -700,6 +909,12 @@ static void removeInterface(
     }
 }
 
+/** @brief Forget the SetFRU transfer size learned for a removed device */
+void deleteFRUTransferSize(const pldm_tid_t tid)
+{
+    setFRUTransferSize.erase(tid);
+}
+
 /** @brief API that deletes PLDM fru device resorces. This API should be
  * called when PLDM fru capable devide is removed from the platform.
  */
@@ -712,24 +927,24 @@ bool deleteFRUDevice(const pldm_tid_t tid)
             ("PLDM FRU device not matched for TID " + std::to_string(tid))
                 .c_str());
         // If terminusFRUMetadata[tid] is not present, then it is safe to return
-        // as terminusFRUProperties / fruInterface will not be there.
+        // as terminusFRURecords / fruInterface will not be there.
         return false;
     }
     terminusFRUMetadata.erase(it);
 
-    auto itr = terminusFRUProperties.find(tid);
-    if (itr == terminusFRUProperties.end())
+    auto itr = terminusFRURecords.find(tid);
+    if (itr == terminusFRURecords.end())
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             ("PLDM FRU device properties not matched for TID " +
              std::to_string(tid))
                 .c_str());
         // Only terminusFRUMeta[tid] is present, which is cleared. No
-        // terminusFRUProperties[tid] is present meaning terminusFRUProperties /
+        // terminusFRURecords[tid] is present meaning terminusFRURecords /
         // fruInterface will not be there to clear. So return true.
         return true;
     }
-    terminusFRUProperties.erase(itr);
+    terminusFRURecords.erase(itr);
 
     auto itData = fruData.find(tid);
     if (itData == fruData.end())
@@ -738,8 +953,8 @@ bool deleteFRUDevice(const pldm_tid_t tid)
             ("PLDM FRU device not available for TID " + std::to_string(tid))
                 .c_str());
         // terminusFRUMeta[tid] is present, which is cleared.
-        // terminusFRUProperties[tid] is cleared .NO fruData present meaning
-        // terminusFRUProperties / fruInterface will not be there to clear. So
+        // terminusFRURecords[tid] is cleared .NO fruData present meaning
+        // terminusFRURecords / fruInterface will not be there to clear. So
         // return true.
         return true;
     }
@@ -849,19 +1064,19 @@ bool fruInit(boost::asio::yield_context yield, const pldm_tid_t tid)
         return retVal;
     }
 
-    try
-    {
-        ipmiFru.convertFRUToIpmiFRU(tid, terminusFRUProperties.at(tid));
-    }
-    catch (const std::out_of_range&)
+    // IPMI and Redfish views are built from the parsed FRU record
+    std::optional<FRUProperties> fruProperties = getProperties(tid);
+    if (!fruProperties)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to map PLDM Fru to IPMI fru",
             phosphor::logging::entry("TID=%d", tid));
+        return retVal;
     }
+    ipmiFru.convertFRUToIpmiFRU(tid, fruProperties.value());
 
 #ifdef EXPOSE_CHASSIS
-    redfishFru.createInterface(tid, terminusFRUProperties.at(tid));
+    redfishFru.createInterface(tid, fruProperties.value());
 #endif
 
     return retVal;
@@ -0,0 +1,167 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fru_cache.hpp"
+
+#include "utils.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <phosphor-logging/log.hpp>
+#include <span>
+
+namespace pldm
+{
+namespace fru
+{
+struct CachedFRUTable
+{
+    FRUTableValidator validator;
+    std::vector<uint8_t> table;
+};
+
+static const std::filesystem::path fruCacheFile =
+    std::filesystem::path(utils::stateDir) / "fru_cache";
+static std::map<pldm::platform::UUID, CachedFRUTable> fruTableCache;
+static bool fruTableCacheLoaded = false;
+
+using utils::appendRaw;
+using utils::readRaw;
+
+static bool readEntry(std::span<const uint8_t>& buffer,
+                      pldm::platform::UUID& uuid, CachedFRUTable& entry)
+{
+    uint32_t tableSize = 0;
+    if (!readRaw(buffer, uuid) || !readRaw(buffer, entry.validator) ||
+        !readRaw(buffer, tableSize) || tableSize > maxFRUCacheTableSize ||
+        buffer.size() < tableSize)
+    {
+        return false;
+    }
+    entry.table.assign(buffer.begin(), buffer.begin() + tableSize);
+    buffer = buffer.subspan(tableSize);
+    return true;
+}
+
+static void loadFRUTableCache()
+{
+    fruTableCacheLoaded = true;
+    std::vector<uint8_t> data = utils::readFile(fruCacheFile);
+    if (data.empty())
+    {
+        return;
+    }
+
+    std::span<const uint8_t> buffer(data);
+    FRUCacheHeader header = {};
+    if (!readRaw(buffer, header) || header.magic != fruCacheMagic ||
+        header.version != fruCacheVersion)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Discarding invalid FRU table cache");
+        return;
+    }
+    for (uint16_t i = 0; i < header.entryCount; i++)
+    {
+        pldm::platform::UUID uuid = {};
+        CachedFRUTable entry;
+        if (!readEntry(buffer, uuid, entry))
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "FRU table cache is truncated");
+            fruTableCache.clear();
+            return;
+        }
+        fruTableCache.insert_or_assign(uuid, std::move(entry));
+    }
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Loaded FRU table cache. ENTRY_COUNT: " +
+         std::to_string(fruTableCache.size()))
+            .c_str());
+}
+
+static bool saveFRUTableCache()
+{
+    std::vector<uint8_t> data;
+    FRUCacheHeader header = {};
+    header.magic = fruCacheMagic;
+    header.version = fruCacheVersion;
+    header.entryCount = static_cast<uint16_t>(fruTableCache.size());
+    appendRaw(data, header);
+    for (const auto& [uuid, entry] : fruTableCache)
+    {
+        appendRaw(data, uuid);
+        appendRaw(data, entry.validator);
+        appendRaw(data, static_cast<uint32_t>(entry.table.size()));
+        data.insert(data.end(), entry.table.begin(), entry.table.end());
+    }
+    return utils::writeFileAtomic(fruCacheFile, data, "FRU table cache");
+}
+
+std::optional<std::vector<uint8_t>>
+    getCachedFRUTable(const pldm::platform::UUID& uuid,
+                      const FRUTableValidator& validator)
+{
+    if (!fruTableCacheLoaded)
+    {
+        loadFRUTableCache();
+    }
+    auto it = fruTableCache.find(uuid);
+    if (it == fruTableCache.end())
+    {
+        return std::nullopt;
+    }
+    if (std::memcmp(&it->second.validator, &validator,
+                    sizeof(FRUTableValidator)) != 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "FRU record table changed, ignoring FRU table cache");
+        return std::nullopt;
+    }
+    return it->second.table;
+}
+
+void cacheFRUTable(const pldm::platform::UUID& uuid,
+                   const FRUTableValidator& validator,
+                   const std::vector<uint8_t>& fruTable)
+{
+    if (fruTable.size() > maxFRUCacheTableSize)
+    {
+        return;
+    }
+    if (!fruTableCacheLoaded)
+    {
+        loadFRUTableCache();
+    }
+    auto it = fruTableCache.find(uuid);
+    if (it != fruTableCache.end() &&
+        std::memcmp(&it->second.validator, &validator,
+                    sizeof(FRUTableValidator)) == 0 &&
+        it->second.table == fruTable)
+    {
+        return;
+    }
+    if (fruTableCache.size() >= maxFRUCacheEntries &&
+        it == fruTableCache.end())
+    {
+        // Cache is only an optimisation, drop an arbitrary entry to make room
+        fruTableCache.erase(fruTableCache.begin());
+    }
+    fruTableCache.insert_or_assign(uuid, CachedFRUTable{validator, fruTable});
+    saveFRUTableCache();
+}
+} // namespace fru
+} // namespace pldm
@@ -73,6 +73,46 @@ void IpmiFru::initializeFRUSupport()
     fruIface->initialize();
 }
 
+/** @brief Map the string PLDM FRU properties to their IPMI product area
+ * names
+ */
+static FRUProperties getIpmiProperties(const pldm_tid_t tid,
+                                       const FRUProperties& fruProperties)
+{
+    FRUProperties ipmiProps;
+    for (auto& property : fruProperties)
+    {
+        std::string propertyVal;
+        try
+        {
+            // Accessing PLDM FRU Properties of type string only
+            propertyVal = std::get<std::string>(property.second);
+        }
+        catch (const std::bad_variant_access&)
+        {
+            // If the propery value is other than string proceed to next
+            // property
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Failed to register FRU property",
+                phosphor::logging::entry("TID=%d", tid));
+            continue;
+        }
+        auto itr = mappedIpmiProperties.find(property.first);
+        if (itr != mappedIpmiProperties.end())
+        {
+            if ((property.first.compare("Manufacturer") == 0) &&
+                (fruProperties.find("Vendor") != fruProperties.end()))
+            {
+                // Map Manufacturer with PRODUCT_MANUFACTURER only if Vendor is
+                // not available
+                continue;
+            }
+            ipmiProps.emplace(itr->second, std::move(propertyVal));
+        }
+    }
+    return ipmiProps;
+}
+
 void IpmiFru::convertFRUToIpmiFRU(const pldm_tid_t tid,
                                   const FRUProperties& fruProperties)
 {
@@ -105,37 +145,9 @@ void IpmiFru::convertFRUToIpmiFRU(const pldm_tid_t tid,
     std::shared_ptr<sdbusplus::asio::dbus_interface> iface =
         objServer->add_interface(fruPath, "xyz.openbmc_project.FruDevice");
 
-    std::string propertyVal;
-    FRUProperties ipmiProps;
-    for (auto& property : fruProperties)
+    for (const auto& [name, value] : getIpmiProperties(tid, fruProperties))
     {
-        try
-        {
-            // Accessing PLDM FRU Properties of type string only
-            propertyVal = std::get<std::string>(property.second);
-        }
-        catch (const std::bad_variant_access&)
-        {
-            // If the propery value is other than string proceed to next
-            // property
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                "Failed to register FRU property",
-                phosphor::logging::entry("TID=%d", tid));
-            continue;
-        }
-        auto itr = mappedIpmiProperties.find(property.first);
-        if (itr != mappedIpmiProperties.end())
-        {
-            if ((property.first.compare("Manufacturer") == 0) &&
-                (fruProperties.find("Vendor") != fruProperties.end()))
-            {
-                // Map Manufacturer with PRODUCT_MANUFACTURER only if Vendor is
-                // not available
-                continue;
-            }
-            iface->register_property(itr->second, propertyVal);
-            ipmiProps.emplace(itr->second, propertyVal);
-        }
+        iface->register_property(name, std::get<std::string>(value));
     }
     // GetRawFru data command(0x11h) internally make use of bus and address to
     // get IPMI based FRU which is present under FruDevice service.
@@ -149,7 +161,8 @@ void IpmiFru::convertFRUToIpmiFRU(const pldm_tid_t tid,
 
     iface->initialize();
     ipmiFruInterface.emplace(tid, iface);
-    ipmiFRUProperties.emplace(tid, std::move(ipmiProps));
+    // The IPMI FRU image is built on the first GetRawFru of this TID
+    ipmiFRUImages.erase(tid);
 }
 
 void IpmiFru::removeInterfaces(const pldm_tid_t tid)
@@ -161,7 +174,7 @@ void IpmiFru::removeInterfaces(const pldm_tid_t tid)
     {
         objServer->remove_interface(ipmiIface->second);
         ipmiFruInterface.erase(ipmiIface);
-        ipmiFRUProperties.erase(tid);
+        ipmiFRUImages.erase(tid);
         return;
     }
     phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -172,12 +185,15 @@ void IpmiFru::removeInterfaces(const pldm_tid_t tid)
 std::optional<std::vector<uint8_t>>
     IpmiFru::getRawFRURecordData(const pldm_tid_t tid)
 {
-    std::vector<uint8_t> ipmiFruData;
-    std::vector<uint8_t> rawFruData;
-
-    auto itr = ipmiFRUProperties.find(tid);
+    auto cachedImage = ipmiFRUImages.find(tid);
+    if (cachedImage != ipmiFRUImages.end())
+    {
+        return cachedImage->second;
+    }
 
-    if (itr == ipmiFRUProperties.end())
+    std::optional<FRUProperties> fruProperties =
+        pldm::fru::getProperties(tid);
+    if (ipmiFruInterface.count(tid) == 0 || !fruProperties)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             ("IPMI-PLDM FRU device not matched for TID " + std::to_string(tid))
@@ -185,19 +201,26 @@ std::optional<std::vector<uint8_t>>
         return std::nullopt;
     }
 
+    std::vector<uint8_t> ipmiFruData;
+    std::vector<uint8_t> rawFruData;
+
     uint8_t internalAreaLen = setInternalArea(rawFruData);
 
     uint8_t chassisAreaLen = setChassisArea(rawFruData);
 
     uint8_t boardAreaLen = setBoardArea(rawFruData);
 
-    uint8_t productAreaLen = setProductArea(itr->second, rawFruData);
+    uint8_t productAreaLen = setProductArea(
+        getIpmiProperties(tid, fruProperties.value()), rawFruData);
 
     setCommonHeader(internalAreaLen, chassisAreaLen, boardAreaLen,
                     productAreaLen, ipmiFruData);
     std::move(rawFruData.begin(), rawFruData.end(),
               std::back_inserter(ipmiFruData));
 
+    // The image only changes with the PLDM FRU data, which replaces the
+    // FruDevice interface and drops this entry
+    ipmiFRUImages.emplace(tid, ipmiFruData);
     return ipmiFruData;
 }
 
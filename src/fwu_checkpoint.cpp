@@ -0,0 +1,213 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fwu_checkpoint.hpp"
+
+#include "utils.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <phosphor-logging/log.hpp>
+#include <span>
+
+namespace pldm
+{
+namespace fwu
+{
+static const std::filesystem::path checkpointFile =
+    std::filesystem::path(utils::stateDir) / "fwu_checkpoint";
+
+UpdateCheckpoint::UpdateCheckpoint(const uint32_t _pkgChecksum,
+                                   const uint64_t _pkgSize) :
+    pkgChecksum(_pkgChecksum),
+    pkgSize(_pkgSize)
+{
+}
+
+void UpdateCheckpoint::load()
+{
+    devices.clear();
+    std::vector<uint8_t> data = utils::readFile(checkpointFile);
+    if (data.empty())
+    {
+        return;
+    }
+
+    std::span<const uint8_t> buffer(data);
+    FWUCheckpointHeader header = {};
+    if (!utils::readRaw(buffer, header) || header.magic != fwuCheckpointMagic ||
+        header.version != fwuCheckpointVersion)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Discarding invalid firmware update checkpoint");
+        return;
+    }
+    if (header.pkgChecksum != pkgChecksum || header.pkgSize != pkgSize)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Firmware update checkpoint belongs to a different package");
+        return;
+    }
+
+    devices.resize(header.deviceCount);
+    for (auto& device : devices)
+    {
+        if (!utils::readRaw(buffer, device))
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Firmware update checkpoint is truncated");
+            devices.clear();
+            return;
+        }
+    }
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Loaded firmware update checkpoint. DEVICE_COUNT: " +
+         std::to_string(devices.size()))
+            .c_str());
+}
+
+FWUCheckpointDevice* UpdateCheckpoint::findDevice(const UUID& uuid,
+                                                  const uint8_t deviceIDRecord)
+{
+    auto it = std::find_if(devices.begin(), devices.end(),
+                           [&uuid, deviceIDRecord](const auto& device) {
+                               return device.uuid == uuid &&
+                                      device.deviceIDRecord == deviceIDRecord;
+                           });
+    return it == devices.end() ? nullptr : &*it;
+}
+
+const FWUCheckpointDevice*
+    UpdateCheckpoint::findDevice(const UUID& uuid,
+                                 const uint8_t deviceIDRecord) const
+{
+    return const_cast<UpdateCheckpoint*>(this)->findDevice(uuid,
+                                                           deviceIDRecord);
+}
+
+FWUCheckpointDevice&
+    UpdateCheckpoint::getOrAddDevice(const UUID& uuid,
+                                     const uint8_t deviceIDRecord)
+{
+    if (auto device = findDevice(uuid, deviceIDRecord))
+    {
+        return *device;
+    }
+    FWUCheckpointDevice device = {};
+    device.uuid = uuid;
+    device.deviceIDRecord = deviceIDRecord;
+    return devices.emplace_back(device);
+}
+
+bool UpdateCheckpoint::hasSession(const UUID& uuid,
+                                  const uint8_t deviceIDRecord) const
+{
+    const FWUCheckpointDevice* device = findDevice(uuid, deviceIDRecord);
+    return device && !device->activated;
+}
+
+uint64_t
+    UpdateCheckpoint::getCompletedComponents(const UUID& uuid,
+                                             const uint8_t deviceIDRecord) const
+{
+    const FWUCheckpointDevice* device = findDevice(uuid, deviceIDRecord);
+    return device ? device->completedComponents : 0;
+}
+
+const FWUCheckpointDevice*
+    UpdateCheckpoint::getActivatedDevice(const UUID& uuid,
+                                         const uint8_t deviceIDRecord) const
+{
+    const FWUCheckpointDevice* device = findDevice(uuid, deviceIDRecord);
+    return (device && device->activated) ? device : nullptr;
+}
+
+void UpdateCheckpoint::beginSession(const UUID& uuid,
+                                    const uint8_t deviceIDRecord)
+{
+    getOrAddDevice(uuid, deviceIDRecord);
+    save();
+}
+
+void UpdateCheckpoint::markComponentComplete(const UUID& uuid,
+                                             const uint8_t deviceIDRecord,
+                                             const uint16_t component)
+{
+    if (component >= maxCheckpointComponents)
+    {
+        return;
+    }
+    FWUCheckpointDevice& device = getOrAddDevice(uuid, deviceIDRecord);
+    device.completedComponents |= (static_cast<uint64_t>(1) << component);
+    save();
+}
+
+void UpdateCheckpoint::clearComponents(const UUID& uuid,
+                                       const uint8_t deviceIDRecord,
+                                       const uint64_t components)
+{
+    if (auto device = findDevice(uuid, deviceIDRecord))
+    {
+        device->completedComponents &= ~components;
+        save();
+    }
+}
+
+void UpdateCheckpoint::markActivated(const UUID& uuid,
+                                     const uint8_t deviceIDRecord,
+                                     const int updateStatus,
+                                     const uint16_t activationTime)
+{
+    FWUCheckpointDevice& device = getOrAddDevice(uuid, deviceIDRecord);
+    device.activated = 1;
+    device.updateStatus = updateStatus;
+    device.estimatedTimeForSelfContainedActivation = activationTime;
+    save();
+}
+
+void UpdateCheckpoint::remove()
+{
+    devices.clear();
+    std::error_code ec;
+    std::filesystem::remove(checkpointFile, ec);
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            ("Failed to remove firmware update checkpoint. ERROR: " +
+             ec.message())
+                .c_str());
+    }
+}
+
+bool UpdateCheckpoint::save()
+{
+    std::vector<uint8_t> data;
+    FWUCheckpointHeader header = {};
+    header.magic = fwuCheckpointMagic;
+    header.version = fwuCheckpointVersion;
+    header.pkgChecksum = pkgChecksum;
+    header.pkgSize = pkgSize;
+    header.deviceCount = static_cast<uint8_t>(devices.size());
+
+    utils::appendRaw(data, header);
+    for (const auto& device : devices)
+    {
+        utils::appendRaw(data, device);
+    }
+    return utils::writeFileAtomic(checkpointFile, data,
+                                  "firmware update checkpoint");
+}
+} // namespace fwu
+} // namespace pldm
@@ -15,6 +15,7 @@
  */
 #include "fwu_utils.hpp"
 
+#include <algorithm>
 #include <phosphor-logging/log.hpp>
 
 namespace pldm
@@ -160,5 +161,49 @@ std::string toString(const struct variable_field& var)
         str.begin(), str.end(), [](const char& c) { return !isprint(c); }, ' ');
     return str;
 }
+
+FWUDataTransfer::FWUDataTransfer(const size_t dataSize,
+                                 const size_t _chunkSize) :
+    chunkSize(_chunkSize),
+    served(_chunkSize ? (dataSize + _chunkSize - 1) / _chunkSize : 0, false)
+{
+}
+
+std::vector<uint8_t>* FWUDataTransfer::getResponse(const size_t offset,
+                                                   const size_t length)
+{
+    auto it = std::find_if(window.begin(), window.end(),
+                           [offset, length](const auto& entry) {
+                               return entry.offset == offset &&
+                                      entry.length == length;
+                           });
+    return it == window.end() ? nullptr : &it->response;
+}
+
+std::vector<uint8_t>&
+    FWUDataTransfer::addResponse(const size_t offset, const size_t length,
+                                 std::vector<uint8_t>&& response)
+{
+    if (chunkSize)
+    {
+        const size_t end = std::min(
+            (offset + length + chunkSize - 1) / chunkSize, served.size());
+        for (size_t chunk = offset / chunkSize; chunk < end; chunk++)
+        {
+            if (!served[chunk])
+            {
+                served[chunk] = true;
+                servedCount++;
+            }
+        }
+    }
+    if (window.size() >= fwuDataTransferWindowSize)
+    {
+        window.pop_front();
+    }
+    return window.emplace_back(
+               EncodedResponse{offset, length, std::move(response)})
+        .response;
+}
 } // namespace fwu
 } // namespace pldm
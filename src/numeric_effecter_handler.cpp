@@ -163,9 +163,9 @@ bool NumericEffecterHandler::initEffecter()
     return true;
 }
 
-bool NumericEffecterHandler::handleEffecterReading(
-    boost::asio::yield_context yield, uint8_t effecterOperationalState,
-    uint8_t effecterDataSize, union_effecter_data_size& presentReading)
+boost::asio::awaitable<bool> NumericEffecterHandler::handleEffecterReading(
+    uint8_t effecterOperationalState, uint8_t effecterDataSize,
+    union_effecter_data_size& presentReading)
 {
     switch (effecterOperationalState)
     {
@@ -174,19 +174,20 @@ bool NumericEffecterHandler::handleEffecterReading(
             transitionIntervalTimer->expires_after(
                 boost::asio::chrono::milliseconds(transitionIntervalSec));
             boost::system::error_code ec;
-            transitionIntervalTimer->async_wait(yield[ec]);
+            co_await transitionIntervalTimer->async_wait(
+                boost::asio::redirect_error(boost::asio::use_awaitable, ec));
 
             if (ec == boost::asio::error::operation_aborted)
             {
                 phosphor::logging::log<phosphor::logging::level::WARNING>(
                     "populateEffecterValue call invoke aborted");
-                return false;
+                co_return false;
             }
             else if (ec)
             {
                 phosphor::logging::log<phosphor::logging::level::WARNING>(
                     "populateEffecterValue call invoke failed");
-                return false;
+                co_return false;
             }
 
             cmdRetryCount++;
@@ -198,10 +199,10 @@ bool NumericEffecterHandler::handleEffecterReading(
                      std::to_string(cmdRetryCount))
                         .c_str());
                 cmdRetryCount = 0;
-                return false;
+                co_return false;
             }
 
-            populateEffecterValue(yield);
+            co_await populateEffecterValue();
             break;
         }
         case EFFECTER_OPER_STATE_ENABLED_NOUPDATEPENDING: {
@@ -212,7 +213,7 @@ bool NumericEffecterHandler::handleEffecterReading(
                     phosphor::logging::entry("TID=%d", _tid),
                     phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
                     phosphor::logging::entry("DATA_SIZE=%d", effecterDataSize));
-                return false;
+                co_return false;
             }
 
             std::optional<float> effecterReading =
@@ -224,7 +225,7 @@ bool NumericEffecterHandler::handleEffecterReading(
                     phosphor::logging::entry("TID=%d", _tid),
                     phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
                     phosphor::logging::entry("DATA_SIZE=%d", effecterDataSize));
-                return false;
+                co_return false;
             }
 
             double value =
@@ -257,7 +258,7 @@ bool NumericEffecterHandler::handleEffecterReading(
                 "Numeric effecter unavailable",
                 phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
                 phosphor::logging::entry("TID=%d", _tid));
-            return false;
+            co_return false;
         }
         default:
             // TODO: Handle other effecter operational states like
@@ -266,7 +267,7 @@ bool NumericEffecterHandler::handleEffecterReading(
                 "Numeric effecter operational status unknown",
                 phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
                 phosphor::logging::entry("TID=%d", _tid));
-            return false;
+            co_return false;
     }
 
     if (effecterOperationalState != EFFECTER_OPER_STATE_ENABLED_UPDATEPENDING)
@@ -274,11 +275,10 @@ bool NumericEffecterHandler::handleEffecterReading(
         cmdRetryCount = 0;
     }
 
-    return true;
+    co_return true;
 }
 
-bool NumericEffecterHandler::getEffecterReading(
-    boost::asio::yield_context yield)
+boost::asio::awaitable<bool> NumericEffecterHandler::getEffecterReading()
 {
     int rc;
     std::vector<uint8_t> req(pldmMsgHdrSize +
@@ -289,18 +289,18 @@ bool NumericEffecterHandler::getEffecterReading(
                                                _effecterID, reqMsg);
     if (!validatePLDMReqEncode(_tid, rc, "GetNumericEffecterValue"))
     {
-        return false;
+        co_return false;
     }
 
     std::vector<uint8_t> resp;
-    if (!sendReceivePldmMessage(yield, _tid, commandTimeout, commandRetryCount,
-                                req, resp))
+    if (!co_await sendReceivePldmMessage(_tid, commandTimeout,
+                                         commandRetryCount, req, resp))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to send or receive GetNumericEffecterValue request",
             phosphor::logging::entry("TID=%d", _tid),
             phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID));
-        return false;
+        co_return false;
     }
 
     uint8_t completionCode;
@@ -318,22 +318,21 @@ bool NumericEffecterHandler::getEffecterReading(
     if (!validatePLDMRespDecode(_tid, rc, completionCode,
                                 "GetNumericEffecterValue"))
     {
-        return false;
+        co_return false;
     }
 
-    return handleEffecterReading(yield, effecterOperationalState,
-                                 effecterDataSize, presentValue);
+    co_return co_await handleEffecterReading(effecterOperationalState,
+                                             effecterDataSize, presentValue);
 }
 
-bool NumericEffecterHandler::populateEffecterValue(
-    boost::asio::yield_context yield)
+boost::asio::awaitable<bool> NumericEffecterHandler::populateEffecterValue()
 {
-    if (!getEffecterReading(yield))
+    if (!co_await getEffecterReading())
     {
         _effecter->incrementError();
-        return false;
+        co_return false;
     }
-    return true;
+    co_return true;
 }
 
 static std::optional<size_t> getEffecterValueSize(const uint8_t dataSize)
@@ -359,13 +358,6 @@ static std::optional<size_t> getEffecterValueSize(const uint8_t dataSize)
 bool NumericEffecterHandler::setEffecter(boost::asio::yield_context yield,
                                          double& value)
 {
-    if (value < minSettable || value > maxSettable)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Invalid effecter value");
-        return false;
-    }
-
     std::optional<double> settableValue =
         pdr::effecter::calculateSettableEffecterValue(*_pdr, value);
     if (settableValue == std::nullopt)
@@ -446,12 +438,27 @@ void NumericEffecterHandler::registerSetEffecter()
     setEffecterInterface->register_method(
         "SetEffecter",
         [this](boost::asio::yield_context yield, double effecterValue) {
-            if (!setEffecter(yield, effecterValue))
+            // Validate before queueing, a superseded value is never sent
+            if (effecterValue < minSettable || effecterValue > maxSettable)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "Invalid effecter value");
+                throw sdbusplus::exception::SdBusError(
+                    -EINVAL, "SetNumericEffecterValue failed");
+            }
+            // The handler may be destroyed while the write waits
+            const EffecterID effecterID = _effecterID;
+            const pldm_tid_t tid = _tid;
+            if (!writeQueue.write(
+                    yield, effecterValue,
+                    [this](boost::asio::yield_context yieldCtx, double value) {
+                        return setEffecter(yieldCtx, value);
+                    }))
             {
                 phosphor::logging::log<phosphor::logging::level::ERR>(
                     "Failed to SetNumericEffecterValue",
-                    phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
-                    phosphor::logging::entry("TID=%d", _tid));
+                    phosphor::logging::entry("EFFECTER_ID=0x%0X", effecterID),
+                    phosphor::logging::entry("TID=%d", tid));
 
                 throw sdbusplus::exception::SdBusError(
                     -EINVAL, "SetNumericEffecterValue failed");
@@ -480,16 +487,22 @@ void NumericEffecterHandler::registerSetEffecter()
                         transitionIntervalMilliSec));
                 transitionIntervalTimer->async_wait(
                     [this](const boost::system::error_code& e) {
+                        // Re-armed by a later set, only the last one reads
+                        // back the value
+                        if (e == boost::asio::error::operation_aborted)
+                        {
+                            return;
+                        }
                         if (e)
                         {
                             phosphor::logging::log<
                                 phosphor::logging::level::ERR>(
                                 "SetNumericEffecterValue: async_wait error");
                         }
-                        boost::asio::spawn(
+                        boost::asio::co_spawn(
                             *getIoContext(),
-                            [this](boost::asio::yield_context yieldCtx) {
-                                if (!populateEffecterValue(yieldCtx))
+                            [this]() -> boost::asio::awaitable<void> {
+                                if (!co_await populateEffecterValue())
                                 {
                                     phosphor::logging::log<
                                         phosphor::logging::level::ERR>(
@@ -499,13 +512,18 @@ void NumericEffecterHandler::registerSetEffecter()
                                         phosphor::logging::entry("TID=%d",
                                                                  _tid));
                                 }
-                            });
+                            },
+                            boost::asio::detached);
                     });
             };
 
             // Refresh the value on D-Bus
             getIoContext()->post(refreshEffecterInterfaces);
         });
+    // Returns requests, sets sent, superseded requests and current depth
+    setEffecterInterface->register_method(
+        "GetWriteQueueStatistics",
+        [this]() { return writeQueue.getStatistics(); });
     setEffecterInterface->initialize();
 }
 
@@ -526,7 +544,7 @@ bool NumericEffecterHandler::effecterHandlerInit(
         std::make_unique<boost::asio::steady_timer>(*getIoContext());
 
     // Read and populate the effecter initial value
-    if (!populateEffecterValue(yield))
+    if (!awaitFromYield(yield, populateEffecterValue()))
     {
         return false;
     }
@@ -540,5 +558,26 @@ bool NumericEffecterHandler::effecterHandlerInit(
     return true;
 }
 
+void NumericEffecterHandler::addMemoryUsage(MemoryUsage& usage) const
+{
+    usage.effecters++;
+    usage.bytes += sizeof(NumericEffecterHandler) +
+                   sizeof(pldm_numeric_effecter_value_pdr);
+    usage.addString(_name);
+    usage.addInterfaces(setEffecterInterface);
+    if (_effecter)
+    {
+        usage.bytes += sizeof(NumericEffecter);
+        usage.addString(_effecter->name);
+        usage.addInterfaces(_effecter->effecterInterface,
+                            _effecter->availableInterface,
+                            _effecter->operationalInterface);
+    }
+    if (transitionIntervalTimer)
+    {
+        usage.bytes += sizeof(boost::asio::steady_timer);
+    }
+}
+
 } // namespace platform
 } // namespace pldm
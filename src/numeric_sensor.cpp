@@ -36,8 +36,8 @@ NumericSensor::NumericSensor(const std::string& sensorName,
                              const bool sensorDisabled,
                              const std::string& associationPath) :
     name(std::regex_replace(sensorName, std::regex("[^a-zA-Z0-9_/]+"), "_")),
-    maxValue(max), minValue(min), thresholds(thresholdData), unit(sensorUnit),
-    hysteresisTrigger(hysteresis), errCount(0)
+    thresholds(thresholdData), maxValue(max), minValue(min),
+    hysteresisTrigger(hysteresis), unit(sensorUnit)
 {
     std::string path;
     switch (unit)
@@ -269,6 +269,16 @@ bool NumericSensor::checkErrorThreshold()
     return errCount < errorThreshold;
 }
 
+void NumericSensor::addMemoryUsage(pldm::platform::MemoryUsage& usage) const
+{
+    usage.bytes += sizeof(NumericSensor) +
+                   thresholds.capacity() * sizeof(thresholds::Threshold);
+    usage.addString(name);
+    usage.addInterfaces(associationInterface, sensorInterface,
+                        thresholdInterfaceWarning, thresholdInterfaceCritical,
+                        availableInterface, operationalInterface);
+}
+
 void NumericSensor::updateValue(const double& newValue, const bool isAvailable,
                                 const bool isFunctional)
 {
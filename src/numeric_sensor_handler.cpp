@@ -45,6 +45,18 @@ bool NumericSensorHandler::sensorErrorCheck()
     return false;
 }
 
+void NumericSensorHandler::addMemoryUsage(MemoryUsage& usage) const
+{
+    usage.sensors++;
+    usage.bytes += sizeof(NumericSensorHandler) +
+                   sizeof(pldm_numeric_sensor_value_pdr);
+    usage.addString(_name);
+    if (_sensor)
+    {
+        _sensor->addMemoryUsage(usage);
+    }
+}
+
 bool NumericSensorHandler::setNumericSensorEnable(
     boost::asio::yield_context yield)
 {
@@ -191,7 +203,7 @@ void NumericSensorHandler::getSupportedThresholds(
     // Note:- Fatal values are not supported
 }
 
-bool NumericSensorHandler::initSensor()
+bool NumericSensorHandler::initSensor(boost::asio::yield_context yield)
 {
     std::optional<float> maxVal =
         pdr::sensor::fetchSensorValue(*_pdr, _pdr->max_readable);
@@ -245,12 +257,12 @@ bool NumericSensorHandler::initSensor()
     }
     try
     {
-        _sensor = std::make_shared<NumericSensor>(
+        _sensor = std::make_unique<NumericSensor>(
             _name, thresholdData,
             pdr::sensor::calculateSensorValue(*_pdr, *maxVal),
             pdr::sensor::calculateSensorValue(*_pdr, *minVal),
             pdr::sensor::calculateSensorValue(*_pdr, *hysteresis), *baseUnit,
-            sensorDisabled, association::getPath(_tid));
+            sensorDisabled, association::getPath(yield, _tid));
     }
     catch (const std::exception& e)
     {
@@ -339,7 +351,7 @@ bool NumericSensorHandler::handleSensorReading(
     return true;
 }
 
-bool NumericSensorHandler::getSensorReading(boost::asio::yield_context yield)
+boost::asio::awaitable<bool> NumericSensorHandler::getSensorReading()
 {
     int rc;
     std::vector<uint8_t> req(pldmMsgHdrSize +
@@ -352,18 +364,18 @@ bool NumericSensorHandler::getSensorReading(boost::asio::yield_context yield)
                                        rearmEventState, reqMsg);
     if (!validatePLDMReqEncode(_tid, rc, "GetSensorReading"))
     {
-        return false;
+        co_return false;
     }
 
     std::vector<uint8_t> resp;
-    if (!sendReceivePldmMessage(yield, _tid, commandTimeout, commandRetryCount,
-                                req, resp))
+    if (!co_await sendReceivePldmMessage(_tid, commandTimeout,
+                                         commandRetryCount, req, resp))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to send or receive GetSensorReading request",
             phosphor::logging::entry("TID=%d", _tid),
             phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID));
-        return false;
+        co_return false;
     }
 
     uint8_t completionCode;
@@ -383,30 +395,30 @@ bool NumericSensorHandler::getSensorReading(boost::asio::yield_context yield)
         reinterpret_cast<uint8_t*>(&presentReading));
     if (!validatePLDMRespDecode(_tid, rc, completionCode, "GetSensorReading"))
     {
-        return false;
+        co_return false;
     }
 
-    return handleSensorReading(sensorOperationalState, sensorDataSize,
-                               presentReading);
+    co_return handleSensorReading(sensorOperationalState, sensorDataSize,
+                                  presentReading);
 }
 
-bool NumericSensorHandler::populateSensorValue(boost::asio::yield_context yield)
+boost::asio::awaitable<bool> NumericSensorHandler::populateSensorValue()
 {
     // No need to read the sensor if it is disabled
     if (_pdr->sensor_init == PLDM_SENSOR_DISABLE)
     {
-        return false;
+        co_return false;
     }
     if (!_sensor)
     {
-        return false;
+        co_return false;
     }
-    if (!getSensorReading(yield))
+    if (!co_await getSensorReading())
     {
         _sensor->incrementError();
-        return false;
+        co_return false;
     }
-    return true;
+    co_return true;
 }
 
 bool NumericSensorHandler::sensorHandlerInit(boost::asio::yield_context yield)
@@ -416,7 +428,7 @@ bool NumericSensorHandler::sensorHandlerInit(boost::asio::yield_context yield)
         return false;
     }
 
-    if (!initSensor())
+    if (!initSensor(yield))
     {
         return false;
     }
@@ -0,0 +1,317 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "packet_capture.hpp"
+
+#include "utils.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace capture
+{
+struct CaptureEntry
+{
+    std::chrono::system_clock::time_point timestamp;
+    uint32_t length;
+    mctpw_eid_t eid;
+    uint8_t msgTag;
+    bool tagOwner;
+    Direction direction;
+    std::array<uint8_t, captureSnapLength> data;
+};
+
+struct PcapFileHeader
+{
+    uint32_t magic;
+    uint16_t versionMajor;
+    uint16_t versionMinor;
+    int32_t thisZone;
+    uint32_t sigFigs;
+    uint32_t snapLength;
+    uint32_t linkType;
+} __attribute__((packed));
+
+struct PcapRecordHeader
+{
+    uint32_t seconds;
+    uint32_t microseconds;
+    uint32_t capturedLength;
+    uint32_t length;
+} __attribute__((packed));
+
+struct MCTPTransportHeader
+{
+    uint8_t version;
+    uint8_t destinationEid;
+    uint8_t sourceEid;
+    uint8_t flags;
+} __attribute__((packed));
+
+constexpr uint32_t pcapMagic = 0xA1B2C3D4;
+constexpr uint8_t mctpHeaderVersion = 0x01;
+constexpr uint8_t mctpSOM = 0x80;
+constexpr uint8_t mctpEOM = 0x40;
+constexpr uint8_t mctpTagOwner = 0x08;
+constexpr uint8_t mctpMsgTagMask = 0x07;
+constexpr mctpw_eid_t nullEid = 0;
+
+bool captureEnabled = false;
+// Fixed size ring, nextEntry is the oldest entry once the ring has wrapped
+static std::vector<CaptureEntry> captureRing;
+static size_t nextEntry = 0;
+static bool ringWrapped = false;
+
+void recordPacket(const Direction direction, const mctpw_eid_t eid,
+                  const bool tagOwner, const uint8_t msgTag,
+                  const std::vector<uint8_t>& payload)
+{
+    CaptureEntry& entry = captureRing[nextEntry];
+    entry.timestamp = std::chrono::system_clock::now();
+    entry.length = static_cast<uint32_t>(payload.size());
+    entry.eid = eid;
+    entry.msgTag = msgTag;
+    entry.tagOwner = tagOwner;
+    entry.direction = direction;
+    std::copy_n(payload.begin(), std::min(payload.size(), captureSnapLength),
+                entry.data.begin());
+
+    if (++nextEntry == captureRing.size())
+    {
+        nextEntry = 0;
+        ringWrapped = true;
+    }
+}
+
+bool startCapture(const size_t entryCount)
+{
+    if (entryCount == 0 || entryCount > maxCaptureEntries)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid capture ring size",
+            phosphor::logging::entry("ENTRIES=%zu", entryCount));
+        return false;
+    }
+    captureRing.assign(entryCount, CaptureEntry{});
+    nextEntry = 0;
+    ringWrapped = false;
+    captureEnabled = true;
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "PLDM packet capture started",
+        phosphor::logging::entry("ENTRIES=%zu", entryCount));
+    return true;
+}
+
+void stopCapture()
+{
+    captureEnabled = false;
+    captureRing.clear();
+    captureRing.shrink_to_fit();
+    nextEntry = 0;
+    ringWrapped = false;
+}
+
+static void appendEntry(std::vector<uint8_t>& buffer, const CaptureEntry& entry)
+{
+    using std::chrono::microseconds;
+    const auto sinceEpoch = std::chrono::duration_cast<microseconds>(
+        entry.timestamp.time_since_epoch());
+    const uint32_t capturedLength = static_cast<uint32_t>(
+        std::min<size_t>(entry.length, captureSnapLength));
+
+    PcapRecordHeader record = {};
+    record.seconds = static_cast<uint32_t>(sinceEpoch.count() / 1000000);
+    record.microseconds = static_cast<uint32_t>(sinceEpoch.count() % 1000000);
+    record.capturedLength =
+        static_cast<uint32_t>(sizeof(MCTPTransportHeader)) + capturedLength;
+    record.length =
+        static_cast<uint32_t>(sizeof(MCTPTransportHeader)) + entry.length;
+    utils::appendRaw(buffer, record);
+
+    MCTPTransportHeader header = {};
+    header.version = mctpHeaderVersion;
+    header.destinationEid =
+        entry.direction == Direction::sent ? entry.eid : nullEid;
+    header.sourceEid =
+        entry.direction == Direction::sent ? nullEid : entry.eid;
+    header.flags = static_cast<uint8_t>(
+        mctpSOM | mctpEOM | (entry.tagOwner ? mctpTagOwner : 0) |
+        (entry.msgTag & mctpMsgTagMask));
+    utils::appendRaw(buffer, header);
+    buffer.insert(buffer.end(), entry.data.begin(),
+                  entry.data.begin() + capturedLength);
+}
+
+static const std::filesystem::path captureDir = "/run/pldmd";
+
+/** @brief Create fileName inside captureDir, which has to be owned by pldmd
+ * and not writable by anyone else. Returns -1 if the name could escape the
+ * directory, the file already exists or the directory can't be trusted.
+ */
+static int createCaptureFile(const std::string& fileName)
+{
+    if (fileName.empty() || fileName == "." || fileName == ".." ||
+        fileName.find('/') != std::string::npos)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Capture file must be a bare file name",
+            phosphor::logging::entry("NAME=%s", fileName.c_str()));
+        return -1;
+    }
+
+    // The directory is checked through the descriptor the file is created
+    // with, so it can't be swapped in between
+    ::mkdir(captureDir.c_str(), S_IRWXU);
+    const int dirFd = ::open(captureDir.c_str(),
+                             O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    struct stat dirStat = {};
+    if (dirFd < 0 || ::fstat(dirFd, &dirStat) != 0 ||
+        dirStat.st_uid != ::geteuid() ||
+        (dirStat.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Capture directory is not a directory owned by pldmd",
+            phosphor::logging::entry("PATH=%s", captureDir.c_str()));
+        if (dirFd >= 0)
+        {
+            ::close(dirFd);
+        }
+        return -1;
+    }
+
+    const int fd =
+        ::openat(dirFd, fileName.c_str(),
+                 O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+                 S_IRUSR | S_IWUSR);
+    const int openErrno = errno;
+    ::close(dirFd);
+    if (fd < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to create capture file",
+            phosphor::logging::entry("NAME=%s", fileName.c_str()),
+            phosphor::logging::entry("ERRNO=%d", openErrno));
+    }
+    return fd;
+}
+
+static bool writeAll(const int fd, const std::vector<uint8_t>& data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        const ssize_t rc =
+            ::write(fd, data.data() + written, data.size() - written);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(rc);
+    }
+    return true;
+}
+
+bool dumpCapture(const std::string& fileName)
+{
+    if (!captureEnabled)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "PLDM packet capture is not running");
+        return false;
+    }
+    const int fd = createCaptureFile(fileName);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> buffer;
+    PcapFileHeader header = {};
+    header.magic = pcapMagic;
+    header.versionMajor = 2;
+    header.versionMinor = 4;
+    header.snapLength = static_cast<uint32_t>(sizeof(MCTPTransportHeader) +
+                                              captureSnapLength);
+    header.linkType = linkTypeMCTP;
+    utils::appendRaw(buffer, header);
+
+    if (ringWrapped)
+    {
+        for (size_t i = nextEntry; i < captureRing.size(); i++)
+        {
+            appendEntry(buffer, captureRing[i]);
+        }
+    }
+    for (size_t i = 0; i < nextEntry; i++)
+    {
+        appendEntry(buffer, captureRing[i]);
+    }
+    const bool status = writeAll(fd, buffer);
+    if (::close(fd) != 0 || !status)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to write capture file",
+            phosphor::logging::entry("NAME=%s", fileName.c_str()));
+        return false;
+    }
+    return true;
+}
+
+void initializeCaptureIntf()
+{
+    static std::unique_ptr<sdbusplus::asio::dbus_interface> captureInterface =
+        nullptr;
+    if (captureInterface != nullptr)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "captureInterface already initialized");
+        return;
+    }
+
+    if (auto envPtr = std::getenv("PLDM_CAPTURE"))
+    {
+        const size_t entryCount = std::strtoul(envPtr, nullptr, 10);
+        startCapture(entryCount ? entryCount : defaultCaptureEntries);
+    }
+
+    const char* objPath = "/xyz/openbmc_project/pldm";
+    captureInterface =
+        addUniqueInterface(objPath, "xyz.openbmc_project.PLDM.Capture");
+    captureInterface->register_method(
+        "StartCapture",
+        [](const uint32_t entryCount) { return startCapture(entryCount); });
+    captureInterface->register_method("StopCapture", []() { stopCapture(); });
+    captureInterface->register_method(
+        "DumpCapture",
+        [](const std::string& fileName) { return dumpCapture(fileName); });
+    captureInterface->initialize();
+}
+} // namespace capture
+} // namespace pldm
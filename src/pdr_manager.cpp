@@ -33,8 +33,12 @@ namespace pldm
 {
 namespace platform
 {
+// First arena block, enough for the PDRs of a typical add-in card. Further
+// blocks grow geometrically.
+constexpr size_t pdrArenaInitialSize = 4096;
 
-PDRManager::PDRManager(const pldm_tid_t tid) : _tid(tid)
+PDRManager::PDRManager(const pldm_tid_t tid) :
+    _arena(pdrArenaInitialSize), _tid(tid)
 {
 }
 
@@ -84,6 +88,10 @@ static inline void printDebug(const std::string& message)
 // TODO: remove this API after code complete
 static void printPDRInfo(pldm_pdr_repository_info& pdrRepoInfo)
 {
+    if (!debug)
+    {
+        return;
+    }
     printDebug("GetPDRRepositoryInfo: repositoryState -" +
                std::to_string(pdrRepoInfo.repository_state));
     printDebug("GetPDRRepositoryInfo: recordCount -" +
@@ -105,6 +113,10 @@ static void printPDRResp(const RecordHandle& recordHandle,
                          const bool& transferComplete,
                          const std::vector<uint8_t>& pdrRecord)
 {
+    if (!debug)
+    {
+        return;
+    }
     printDebug("GetPDR: recordHandle -" + std::to_string(recordHandle));
     printDebug("GetPDR: nextRecordHandle -" + std::to_string(nextRecordHandle));
     printDebug("GetPDR: transferOpFlag -" + std::to_string(transferOpFlag));
@@ -534,7 +546,10 @@ static std::optional<std::string> getAuxName(const uint8_t nameStrCount,
     return std::nullopt;
 }
 
-void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
+using EntityAuxNames = std::vector<std::pair<pldm_entity, std::string>>;
+
+static void decodeEntityAuxNamesPDR(std::vector<uint8_t>& pdrData,
+                                    EntityAuxNames& entityAuxNames)
 {
     constexpr size_t sharedNameCountSize = 1;
     constexpr size_t nameStringCountSize = 1;
@@ -564,8 +579,7 @@ void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
 
         if (namePDR->shared_name_count <= 0)
         {
-            // Cache the Entity Auxiliary Names
-            _entityAuxNames.emplace(namePDR->entity, *name);
+            entityAuxNames.emplace_back(namePDR->entity, *name);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 ("Entity Auxiliary Name: " + *name).c_str());
@@ -584,7 +598,7 @@ void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
             std::string auxName = *name;
             auxName.append("_").append(std::to_string(count));
 
-            _entityAuxNames.emplace(namePDR->entity, auxName);
+            entityAuxNames.emplace_back(namePDR->entity, auxName);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 ("Entity Auxiliary Name: " + *name).c_str());
@@ -594,23 +608,39 @@ void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
     }
 }
 
+// Bit N of possible states byte M is state value 8 * M + N
+static PossibleStateSet getPossibleStateSet(const bitfield8_t* states,
+                                            const uint8_t statesSize)
+{
+    PossibleStateSet stateSet;
+    const size_t size = std::min<size_t>(statesSize, maxPossibleStatesSize);
+    for (size_t count = 0; count < size; count++)
+    {
+        stateSet |= PossibleStateSet(states[count].byte) << (count * 8);
+    }
+    return stateSet;
+}
+
 // Create Entity Association node from parsed Entity Association PDR
-static bool getEntityAssociation(const std::shared_ptr<pldm_entity[]>& entities,
-                                 const size_t numEntities,
+static bool getEntityAssociation(std::pmr::memory_resource* arena,
+                                 const std::vector<pldm_entity>& entities,
                                  EntityNode::NodePtr& entityAssociation)
 {
-    if (!(0 < numEntities) || !entities)
+    const size_t numEntities = entities.size();
+    if (!(0 < numEntities))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "No entities in Entity Association PDR");
         return false;
     }
-    entityAssociation = std::make_shared<EntityNode>();
+    entityAssociation = allocateShared<EntityNode>(arena, arena);
     entityAssociation->containerEntity = entities[0];
+    entityAssociation->containedEntities.reserve(numEntities - 1);
 
     for (size_t count = 1; count < numEntities; count++)
     {
-        EntityNode::NodePtr containedPtr = std::make_shared<EntityNode>();
+        EntityNode::NodePtr containedPtr =
+            allocateShared<EntityNode>(arena, arena);
         containedPtr->containerEntity = entities[count];
 
         entityAssociation->containedEntities.emplace_back(
@@ -697,7 +727,8 @@ static void insertToAssociationTree(EntityNode::NodePtr& parentNode,
 // Entity Association PDRs if there is more than one with same root node
 // container ID
 static EntityNode::NodePtr
-    extractRootNode(std::vector<EntityNode::NodePtr>& entityAssociations,
+    extractRootNode(std::pmr::memory_resource* arena,
+                    std::vector<EntityNode::NodePtr>& entityAssociations,
                     ContainerID containerID)
 {
     EntityNode::NodePtr rootNode = nullptr;
@@ -705,7 +736,8 @@ static EntityNode::NodePtr
     entityAssociations.erase(
         std::remove_if(
             entityAssociations.begin(), entityAssociations.end(),
-            [&rootNode, &containerID](EntityNode::NodePtr& entityAssociation) {
+            [arena, &rootNode,
+             &containerID](EntityNode::NodePtr& entityAssociation) {
                 if (entityAssociation->containerEntity.entity_container_id !=
                     containerID)
                 {
@@ -714,7 +746,7 @@ static EntityNode::NodePtr
 
                 if (!rootNode)
                 {
-                    rootNode = std::make_shared<EntityNode>();
+                    rootNode = allocateShared<EntityNode>(arena, arena);
                     rootNode->containerEntity =
                         entityAssociation->containerEntity;
                 }
@@ -732,7 +764,7 @@ void PDRManager::createEntityAssociationTree(
 {
     // Get parent entity association
     EntityNode::NodePtr rootNode =
-        extractRootNode(entityAssociations, _containerID);
+        extractRootNode(&_arena, entityAssociations, _containerID);
 
     if (!rootNode)
     {
@@ -796,7 +828,9 @@ static bool mergeContainedEntities(EntityNode::NodePtr& node,
     return false;
 }
 
-void PDRManager::parseEntityAssociationPDR(std::vector<uint8_t>& pdrData)
+static std::optional<std::vector<pldm_entity>>
+    decodeEntityAssociationPDR(const pldm_tid_t tid,
+                               std::vector<uint8_t>& pdrData)
 {
     size_t numEntities{};
     pldm_entity* entitiesPtr = nullptr;
@@ -806,13 +840,19 @@ void PDRManager::parseEntityAssociationPDR(std::vector<uint8_t>& pdrData)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Entity Association PDR parsing failed",
-            phosphor::logging::entry("TID=%d", _tid));
-        return;
+            phosphor::logging::entry("TID=%d", tid));
+        return std::nullopt;
     }
-    std::shared_ptr<pldm_entity[]> entities(entitiesPtr, free);
+    std::unique_ptr<pldm_entity[], decltype(&free)> entities(entitiesPtr,
+                                                             free);
+    return std::vector<pldm_entity>(entities.get(),
+                                    entities.get() + numEntities);
+}
 
+void PDRManager::addEntityAssociation(const std::vector<pldm_entity>& entities)
+{
     EntityNode::NodePtr entityAssociation = nullptr;
-    if (getEntityAssociation(entities, numEntities, entityAssociation))
+    if (getEntityAssociation(&_arena, entities, entityAssociation))
     {
         for (auto& iter : entityAssociationNodes)
         {
@@ -951,13 +991,14 @@ void PDRManager::initializeInventoryIntf()
 }
 #endif
 
-void PDRManager::parseSensorAuxNamesPDR(std::vector<uint8_t>& pdrData)
+static std::optional<std::pair<SensorID, std::string>>
+    decodeSensorAuxNamesPDR(std::vector<uint8_t>& pdrData)
 {
     if (pdrData.size() < sizeof(pldm_sensor_auxiliary_names_pdr))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Sensor Auxiliary Names PDR empty");
-        return;
+        return std::nullopt;
     }
     pldm_sensor_auxiliary_names_pdr* namePDR =
         reinterpret_cast<pldm_sensor_auxiliary_names_pdr*>(pdrData.data());
@@ -971,24 +1012,31 @@ void PDRManager::parseSensorAuxNamesPDR(std::vector<uint8_t>& pdrData)
     if (auto name = getAuxName(namePDR->name_string_count, auxNamesLen,
                                namePDR->sensor_auxiliary_names))
     {
-        // Cache the Sensor Auxiliary Names
-        _sensorAuxNames[namePDR->sensor_id] = _deviceAuxName + "_" + *name;
-
-        phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            ("SensorID:" +
-             std::to_string(static_cast<int>(namePDR->sensor_id)) +
-             " Sensor Auxiliary Name: " + _sensorAuxNames[namePDR->sensor_id])
-                .c_str());
+        return std::make_pair(namePDR->sensor_id, std::move(*name));
     }
+    return std::nullopt;
 }
 
-void PDRManager::parseEffecterAuxNamesPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::addSensorAuxName(const SensorID sensorID,
+                                  const std::string& name)
+{
+    // Cache the Sensor Auxiliary Names
+    _sensorAuxNames[sensorID] = _deviceAuxName + "_" + name;
+
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        ("SensorID:" + std::to_string(static_cast<int>(sensorID)) +
+         " Sensor Auxiliary Name: " + _sensorAuxNames[sensorID])
+            .c_str());
+}
+
+static std::optional<std::pair<EffecterID, std::string>>
+    decodeEffecterAuxNamesPDR(std::vector<uint8_t>& pdrData)
 {
     if (pdrData.size() < sizeof(pldm_effecter_auxiliary_names_pdr))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Effecter Auxiliary Names PDR empty");
-        return;
+        return std::nullopt;
     }
     pldm_effecter_auxiliary_names_pdr* namePDR =
         reinterpret_cast<pldm_effecter_auxiliary_names_pdr*>(pdrData.data());
@@ -1002,16 +1050,21 @@ void PDRManager::parseEffecterAuxNamesPDR(std::vector<uint8_t>& pdrData)
     if (auto name = getAuxName(namePDR->name_string_count, auxNamesLen,
                                namePDR->effecter_auxiliary_names))
     {
-        // Cache the Effecter Auxiliary Names
-        _effecterAuxNames[namePDR->effecter_id] = _deviceAuxName + "_" + *name;
-
-        phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            ("EffecterID:" +
-             std::to_string(static_cast<int>(namePDR->effecter_id)) +
-             " Effecter Auxiliary Name: " +
-             _effecterAuxNames[namePDR->effecter_id])
-                .c_str());
+        return std::make_pair(namePDR->effecter_id, std::move(*name));
     }
+    return std::nullopt;
+}
+
+void PDRManager::addEffecterAuxName(const EffecterID effecterID,
+                                    const std::string& name)
+{
+    // Cache the Effecter Auxiliary Names
+    _effecterAuxNames[effecterID] = _deviceAuxName + "_" + name;
+
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        ("EffecterID:" + std::to_string(static_cast<int>(effecterID)) +
+         " Effecter Auxiliary Name: " + _effecterAuxNames[effecterID])
+            .c_str());
 }
 
 static void populateNumericSensor(DBusInterfacePtr& sensorIntf,
@@ -1103,7 +1156,8 @@ std::optional<DBusObjectPath>
     return entityPath + "/" + sensorName;
 }
 
-void PDRManager::parseNumericSensorPDR(std ::vector<uint8_t>& pdrData)
+static std::optional<pldm_numeric_sensor_value_pdr>
+    decodeNumericSensorPDR(const pldm_tid_t tid, std::vector<uint8_t>& pdrData)
 {
     std::vector<uint8_t> pdrOut(sizeof(pldm_numeric_sensor_value_pdr), 0);
 
@@ -1113,23 +1167,26 @@ void PDRManager::parseNumericSensorPDR(std ::vector<uint8_t>& pdrData)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Numeric Sensor PDR parsing failed",
-            phosphor::logging::entry("TID=%d", _tid));
-        return;
+            phosphor::logging::entry("TID=%d", tid));
+        return std::nullopt;
     }
-    pldm_numeric_sensor_value_pdr* sensorPDR =
-        reinterpret_cast<pldm_numeric_sensor_value_pdr*>(pdrOut.data());
-    uint16_t sensorID = sensorPDR->sensor_id;
+    return *reinterpret_cast<pldm_numeric_sensor_value_pdr*>(pdrOut.data());
+}
+
+void PDRManager::addNumericSensor(
+    const pldm_numeric_sensor_value_pdr& sensorPDR)
+{
+    uint16_t sensorID = sensorPDR.sensor_id;
 
     std::shared_ptr<pldm_numeric_sensor_value_pdr> numericSensorPDR =
-        std::make_shared<pldm_numeric_sensor_value_pdr>(*sensorPDR);
+        allocateShared<pldm_numeric_sensor_value_pdr>(&_arena, sensorPDR);
 
     _numericSensorPDR.emplace(sensorID, std::move(numericSensorPDR));
 
-    pldm_entity entity = {sensorPDR->entity_type,
-                          sensorPDR->entity_instance_num,
-                          sensorPDR->container_id};
+    pldm_entity entity = {sensorPDR.entity_type, sensorPDR.entity_instance_num,
+                          sensorPDR.container_id};
     std::optional<DBusObjectPath> sensorPath = createSensorObjPath(
-        entity, sensorID, sensorPDR->sensor_auxiliary_names_pdr);
+        entity, sensorID, sensorPDR.sensor_auxiliary_names_pdr);
     if (!sensorPath)
     {
         return;
@@ -1152,7 +1209,15 @@ static void populateStateSensor(DBusInterfacePtr& sensorIntf,
     sensorIntf->initialize();
 }
 
-void PDRManager::parseStateSensorPDR(std::vector<uint8_t>& pdrData)
+// State sensor PDR with the possible states of every composite sensor offset
+struct DecodedStateSensor
+{
+    pldm_state_sensor_pdr stateSensorData;
+    std::vector<PossibleStates> possibleStates;
+};
+
+static std::optional<DecodedStateSensor>
+    decodeStateSensorPDR(const pldm_tid_t tid, std::vector<uint8_t>& pdrData)
 {
     // Without composite sensor support there is only one instance of sensor
     // possible states.
@@ -1164,9 +1229,9 @@ void PDRManager::parseStateSensorPDR(std::vector<uint8_t>& pdrData)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "State Sensor PDR length invalid or sensor disabled",
-            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("TID=%d", tid),
             phosphor::logging::entry("PDR_SIZE=%d", pdrData.size()));
-        return;
+        return std::nullopt;
     }
 
     pldm_state_sensor_pdr* sensorPDR =
@@ -1178,65 +1243,82 @@ void PDRManager::parseStateSensorPDR(std::vector<uint8_t>& pdrData)
 
     uint16_t sensorID = sensorPDR->sensor_id;
 
-    // TODO: Composite sensor support
-    if (sensorPDR->composite_sensor_count > 0x01)
+    const uint8_t compositeSensorCount = sensorPDR->composite_sensor_count;
+    if (compositeSensorCount == 0 ||
+        compositeSensorCount > maxCompositeSensorCount)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Composite state sensor not supported",
-            phosphor::logging::entry("TID=%d", _tid),
+            "Invalid composite state sensor count",
+            phosphor::logging::entry("TID=%d", tid),
             phosphor::logging::entry("SENSOR_ID=0x%x", sensorID),
             phosphor::logging::entry("COMPOSITE_SENSOR_COUNT=%d",
-                                     sensorPDR->composite_sensor_count));
+                                     compositeSensorCount));
+        return std::nullopt;
     }
 
-    state_sensor_possible_states* possibleState =
-        reinterpret_cast<state_sensor_possible_states*>(
-            sensorPDR->possible_states);
-    LE16TOH(possibleState->state_set_id);
+    DecodedStateSensor stateSensor{*sensorPDR, {}};
+    stateSensor.possibleStates.reserve(compositeSensorCount);
 
-    if (pdrData.size() < sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t) +
-                             sizeof(state_sensor_possible_states) -
-                             sizeof(uint8_t) +
-                             possibleState->possible_states_size)
+    // Possible states of every composite sensor offset follow each other, each
+    // one sized by its possible_states_size
+    constexpr size_t possibleStatesHdrSize =
+        sizeof(state_sensor_possible_states) - sizeof(bitfield8_t);
+    size_t possibleStatesOffset =
+        sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t);
+    for (uint8_t count = 0; count < compositeSensorCount; count++)
     {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Invalid State Sensor PDR length",
-            phosphor::logging::entry("TID=%d", _tid));
-        return;
-    }
+        if (pdrData.size() < possibleStatesOffset + possibleStatesHdrSize)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Invalid State Sensor PDR length",
+                phosphor::logging::entry("TID=%d", tid));
+            return std::nullopt;
+        }
+        state_sensor_possible_states* possibleState =
+            reinterpret_cast<state_sensor_possible_states*>(
+                pdrData.data() + possibleStatesOffset);
+        LE16TOH(possibleState->state_set_id);
 
-    PossibleStates possibleStates;
-    possibleStates.stateSetID = possibleState->state_set_id;
-    // Max possibleStateSize as per spec DSP0248 Table 81
-    constexpr uint8_t maxPossibleStatesSize = 0x20;
-    int position = 0;
-    for (uint8_t count = 0; count < possibleState->possible_states_size &&
-                            count < maxPossibleStatesSize;
-         count++)
-    {
-        for (uint8_t bits = 0; bits < 8; bits++)
+        if (pdrData.size() < possibleStatesOffset + possibleStatesHdrSize +
+                                 possibleState->possible_states_size)
         {
-            if (possibleState->states[count].byte & (0x01 << bits))
-            {
-                possibleStates.possibleStateSetValues.emplace(position);
-            }
-            position++;
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Invalid State Sensor PDR length",
+                phosphor::logging::entry("TID=%d", tid));
+            return std::nullopt;
         }
+
+        PossibleStates possibleStates;
+        possibleStates.stateSetID = possibleState->state_set_id;
+        possibleStates.possibleStateSetValues = getPossibleStateSet(
+            possibleState->states, possibleState->possible_states_size);
+        stateSensor.possibleStates.emplace_back(std::move(possibleStates));
+        possibleStatesOffset +=
+            possibleStatesHdrSize + possibleState->possible_states_size;
     }
+    return stateSensor;
+}
+
+void PDRManager::addStateSensor(
+    const pldm_state_sensor_pdr& sensorPDR,
+    const std::vector<PossibleStates>& possibleStates)
+{
+    uint16_t sensorID = sensorPDR.sensor_id;
 
-    // Cache PDR for later use
     std::shared_ptr<StateSensorPDR> stateSensorPDR =
-        std::make_shared<StateSensorPDR>();
-    stateSensorPDR->stateSensorData = *sensorPDR;
-    // TODO: Multiple state sets in case of composite state sensor
-    stateSensorPDR->possibleStates.emplace_back(std::move(possibleStates));
+        allocateShared<StateSensorPDR>(&_arena, &_arena);
+    stateSensorPDR->stateSensorData = sensorPDR;
+    stateSensorPDR->possibleStates.assign(possibleStates.begin(),
+                                          possibleStates.end());
+
+    // Cache PDR for later use
     _stateSensorPDR.emplace(sensorID, std::move(stateSensorPDR));
 
-    pldm_entity entity = {sensorPDR->entity_type, sensorPDR->entity_instance,
-                          sensorPDR->container_id};
+    pldm_entity entity = {sensorPDR.entity_type, sensorPDR.entity_instance,
+                          sensorPDR.container_id};
 
     std::optional<DBusObjectPath> sensorPath = createSensorObjPath(
-        entity, sensorID, sensorPDR->sensor_auxiliary_names_pdr);
+        entity, sensorID, sensorPDR.sensor_auxiliary_names_pdr);
     if (!sensorPath)
     {
         return;
@@ -1317,7 +1399,9 @@ std::optional<DBusObjectPath>
     return *entityPath + "/" + *effecterName;
 }
 
-void PDRManager::parseNumericEffecterPDR(std::vector<uint8_t>& pdrData)
+static std::optional<pldm_numeric_effecter_value_pdr>
+    decodeNumericEffecterPDR(const pldm_tid_t tid,
+                             std::vector<uint8_t>& pdrData)
 {
     std::vector<uint8_t> pdrOut(sizeof(pldm_numeric_effecter_value_pdr), 0);
 
@@ -1327,18 +1411,20 @@ void PDRManager::parseNumericEffecterPDR(std::vector<uint8_t>& pdrData)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Numeric effecter PDR parsing failed",
-            phosphor::logging::entry("TID=%d", _tid));
-        return;
+            phosphor::logging::entry("TID=%d", tid));
+        return std::nullopt;
     }
-    pldm_numeric_effecter_value_pdr* effecterPDR =
-        reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrOut.data());
+    return *reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrOut.data());
+}
 
-    uint16_t effecterID = effecterPDR->effecter_id;
-    pldm_entity entity = {effecterPDR->entity_type,
-                          effecterPDR->entity_instance,
-                          effecterPDR->container_id};
+void PDRManager::addNumericEffecter(
+    const pldm_numeric_effecter_value_pdr& effecterPDR)
+{
+    uint16_t effecterID = effecterPDR.effecter_id;
+    pldm_entity entity = {effecterPDR.entity_type, effecterPDR.entity_instance,
+                          effecterPDR.container_id};
     std::optional<DBusObjectPath> effecterPath = createEffecterObjPath(
-        entity, effecterID, effecterPDR->effecter_auxiliary_names);
+        entity, effecterID, effecterPDR.effecter_auxiliary_names);
     if (!effecterPath)
     {
         return;
@@ -1350,7 +1436,7 @@ void PDRManager::parseNumericEffecterPDR(std::vector<uint8_t>& pdrData)
                           std::make_pair(effecterIntf, *effecterPath));
 
     std::shared_ptr<pldm_numeric_effecter_value_pdr> numericEffectorPDR =
-        std::make_shared<pldm_numeric_effecter_value_pdr>(*effecterPDR);
+        allocateShared<pldm_numeric_effecter_value_pdr>(&_arena, effecterPDR);
 
     _numericEffecterPDR.emplace(effecterID, std::move(numericEffectorPDR));
 }
@@ -1368,7 +1454,15 @@ static void populateStateEffecter(DBusInterfacePtr& effecterIntf,
     effecterIntf->initialize();
 }
 
-void PDRManager::parseStateEffecterPDR(std::vector<uint8_t>& pdrData)
+// State effecter PDR with the possible states of its first effecter
+struct DecodedStateEffecter
+{
+    pldm_state_effecter_pdr stateEffecterData;
+    PossibleStates possibleStates;
+};
+
+static std::optional<DecodedStateEffecter>
+    decodeStateEffecterPDR(const pldm_tid_t tid, std::vector<uint8_t>& pdrData)
 {
     // Without composite effecter support there is only one instance of
     // effecter possible states
@@ -1380,8 +1474,8 @@ void PDRManager::parseStateEffecterPDR(std::vector<uint8_t>& pdrData)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "State effecter PDR length invalid or effecter disabled",
-            phosphor::logging::entry("TID=%d", _tid));
-        return;
+            phosphor::logging::entry("TID=%d", tid));
+        return std::nullopt;
     }
 
     pldm_state_effecter_pdr* effecterPDR =
@@ -1399,7 +1493,7 @@ void PDRManager::parseStateEffecterPDR(std::vector<uint8_t>& pdrData)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Composite state effecter not supported",
-            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("TID=%d", tid),
             phosphor::logging::entry("EFFECTER_ID=0x%x", effecterID));
     }
 
@@ -1415,41 +1509,34 @@ void PDRManager::parseStateEffecterPDR(std::vector<uint8_t>& pdrData)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "State Effecter PDR length invalid",
-            phosphor::logging::entry("TID=%d", _tid));
-        return;
+            phosphor::logging::entry("TID=%d", tid));
+        return std::nullopt;
     }
 
     PossibleStates possibleStates;
     possibleStates.stateSetID = possibleState->state_set_id;
-    constexpr uint8_t maxPossibleStatesSize = 0x20;
-    int position = 0;
-    for (uint8_t count = 0; count < possibleState->possible_states_size &&
-                            count < maxPossibleStatesSize;
-         count++)
-    {
-        for (size_t bits = 0; bits < 8; bits++)
-        {
-            if (possibleState->states[count].byte & (0x01 << bits))
-            {
-                possibleStates.possibleStateSetValues.emplace(position);
-            }
-            position++;
-        }
-    }
+    possibleStates.possibleStateSetValues = getPossibleStateSet(
+        possibleState->states, possibleState->possible_states_size);
+    return DecodedStateEffecter{*effecterPDR, possibleStates};
+}
+
+void PDRManager::addStateEffecter(const pldm_state_effecter_pdr& effecterPDR,
+                                  const PossibleStates& possibleStates)
+{
+    uint16_t effecterID = effecterPDR.effecter_id;
 
     // Cache PDR for later use
     std::shared_ptr<StateEffecterPDR> stateEffecterPDR =
-        std::make_shared<StateEffecterPDR>();
-    stateEffecterPDR->stateEffecterData = *effecterPDR;
+        allocateShared<StateEffecterPDR>(&_arena, &_arena);
+    stateEffecterPDR->stateEffecterData = effecterPDR;
     // TODO: Multiple state sets in case of composite state effecter
-    stateEffecterPDR->possibleStates.emplace_back(std::move(possibleStates));
+    stateEffecterPDR->possibleStates.emplace_back(possibleStates);
     _stateEffecterPDR.emplace(effecterID, std::move(stateEffecterPDR));
 
-    pldm_entity entity = {effecterPDR->entity_type,
-                          effecterPDR->entity_instance,
-                          effecterPDR->container_id};
+    pldm_entity entity = {effecterPDR.entity_type, effecterPDR.entity_instance,
+                          effecterPDR.container_id};
     std::optional<DBusObjectPath> effecterPath = createEffecterObjPath(
-        entity, effecterID, effecterPDR->has_description_pdr);
+        entity, effecterID, effecterPDR.has_description_pdr);
     if (!effecterPath)
     {
         return;
@@ -1476,14 +1563,15 @@ static void populateFRURecordSet(DBusInterfacePtr& fruRSIntf,
     fruRSIntf->initialize();
 }
 
-void PDRManager::parseFRURecordSetPDR(std::vector<uint8_t>& pdrData)
+static std::optional<std::pair<pldm_entity, FRURecordSetIdentifier>>
+    decodeFRURecordSetPDR(const pldm_tid_t tid, std::vector<uint8_t>& pdrData)
 {
     if (pdrData.size() != sizeof(pldm_fru_record_set_pdr))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "FRU Record Set PDR length invalid",
-            phosphor::logging::entry("TID=%d", _tid));
-        return;
+            phosphor::logging::entry("TID=%d", tid));
+        return std::nullopt;
     }
 
     pldm_fru_record_set_pdr* fruRecordSetPDR =
@@ -1497,7 +1585,12 @@ void PDRManager::parseFRURecordSetPDR(std::vector<uint8_t>& pdrData)
                           fruRecordSetPDR->fru_record_set.entity_instance_num,
                           fruRecordSetPDR->fru_record_set.container_id};
     FRURecordSetIdentifier fruRSI = fruRecordSetPDR->fru_record_set.fru_rsi;
+    return std::make_pair(entity, fruRSI);
+}
 
+void PDRManager::addFRURecordSet(const pldm_entity& entity,
+                                 const FRURecordSetIdentifier fruRSI)
+{
     std::optional<DBusObjectPath> fruRSPath = getEntityObjectPath(entity);
     if (!fruRSPath)
     {
@@ -1515,82 +1608,115 @@ void PDRManager::parseFRURecordSetPDR(std::vector<uint8_t>& pdrData)
     _fruRecordSetIntf.emplace(fruRSI, std::make_pair(fruRSIntf, *fruRSPath));
 }
 
-template <pldm_pdr_types pdrType>
-void PDRManager::parsePDR()
+// Call decode with a copy of every PDR of pdrType in the repo
+template <pldm_pdr_types pdrType, typename Decode>
+static void forEachPDR(const pldm_pdr* pdrRepo, Decode&& decode)
 {
     size_t count = 0;
     uint8_t* pdrData = nullptr;
     uint32_t pdrSize{};
-    auto record = pldm_pdr_find_record_by_type(_pdrRepo.get(), pdrType, NULL,
+    auto record = pldm_pdr_find_record_by_type(pdrRepo, pdrType, NULL,
                                                &pdrData, &pdrSize);
     while (record)
     {
         std::vector<uint8_t> pdrVec(pdrData, pdrData + pdrSize);
-        // TODO: Move Entity Auxiliary Name PDR and Entity Association PDR
-        // parsing here
-        if constexpr (pdrType == PLDM_SENSOR_AUXILIARY_NAMES_PDR)
-        {
-            parseSensorAuxNamesPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_EFFECTER_AUXILIARY_NAMES_PDR)
-        {
-            parseEffecterAuxNamesPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_NUMERIC_SENSOR_PDR)
-        {
-            parseNumericSensorPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_STATE_SENSOR_PDR)
-        {
-            parseStateSensorPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_NUMERIC_EFFECTER_PDR)
-        {
-            parseNumericEffecterPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_STATE_EFFECTER_PDR)
-        {
-            parseStateEffecterPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_PDR_FRU_RECORD_SET)
-        {
-            parseFRURecordSetPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_ENTITY_AUXILIARY_NAMES_PDR)
-        {
-            parseEntityAuxNamesPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_PDR_ENTITY_ASSOCIATION)
-        {
-            parseEntityAssociationPDR(pdrVec);
-        }
-        else
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Not supported. Unknown PDR type");
-            return;
-        }
+        decode(pdrVec);
 
         count++;
         pdrData = nullptr;
         pdrSize = 0;
-        record = pldm_pdr_find_record_by_type(_pdrRepo.get(), pdrType, record,
+        record = pldm_pdr_find_record_by_type(pdrRepo, pdrType, record,
                                               &pdrData, &pdrSize);
     }
 
-    if constexpr (pdrType == PLDM_PDR_ENTITY_ASSOCIATION)
-    {
-        if (entityAssociationNodes.size())
-        {
-            createEntityAssociationTree(entityAssociationNodes);
-        }
-    }
     phosphor::logging::log<phosphor::logging::level::DEBUG>(
         ("Number of type " + std::to_string(pdrType) +
          " PDR parsed: " + std::to_string(count))
             .c_str());
 }
 
+// PDRs of a terminus decoded by decodePDRs, in repo order per type
+struct DecodedPDRs
+{
+    EntityAuxNames entityAuxNames;
+    std::vector<std::vector<pldm_entity>> entityAssociations;
+    std::vector<std::pair<SensorID, std::string>> sensorAuxNames;
+    std::vector<std::pair<EffecterID, std::string>> effecterAuxNames;
+    std::vector<pldm_numeric_sensor_value_pdr> numericSensors;
+    std::vector<DecodedStateSensor> stateSensors;
+    std::vector<pldm_numeric_effecter_value_pdr> numericEffecters;
+    std::vector<DecodedStateEffecter> stateEffecters;
+    std::vector<std::pair<pldm_entity, FRURecordSetIdentifier>> fruRecordSets;
+};
+
+// Decode every supported PDR of the repo. Runs on a worker thread, thus it
+// only reads the repo and must not touch D-Bus or the PDRManager arena
+static DecodedPDRs decodePDRs(const pldm_pdr* pdrRepo, const pldm_tid_t tid)
+{
+    DecodedPDRs decoded;
+    forEachPDR<PLDM_ENTITY_AUXILIARY_NAMES_PDR>(
+        pdrRepo, [&decoded](std::vector<uint8_t>& pdrData) {
+            decodeEntityAuxNamesPDR(pdrData, decoded.entityAuxNames);
+        });
+    forEachPDR<PLDM_PDR_ENTITY_ASSOCIATION>(
+        pdrRepo, [&decoded, tid](std::vector<uint8_t>& pdrData) {
+            if (auto entities = decodeEntityAssociationPDR(tid, pdrData))
+            {
+                decoded.entityAssociations.emplace_back(std::move(*entities));
+            }
+        });
+    forEachPDR<PLDM_SENSOR_AUXILIARY_NAMES_PDR>(
+        pdrRepo, [&decoded](std::vector<uint8_t>& pdrData) {
+            if (auto name = decodeSensorAuxNamesPDR(pdrData))
+            {
+                decoded.sensorAuxNames.emplace_back(std::move(*name));
+            }
+        });
+    forEachPDR<PLDM_EFFECTER_AUXILIARY_NAMES_PDR>(
+        pdrRepo, [&decoded](std::vector<uint8_t>& pdrData) {
+            if (auto name = decodeEffecterAuxNamesPDR(pdrData))
+            {
+                decoded.effecterAuxNames.emplace_back(std::move(*name));
+            }
+        });
+    forEachPDR<PLDM_NUMERIC_SENSOR_PDR>(
+        pdrRepo, [&decoded, tid](std::vector<uint8_t>& pdrData) {
+            if (auto sensorPDR = decodeNumericSensorPDR(tid, pdrData))
+            {
+                decoded.numericSensors.emplace_back(*sensorPDR);
+            }
+        });
+    forEachPDR<PLDM_STATE_SENSOR_PDR>(
+        pdrRepo, [&decoded, tid](std::vector<uint8_t>& pdrData) {
+            if (auto sensorPDR = decodeStateSensorPDR(tid, pdrData))
+            {
+                decoded.stateSensors.emplace_back(std::move(*sensorPDR));
+            }
+        });
+    forEachPDR<PLDM_NUMERIC_EFFECTER_PDR>(
+        pdrRepo, [&decoded, tid](std::vector<uint8_t>& pdrData) {
+            if (auto effecterPDR = decodeNumericEffecterPDR(tid, pdrData))
+            {
+                decoded.numericEffecters.emplace_back(*effecterPDR);
+            }
+        });
+    forEachPDR<PLDM_STATE_EFFECTER_PDR>(
+        pdrRepo, [&decoded, tid](std::vector<uint8_t>& pdrData) {
+            if (auto effecterPDR = decodeStateEffecterPDR(tid, pdrData))
+            {
+                decoded.stateEffecters.emplace_back(*effecterPDR);
+            }
+        });
+    forEachPDR<PLDM_PDR_FRU_RECORD_SET>(
+        pdrRepo, [&decoded, tid](std::vector<uint8_t>& pdrData) {
+            if (auto fruRecordSet = decodeFRURecordSetPDR(tid, pdrData))
+            {
+                decoded.fruRecordSets.emplace_back(*fruRecordSet);
+            }
+        });
+    return decoded;
+}
+
 std::optional<std::shared_ptr<pldm_numeric_sensor_value_pdr>>
     PDRManager::getNumericSensorPDR(const SensorID& sensorID)
 {
@@ -1656,21 +1782,61 @@ bool PDRManager::pdrManagerInit(boost::asio::yield_context yield)
 
     initializePDRDumpIntf();
 
-    parsePDR<PLDM_ENTITY_AUXILIARY_NAMES_PDR>();
-    parsePDR<PLDM_PDR_ENTITY_ASSOCIATION>();
+    // Decoding does not need D-Bus, keep it off the io_context. The D-Bus
+    // objects are created below, on the io_context, in the same order.
+    DecodedPDRs decoded =
+        runOnWorker(yield, [pdrRepo = _pdrRepo.get(), tid = _tid]() {
+            return decodePDRs(pdrRepo, tid);
+        });
+
+    for (const auto& [entity, name] : decoded.entityAuxNames)
+    {
+        // Cache the Entity Auxiliary Names
+        _entityAuxNames.emplace(entity, name);
+    }
+    for (const auto& entities : decoded.entityAssociations)
+    {
+        addEntityAssociation(entities);
+    }
+    if (entityAssociationNodes.size())
+    {
+        createEntityAssociationTree(entityAssociationNodes);
+    }
     getEntityAssociationPaths(_entityAssociationTree, {});
     populateSystemHierarchy();
     extractDeviceAuxName(_entityAssociationTree);
 #ifdef EXPOSE_CHASSIS
     initializeInventoryIntf();
 #endif
-    parsePDR<PLDM_SENSOR_AUXILIARY_NAMES_PDR>();
-    parsePDR<PLDM_EFFECTER_AUXILIARY_NAMES_PDR>();
-    parsePDR<PLDM_NUMERIC_SENSOR_PDR>();
-    parsePDR<PLDM_STATE_SENSOR_PDR>();
-    parsePDR<PLDM_NUMERIC_EFFECTER_PDR>();
-    parsePDR<PLDM_STATE_EFFECTER_PDR>();
-    parsePDR<PLDM_PDR_FRU_RECORD_SET>();
+    for (const auto& [sensorID, name] : decoded.sensorAuxNames)
+    {
+        addSensorAuxName(sensorID, name);
+    }
+    for (const auto& [effecterID, name] : decoded.effecterAuxNames)
+    {
+        addEffecterAuxName(effecterID, name);
+    }
+    for (const auto& sensorPDR : decoded.numericSensors)
+    {
+        addNumericSensor(sensorPDR);
+    }
+    for (const auto& sensorPDR : decoded.stateSensors)
+    {
+        addStateSensor(sensorPDR.stateSensorData, sensorPDR.possibleStates);
+    }
+    for (const auto& effecterPDR : decoded.numericEffecters)
+    {
+        addNumericEffecter(effecterPDR);
+    }
+    for (const auto& effecterPDR : decoded.stateEffecters)
+    {
+        addStateEffecter(effecterPDR.stateEffecterData,
+                         effecterPDR.possibleStates);
+    }
+    for (const auto& [entity, fruRSI] : decoded.fruRecordSets)
+    {
+        addFRURecordSet(entity, fruRSI);
+    }
 
     return true;
 }
@@ -1707,42 +1873,49 @@ void PDRManager::initializePDRDumpIntf()
     auto objServer = getObjServer();
     pdrDumpInterface =
         objServer->add_interface(pldmDevObj, "xyz.openbmc_project.PLDM.PDR");
-    pdrDumpInterface->register_method("DumpPDR", [this](void) {
-        uint32_t noOfRecords = pldm_pdr_get_record_count(_pdrRepo.get());
-        if (!noOfRecords)
-        {
-            phosphor::logging::log<phosphor::logging::level::INFO>(
-                "PDR repo empty!");
-            return;
-        }
-
-        std::unique_ptr<PDRDump> pdrDump = std::make_unique<PDRDump>(
-            "/tmp/pldm_pdr_dump_" + std::to_string(_tid) + ".txt");
-
-        for (uint8_t pdrType = PLDM_TERMINUS_LOCATOR_PDR;
-             pdrType != PLDM_OEM_PDR; pdrType++)
-        {
-
-            uint8_t* pdrData = nullptr;
-            uint32_t pdrSize{};
-            auto record = pldm_pdr_find_record_by_type(
-                _pdrRepo.get(), pdrType, NULL, &pdrData, &pdrSize);
-            while (record)
+    pdrDumpInterface->register_method(
+        "DumpPDR", [this](boost::asio::yield_context yield) {
+            uint32_t noOfRecords = pldm_pdr_get_record_count(_pdrRepo.get());
+            if (!noOfRecords)
             {
-                std::vector<uint8_t> pdrVec(pdrData, pdrData + pdrSize);
-                pdrDump->dumpPDRData(pdrVec);
+                phosphor::logging::log<phosphor::logging::level::INFO>(
+                    "PDR repo empty!");
+                return;
+            }
 
-                if (!(--noOfRecords))
+            // Only copying the records is done on the io_context thread,
+            // formatting and writing the dump is done by the worker pool
+            std::vector<std::vector<uint8_t>> pdrRecords;
+            pdrRecords.reserve(noOfRecords);
+            for (uint8_t pdrType = PLDM_TERMINUS_LOCATOR_PDR;
+                 pdrType != PLDM_OEM_PDR && pdrRecords.size() < noOfRecords;
+                 pdrType++)
+            {
+                uint8_t* pdrData = nullptr;
+                uint32_t pdrSize{};
+                auto record = pldm_pdr_find_record_by_type(
+                    _pdrRepo.get(), pdrType, NULL, &pdrData, &pdrSize);
+                while (record && pdrRecords.size() < noOfRecords)
                 {
-                    return;
+                    pdrRecords.emplace_back(pdrData, pdrData + pdrSize);
+                    pdrData = nullptr;
+                    pdrSize = 0;
+                    record = pldm_pdr_find_record_by_type(
+                        _pdrRepo.get(), pdrType, record, &pdrData, &pdrSize);
                 }
-                pdrData = nullptr;
-                pdrSize = 0;
-                record = pldm_pdr_find_record_by_type(
-                    _pdrRepo.get(), pdrType, record, &pdrData, &pdrSize);
             }
-        }
-    });
+
+            std::string fileName =
+                "/tmp/pldm_pdr_dump_" + std::to_string(_tid) + ".txt";
+            runOnWorker(yield, [&pdrRecords, &fileName]() {
+                PDRDump pdrDump(fileName);
+                for (const auto& pdrVec : pdrRecords)
+                {
+                    pdrDump.dumpPDRData(pdrVec);
+                }
+                return true;
+            });
+        });
     pdrDumpInterface->initialize();
 }
 } // namespace platform
@@ -26,7 +26,7 @@ static constexpr const int pollIntervalMillisec = 500;
 static constexpr const int pauseIntervalMillisec = 1;
 static Platform platform;
 
-bool Platform::induceAsyncDelay(boost::asio::yield_context yield, int delay)
+boost::asio::awaitable<bool> Platform::induceAsyncDelay(int delay)
 {
     if (!sensorTimer)
     {
@@ -35,18 +35,19 @@ bool Platform::induceAsyncDelay(boost::asio::yield_context yield, int delay)
 
     boost::system::error_code ec;
     sensorTimer->expires_after(boost::asio::chrono::milliseconds(delay));
-    sensorTimer->async_wait(yield[ec]);
+    co_await sensorTimer->async_wait(
+        boost::asio::redirect_error(boost::asio::use_awaitable, ec));
     if (ec == boost::asio::error::operation_aborted)
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "Sensor poll timer aborted");
-        return false;
+        co_return false;
     }
     else if (ec)
     {
         throw std::runtime_error("Sensor poll timer failed");
     }
-    return true;
+    co_return true;
 }
 
 // TODO: Dynamic sensor scanning
@@ -55,7 +56,7 @@ bool Platform::induceAsyncDelay(boost::asio::yield_context yield, int delay)
 // associated sensors. Which will result in higher number(M*N) of PLDM
 // message traffic through mux. In this case mux switching is a constraint.
 // Thus poll sensors sequentially.
-void Platform::doPoll(boost::asio::yield_context yield)
+boost::asio::awaitable<void> Platform::doPoll()
 {
     isSensorPollRunning = false;
     for (auto [tid, platformTerminus] : platforms)
@@ -73,14 +74,14 @@ void Platform::doPoll(boost::asio::yield_context yield)
             }
             isSensorPollRunning = true;
 
-            numericSensorHandler->populateSensorValue(yield);
-            if (!induceAsyncDelay(yield, pollIntervalMillisec))
+            co_await numericSensorHandler->populateSensorValue();
+            if (!co_await induceAsyncDelay(pollIntervalMillisec))
             {
-                return;
+                co_return;
             }
             if (stopSensorPoll)
             {
-                return;
+                co_return;
             }
         }
         for (auto const& [sensorID, stateSensorHandler] :
@@ -96,14 +97,14 @@ void Platform::doPoll(boost::asio::yield_context yield)
             }
             isSensorPollRunning = true;
 
-            stateSensorHandler->populateSensorValue(yield);
-            if (!induceAsyncDelay(yield, pollIntervalMillisec))
+            co_await stateSensorHandler->populateSensorValue();
+            if (!co_await induceAsyncDelay(pollIntervalMillisec))
             {
-                return;
+                co_return;
             }
             if (stopSensorPoll)
             {
-                return;
+                co_return;
             }
         }
     }
@@ -117,22 +118,23 @@ void Platform::doPoll(boost::asio::yield_context yield)
 // polling loop with caller.
 void Platform::pollAllSensors()
 {
-    boost::asio::spawn(
-        *getIoContext(), [this](boost::asio::yield_context yield) {
+    boost::asio::co_spawn(
+        *getIoContext(),
+        [this]() -> boost::asio::awaitable<void> {
             while (1)
             {
                 if (!startSensorPoll)
                 {
                     try
                     {
-                        induceAsyncDelay(yield, pauseIntervalMillisec);
+                        co_await induceAsyncDelay(pauseIntervalMillisec);
                         continue;
                     }
                     catch (const std::exception& e)
                     {
                         phosphor::logging::log<phosphor::logging::level::ERR>(
                             e.what());
-                        return;
+                        co_return;
                     }
                 }
 
@@ -140,13 +142,13 @@ void Platform::pollAllSensors()
                 {
                     try
                     {
-                        doPoll(yield);
+                        co_await doPoll();
                     }
                     catch (const std::exception& e)
                     {
                         phosphor::logging::log<phosphor::logging::level::ERR>(
                             e.what());
-                        return;
+                        co_return;
                     }
 
                     if (!isSensorPollRunning)
@@ -154,12 +156,13 @@ void Platform::pollAllSensors()
                         sensorTimer.reset();
                         phosphor::logging::log<phosphor::logging::level::INFO>(
                             "Sensor polling terminated");
-                        return;
+                        co_return;
                     }
                 } while (!stopSensorPoll);
                 stopSensorPoll = false;
             }
-        });
+        },
+        boost::asio::detached);
 }
 
 void Platform::startSensorPolling()
@@ -199,7 +202,8 @@ void Platform::stopSensorPolling()
 
 std::optional<UUID> getTerminusUID(boost::asio::yield_context yield,
                                    const pldm_tid_t tid,
-                                   std::optional<mctpw_eid_t> eid)
+                                   std::optional<mctpw_eid_t> eid,
+                                   const size_t retryCount)
 {
     static constexpr size_t hdrSize = sizeof(PLDMEmptyRequest);
     uint8_t instanceID = createInstanceId(tid);
@@ -213,7 +217,7 @@ std::optional<UUID> getTerminusUID(boost::asio::yield_context yield,
     }
 
     std::vector<uint8_t> getUIDResponse;
-    if (!sendReceivePldmMessage(yield, tid, commandTimeout, commandRetryCount,
+    if (!sendReceivePldmMessage(yield, tid, commandTimeout, retryCount,
                                 getUIDRequest, getUIDResponse, eid))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -282,9 +286,30 @@ void Platform::initializePlatformIntf()
             platformInit(yield, tid, {});
             resumeSensorPolling();
         });
+    // Returns TID, sensor count, effecter count, D-Bus interface count and
+    // estimated bytes of every terminus
+    platformInterface->register_method("GetMemoryUsage",
+                                       [this]() { return getMemoryUsage(); });
     platformInterface->initialize();
 }
 
+std::vector<std::tuple<pldm_tid_t, uint32_t, uint32_t, uint32_t, uint64_t>>
+    Platform::getMemoryUsage() const
+{
+    std::vector<std::tuple<pldm_tid_t, uint32_t, uint32_t, uint32_t, uint64_t>>
+        report;
+    report.reserve(platforms.size());
+    for (const auto& [tid, platformTerminus] : platforms)
+    {
+        const MemoryUsage usage = platformTerminus->getMemoryUsage();
+        report.emplace_back(tid, static_cast<uint32_t>(usage.sensors),
+                            static_cast<uint32_t>(usage.effecters),
+                            static_cast<uint32_t>(usage.dbusInterfaces),
+                            usage.bytes);
+    }
+    return report;
+}
+
 bool Platform::isTerminusRemoved(const pldm_tid_t tid)
 {
     return tidsUnderInitialization.count(tid) == 0;
@@ -18,9 +18,11 @@
 
 #include "pldm.hpp"
 
+#include <boost/asio/spawn.hpp>
 #include <filesystem>
 #include <optional>
 #include <phosphor-logging/log.hpp>
+#include <sdbusplus/bus/match.hpp>
 #include <string>
 #include <unordered_map>
 
@@ -35,43 +37,119 @@ namespace association
 
 static constexpr const char* mctpConfigIntf =
     "xyz.openbmc_project.Configuration.MctpConfiguration";
+static constexpr const char* inventoryRoot = "/xyz/openbmc_project/inventory/";
+
+static std::optional<std::string> baseboardPath{};
+static std::unique_ptr<sdbusplus::bus::match::match> interfacesAddedMatch;
+static std::unique_ptr<sdbusplus::bus::match::match> interfacesRemovedMatch;
+static uint64_t inventoryGeneration = 0;
+static bool refreshInProgress = false;
+
+/** @brief Look up baseboard path from ObjectMapper without blocking the
+ * event loop
+ *  @return DBus path of baseboard, empty if not present. std::nullopt if
+ * ObjectMapper could not be queried
+ */
+static std::optional<std::string>
+    lookupBaseboardPath(boost::asio::yield_context yield)
+{
+    boost::system::error_code ec;
+    auto paths = getSdBus()->yield_method_call<std::vector<std::string>>(
+        yield, ec, "xyz.openbmc_project.ObjectMapper",
+        "/xyz/openbmc_project/object_mapper",
+        "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths", inventoryRoot, 0,
+        std::array<std::string, 1>({mctpConfigIntf}));
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to query ObjectMapper for the baseboard DBus object path",
+            phosphor::logging::entry("ERROR=%s", ec.message().c_str()));
+        return std::nullopt;
+    }
+
+    if (paths.empty() || paths[0].empty())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to get the baseboard DBus object path");
+        return std::string();
+    }
+    return std::filesystem::path(paths[0]).parent_path();
+}
+
+/** @brief Refresh the cached baseboard path in the background. Inventory
+ * changes signalled while a lookup is in flight trigger another lookup.
+ */
+static void refreshBaseboardPath()
+{
+    if (refreshInProgress)
+    {
+        return;
+    }
+    refreshInProgress = true;
+    boost::asio::spawn(*getIoContext(), [](boost::asio::yield_context yield) {
+        uint64_t generation = 0;
+        do
+        {
+            generation = inventoryGeneration;
+            if (auto path = lookupBaseboardPath(yield))
+            {
+                baseboardPath = std::move(path);
+            }
+        } while (generation != inventoryGeneration);
+        refreshInProgress = false;
+    });
+}
+
+/** @brief Keep serving the cached path until the refresh replaces it. The
+ * generation counter makes the refresh repeat if the inventory changes again.
+ */
+static void onInventoryChanged(sdbusplus::message::message&)
+{
+    inventoryGeneration++;
+    refreshBaseboardPath();
+}
+
+/** @brief Start tracking inventory changes and prefetch association paths */
+void init()
+{
+    auto bus = getSdBus();
+    interfacesAddedMatch = std::make_unique<sdbusplus::bus::match::match>(
+        *bus,
+        sdbusplus::bus::match::rules::interfacesAdded() +
+            sdbusplus::bus::match::rules::argNpath(0, inventoryRoot),
+        onInventoryChanged);
+    interfacesRemovedMatch = std::make_unique<sdbusplus::bus::match::match>(
+        *bus,
+        sdbusplus::bus::match::rules::interfacesRemoved() +
+            sdbusplus::bus::match::rules::argNpath(0, inventoryRoot),
+        onInventoryChanged);
+    refreshBaseboardPath();
+}
 
 /** @brief Get sensor association path
- *  @return DBus path of baseboard
+ *  @return DBus path of baseboard, empty if not resolved yet
  *
  *  @todo Use PldmConfiguration interface when it is implemented
  */
 std::string getPath(pldm_tid_t tid __attribute__((unused)))
 {
-    static std::optional<std::string> baseboardPath{};
+    return baseboardPath.value_or(std::string());
+}
 
+/** @brief Get sensor association path, resolving it if not cached
+ *  @return DBus path of baseboard
+ */
+std::string getPath(boost::asio::yield_context yield,
+                    pldm_tid_t tid __attribute__((unused)))
+{
     if (!baseboardPath.has_value())
     {
-        auto bus = getSdBus();
-        auto method_call = bus->new_method_call(
-            "xyz.openbmc_project.ObjectMapper",
-            "/xyz/openbmc_project/object_mapper",
-            "xyz.openbmc_project.ObjectMapper", "GetSubTreePaths");
-        method_call.append("/xyz/openbmc_project/inventory/", 0,
-                           std::array<std::string, 1>({mctpConfigIntf}));
-        auto reply = bus->call(method_call);
-
-        std::vector<std::string> paths;
-        reply.read(paths);
-
-        if (paths.empty() || paths[0].empty())
+        if (auto path = lookupBaseboardPath(yield))
         {
-            baseboardPath = "";
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Failed to get the baseboard DBus object path");
-        }
-        else
-        {
-            baseboardPath = std::filesystem::path(paths[0]).parent_path();
+            baseboardPath = std::move(path);
         }
     }
-
-    return baseboardPath.value();
+    return baseboardPath.value_or(std::string());
 }
 
 /** @brief Set sensor association path of tid*/
@@ -114,6 +192,15 @@ void setPath(pldm_tid_t tid, const std::string& path)
     devicePathMap.insert_or_assign(tid, path);
 }
 
+std::string getPath(boost::asio::yield_context /*yield*/, pldm_tid_t tid)
+{
+    return getPath(tid);
+}
+
+void init()
+{
+}
+
 #else
 
 /** @brief Get sensor association path
@@ -124,12 +211,22 @@ std::string getPath(pldm_tid_t tid __attribute__((unused)))
     return {};
 }
 
+std::string getPath(boost::asio::yield_context /*yield*/,
+                    pldm_tid_t tid __attribute__((unused)))
+{
+    return {};
+}
+
 /** @brief Set sensor association path of tid*/
 void setPath(pldm_tid_t tid __attribute__((unused)),
              const std::string& path __attribute__((unused)))
 {
 }
 
+void init()
+{
+}
+
 #endif
 
 } // namespace association
@@ -36,10 +36,31 @@ PlatformTerminus::PlatformTerminus(boost::asio::yield_context yield,
     initEffecters(yield);
 }
 
+MemoryUsage PlatformTerminus::getMemoryUsage() const
+{
+    MemoryUsage usage;
+    for (const auto& [sensorID, handler] : numericSensors)
+    {
+        handler->addMemoryUsage(usage);
+    }
+    for (const auto& [sensorID, handler] : stateSensors)
+    {
+        handler->addMemoryUsage(usage);
+    }
+    for (const auto& [effecterID, handler] : numericEffecters)
+    {
+        handler->addMemoryUsage(usage);
+    }
+    for (const auto& [effecterID, handler] : stateEffecters)
+    {
+        handler->addMemoryUsage(usage);
+    }
+    return usage;
+}
+
 void PlatformTerminus::initSensors(boost::asio::yield_context yield)
 {
-    std::unordered_map<SensorID, std::string> sensorList =
-        pdrManager->getSensors();
+    const IDMap<SensorID, std::string>& sensorList = pdrManager->getSensors();
 
     for (auto const& [sensorID, sensorName] : sensorList)
     {
@@ -93,7 +114,7 @@ void PlatformTerminus::initSensors(boost::asio::yield_context yield)
 
 void PlatformTerminus::initEffecters(boost::asio::yield_context yield)
 {
-    std::unordered_map<EffecterID, std::string> effecterList =
+    const IDMap<EffecterID, std::string>& effecterList =
         pdrManager->getEffecters();
 
     for (auto const& [effecterID, effecterName] : effecterList)
@@ -17,7 +17,10 @@
 
 #include "fwu_inventory.hpp"
 #include "platform.hpp"
+#include "utils.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <filesystem>
 #include <phosphor-logging/log.hpp>
 
@@ -29,6 +32,16 @@ const std::array<uint8_t, pkgHeaderIdentifierSize> pkgHdrIdentifier = {
     0xF0, 0x18, 0x87, 0x8C, 0xCB, 0x7D, 0x49, 0x43,
     0x98, 0x00, 0xA0, 0x2F, 0x05, 0x9A, 0xCA, 0x02};
 extern std::map<pldm_tid_t, FDProperties> terminusFwuProperties;
+constexpr size_t pkgHdrChecksumSize = 4;
+// DSP0267 v1.3 packages end the header with a payload checksum
+constexpr uint8_t pkgHdrFormatRevisionV13 = 0x04;
+constexpr size_t pkgPayloadChecksumSize = 4;
+// Chunk size used when streaming the package payload
+constexpr size_t pkgReadChunkSize = 64 * 1024;
+// Number of parsed package headers kept across updates
+constexpr size_t maxPkgHdrIndexCacheSize = 4;
+// Parsed package headers, least recently used first
+static std::deque<std::shared_ptr<PkgHdrIndex>> pkgHdrIndexCache;
 
 PLDMImg::PLDMImg(const std::string& pldmImgPath)
 {
@@ -129,19 +142,6 @@ bool PLDMImg::advanceHdrItr(const size_t dataSize, const size_t nextDataSize)
     return validateHdrDataLen(bytesLeft, nextDataSize);
 }
 
-void PLDMImg::copyPkgHdrInfoToMap(const struct PLDMPkgHeaderInfo* headerInfo,
-                                  const std::string& pkgVersionString)
-{
-    pkgFWUProperties["PkgHeaderFormatRevision"] =
-        headerInfo->pkgHeaderFormatRevision;
-    pkgFWUProperties["PkgHeaderSize"] = (headerInfo->pkgHeaderSize);
-    compBitmapBitLength = htole16(headerInfo->compBitmapBitLength);
-    pkgFWUProperties["CompBitmapBitLength"] = compBitmapBitLength;
-    pkgFWUProperties["PkgVersionStringType"] = headerInfo->pkgVersionStringType;
-    pkgFWUProperties["PkgVersionStringLen"] = headerInfo->pkgVersionStringLen;
-    pkgFWUProperties["PkgVersionString"] = pkgVersionString;
-}
-
 bool PLDMImg::processPkgHdrInfo()
 {
     hdrItr = std::begin(hdrData);
@@ -170,28 +170,50 @@ bool PLDMImg::processPkgHdrInfo()
         return false;
     }
     pkgVersionStringLen = headerInfo->pkgVersionStringLen;
-    std::string pkgVersionString(hdrItr,
-                                 hdrItr + headerInfo->pkgVersionStringLen);
-    copyPkgHdrInfoToMap(headerInfo, pkgVersionString);
+    compBitmapBitLength = le16toh(headerInfo->compBitmapBitLength);
+    pkgIndex->pkgHeaderInfo = *headerInfo;
+    pkgIndex->pkgVersionStringOffset = getHdrItrOffset();
     return true;
 }
 
-bool PLDMImg::verifyPkgHdrChecksum()
+size_t PLDMImg::getPkgHdrChecksumOffset() const
+{
+    size_t trailerSize = pkgHdrChecksumSize;
+    if (hdrData.size() > pkgHeaderIdentifierSize &&
+        hdrData[pkgHeaderIdentifierSize] >= pkgHdrFormatRevisionV13)
+    {
+        trailerSize += pkgPayloadChecksumSize;
+    }
+    return hdrData.size() < trailerSize ? 0 : hdrData.size() - trailerSize;
+}
+
+std::optional<uint32_t> PLDMImg::getPkgPayloadChecksum() const
 {
-    constexpr size_t pkgHdrChecksumSize = 4;
-    uint32_t pkgHdrChecksum = 0;
-    std::vector<uint8_t> checksum(pkgHdrChecksumSize);
+    const size_t checksumOffset =
+        getPkgHdrChecksumOffset() + pkgHdrChecksumSize;
+    if (checksumOffset + pkgPayloadChecksumSize != hdrData.size())
+    {
+        return std::nullopt;
+    }
+    uint32_t checksum = 0;
+    std::memcpy(&checksum, &hdrData[checksumOffset], sizeof(checksum));
+    return checksum;
+}
 
-    if (!readData(pkgHdrLen - pkgHdrChecksumSize, checksum, pkgHdrChecksumSize))
+bool PLDMImg::verifyPkgHdrChecksum()
+{
+    const size_t checksumOffset = getPkgHdrChecksumOffset();
+    if (checksumOffset < sizeof(PLDMPkgHeaderInfo))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "failed to read pkgHdrChecksum");
         return false;
     }
-    pkgHdrChecksum = *reinterpret_cast<uint32_t*>(checksum.data());
+    std::memcpy(&pkgHdrChecksum, &hdrData[checksumOffset],
+                sizeof(pkgHdrChecksum));
 
     if (pkgHdrChecksum !=
-        crc32(hdrData.data(), hdrData.size() - pkgHdrChecksumSize))
+        utils::crc32Update(0, hdrData.data(), checksumOffset))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "verifyPkgHdrChecksum: checksum not macthed");
@@ -200,7 +222,7 @@ bool PLDMImg::verifyPkgHdrChecksum()
     return true;
 }
 
-bool PLDMImg::processPkgHdr()
+bool PLDMImg::readPkgHdr()
 {
     constexpr size_t minPkgHeaderLen =
         sizeof(PLDMPkgHeaderInfo) + sizeof(FWDevIdRecord) + sizeof(CompImgInfo);
@@ -213,7 +235,47 @@ bool PLDMImg::processPkgHdr()
         phosphor::logging::log<phosphor::logging::level::ERR>("read failed ");
         return false;
     }
+    return true;
+}
+
+bool PLDMImg::processPkgHdr(boost::asio::yield_context yield)
+{
+    // Reading and parsing only touch this image, the header index cache and
+    // the FD descriptors are shared with the io_context
+    if (!runOnWorker(yield, [this]() { return readPkgHdr(); }))
+    {
+        return false;
+    }
+
+    if (!loadCachedPkgHdrIndex())
+    {
+        if (!runOnWorker(yield, [this]() { return parsePkgHdr(); }))
+        {
+            return false;
+        }
+        cachePkgHdrIndex();
+    }
+    return processParsedPkgHdr();
+}
+
+bool PLDMImg::processParsedPkgHdr()
+{
+    if (!processPkgHdrIndex())
+    {
+        return false;
+    }
+    if (!checkCompImgBounds())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "checkCompImgBounds: Failed");
+        return false;
+    }
+    return true;
+}
 
+bool PLDMImg::parsePkgHdr()
+{
+    pkgIndex = std::make_shared<PkgHdrIndex>();
     if (!verifyPkgHdrChecksum())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -243,6 +305,240 @@ bool PLDMImg::processPkgHdr()
     return true;
 }
 
+bool PLDMImg::checkCompImgBounds()
+{
+    // The package carries no component digest, only truncated packages and
+    // out of range components can be rejected before the update starts
+    for (uint16_t comp = 0; comp < totalCompCount; comp++)
+    {
+        const CompImgInfo* compInfo = getCompImgInfo(comp);
+        const uint32_t compOffset = le32toh(compInfo->compLocationOffset);
+        const uint32_t compSize = le32toh(compInfo->compSize);
+        if (compOffset < pkgHdrLen ||
+            static_cast<std::uintmax_t>(compOffset) + compSize > pldmImgSize)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Component image is out of package payload",
+                phosphor::logging::entry("COMPONENT=%d", comp),
+                phosphor::logging::entry("OFFSET=%u", compOffset),
+                phosphor::logging::entry("SIZE=%u", compSize));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PLDMImg::computePkgChecksum()
+{
+    const std::optional<uint32_t> pkgPayloadChecksum = getPkgPayloadChecksum();
+    std::vector<uint8_t> chunk(pkgReadChunkSize);
+    uint32_t crc = utils::crc32Update(0, hdrData.data(), hdrData.size());
+    uint32_t payloadCrc = 0;
+#ifdef FWU_VERIFY_COMPONENT_IMAGES
+    compChecksums.assign(totalCompCount, 0);
+#endif
+    for (size_t offset = pkgHdrLen; offset < pldmImgSize;
+         offset += pkgReadChunkSize)
+    {
+        const size_t length = static_cast<size_t>(
+            std::min<std::uintmax_t>(pkgReadChunkSize, pldmImgSize - offset));
+        if (!readData(offset, chunk, length))
+        {
+            return false;
+        }
+        crc = utils::crc32Update(crc, chunk.data(), length);
+        if (pkgPayloadChecksum)
+        {
+            payloadCrc = utils::crc32Update(payloadCrc, chunk.data(), length);
+        }
+#ifdef FWU_VERIFY_COMPONENT_IMAGES
+        // Components lie within the payload, but in any order
+        for (uint16_t comp = 0; comp < totalCompCount; comp++)
+        {
+            const CompImgInfo* compInfo = getCompImgInfo(comp);
+            const size_t compOffset = le32toh(compInfo->compLocationOffset);
+            const size_t compSize = le32toh(compInfo->compSize);
+            const size_t begin = std::max(offset, compOffset);
+            const size_t end = std::min(offset + length, compOffset + compSize);
+            if (begin < end)
+            {
+                compChecksums[comp] = utils::crc32Update(
+                    compChecksums[comp], &chunk[begin - offset], end - begin);
+            }
+        }
+#endif
+    }
+    if (pkgPayloadChecksum && *pkgPayloadChecksum != payloadCrc)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Package payload checksum not matched");
+        return false;
+    }
+    pkgChecksum = crc;
+    return true;
+}
+
+#ifdef FWU_VERIFY_COMPONENT_IMAGES
+bool PLDMImg::verifyCompImage(const uint16_t comp)
+{
+    const CompImgInfo* compInfo = getCompImgInfo(comp);
+    if (!compInfo || comp >= compChecksums.size())
+    {
+        return false;
+    }
+    const size_t compOffset = le32toh(compInfo->compLocationOffset);
+    const size_t compSize = le32toh(compInfo->compSize);
+    std::vector<uint8_t> chunk(pkgReadChunkSize);
+    uint32_t crc = 0;
+    for (size_t done = 0; done < compSize; done += pkgReadChunkSize)
+    {
+        const size_t length = std::min(pkgReadChunkSize, compSize - done);
+        if (!readData(compOffset + done, chunk, length))
+        {
+            return false;
+        }
+        crc = utils::crc32Update(crc, chunk.data(), length);
+    }
+    if (crc != compChecksums[comp])
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Component image changed since the update was started",
+            phosphor::logging::entry("COMPONENT=%d", comp));
+        return false;
+    }
+    return true;
+}
+#endif
+
+bool PLDMImg::loadCachedPkgHdrIndex()
+{
+    if (hdrData.size() < pkgHdrChecksumSize)
+    {
+        return false;
+    }
+    uint32_t checksum = 0;
+    std::memcpy(&checksum, &hdrData[getPkgHdrChecksumOffset()],
+                sizeof(checksum));
+
+    auto it = std::find_if(pkgHdrIndexCache.begin(), pkgHdrIndexCache.end(),
+                           [this, checksum](const auto& index) {
+                               return index->pkgHdrChecksum == checksum &&
+                                      index->hdrData == hdrData;
+                           });
+    if (it == pkgHdrIndexCache.end())
+    {
+        return false;
+    }
+    pkgIndex = *it;
+    pkgHdrIndexCache.erase(it);
+    pkgHdrIndexCache.emplace_back(pkgIndex);
+    pkgHdrChecksum = pkgIndex->pkgHdrChecksum;
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "Using cached package header index");
+    return true;
+}
+
+void PLDMImg::cachePkgHdrIndex()
+{
+    pkgIndex->hdrData = hdrData;
+    pkgIndex->pkgHdrChecksum = pkgHdrChecksum;
+    if (pkgHdrIndexCache.size() >= maxPkgHdrIndexCacheSize)
+    {
+        pkgHdrIndexCache.pop_front();
+    }
+    pkgHdrIndexCache.emplace_back(pkgIndex);
+}
+
+bool PLDMImg::processPkgHdrIndex()
+{
+    pkgVersionStringLen = pkgIndex->pkgHeaderInfo.pkgVersionStringLen;
+    compBitmapBitLength = le16toh(pkgIndex->pkgHeaderInfo.compBitmapBitLength);
+    deviceIDRecordCount =
+        static_cast<uint8_t>(pkgIndex->devIDRecords.size());
+    totalCompCount = static_cast<uint16_t>(pkgIndex->components.size());
+
+    matchedTermini.clear();
+    for (uint8_t devIdRecord = 0; devIdRecord < deviceIDRecordCount;
+         devIdRecord++)
+    {
+        const DescriptorsMap& descriptors =
+            pkgIndex->devIDRecords[devIdRecord].descriptors;
+        if (!findMatchedTerminus(devIdRecord, descriptors))
+        {
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "processPkgHdrIndex: descriptors not matched",
+                phosphor::logging::entry("DESCRIPTOR=%d", devIdRecord));
+        }
+    }
+    if (matchedTermini.empty())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Descriptors not matched with descriptors in device ID records");
+        return false;
+    }
+    return true;
+}
+
+std::span<const uint8_t> PLDMImg::getHdrField(const uint16_t offset,
+                                              const size_t len) const
+{
+    if (!pkgIndex || offset + len > pkgIndex->hdrData.size())
+    {
+        return {};
+    }
+    return {pkgIndex->hdrData.data() + offset, len};
+}
+
+std::string_view PLDMImg::getCompVerStr(const uint16_t compCount) const
+{
+    const CompImgInfo* compInfo = getCompImgInfo(compCount);
+    if (!compInfo)
+    {
+        return {};
+    }
+    auto field = getHdrField(pkgIndex->components[compCount].compVerStrOffset,
+                             compInfo->compVerStrLen);
+    return {reinterpret_cast<const char*>(field.data()), field.size()};
+}
+
+std::span<const uint8_t>
+    PLDMImg::getApplicableComponents(const uint8_t recordCount) const
+{
+    constexpr size_t compBitmapBitLengthMultiplier = 8;
+    if (!getDevIdRecord(recordCount))
+    {
+        return {};
+    }
+    return getHdrField(
+        pkgIndex->devIDRecords[recordCount].applicableComponentsOffset,
+        compBitmapBitLength / compBitmapBitLengthMultiplier);
+}
+
+std::string_view PLDMImg::getCompImgSetVerStr(const uint8_t recordCount) const
+{
+    const FWDevIdRecord* devIdRecord = getDevIdRecord(recordCount);
+    if (!devIdRecord)
+    {
+        return {};
+    }
+    auto field =
+        getHdrField(pkgIndex->devIDRecords[recordCount].compImgSetVerStrOffset,
+                    devIdRecord->comImgSetVerStrLen);
+    return {reinterpret_cast<const char*>(field.data()), field.size()};
+}
+
+std::span<const uint8_t>
+    PLDMImg::getFWDevPkgData(const uint8_t recordCount) const
+{
+    const FWDevIdRecord* devIdRecord = getDevIdRecord(recordCount);
+    if (!devIdRecord)
+    {
+        return {};
+    }
+    return getHdrField(pkgIndex->devIDRecords[recordCount].fwDevPkgDataOffset,
+                       le16toh(devIdRecord->fwDevPkgDataLen));
+}
+
 bool PLDMImg::processCompImgInfo()
 {
     uint16_t found = 0;
@@ -273,9 +569,8 @@ bool PLDMImg::processCompImgInfo()
                 "no bytes left for compVerStr");
             break;
         }
-        std::string compVerStr(hdrItr, hdrItr + compInfo->compVerStrLen);
+        pkgIndex->components.push_back({*compInfo, getHdrItrOffset()});
         std::advance(hdrItr, compInfo->compVerStrLen);
-        copyCompImgInfoToMap(found, compInfo, compVerStr);
         found++;
     }
     if (found != totalCompCount)
@@ -345,6 +640,8 @@ bool PLDMImg::processDevIdentificationInfo()
         }
         FWDevIdRecord* devIdentificationInfo =
             reinterpret_cast<FWDevIdRecord*>(&*hdrItr);
+        PkgDevIDRecordIndex record = {};
+        record.devIdRecord = *devIdentificationInfo;
         size_t applicableComponentsLen =
             compBitmapBitLength / compBitmapBitLengthMultiplier;
         if (!advanceHdrItr(sizeof(FWDevIdRecord), applicableComponentsLen))
@@ -353,9 +650,7 @@ bool PLDMImg::processDevIdentificationInfo()
                 "no bytes left for applicableComponentsLen");
             break;
         }
-
-        std::vector<uint8_t> applicableComponents(
-            hdrItr, hdrItr + applicableComponentsLen);
+        record.applicableComponentsOffset = getHdrItrOffset();
 
         if (!advanceHdrItr(applicableComponentsLen,
                            devIdentificationInfo->comImgSetVerStrLen))
@@ -364,30 +659,21 @@ bool PLDMImg::processDevIdentificationInfo()
                 "no bytes left for comImgSetVerStr");
             break;
         }
-        std::string compImgSetVerStr(
-            hdrItr, hdrItr + devIdentificationInfo->comImgSetVerStrLen);
+        record.compImgSetVerStrOffset = getHdrItrOffset();
         size_t descriptorDataLen = getDescriptorDataLen(
             *devIdentificationInfo, applicableComponentsLen);
 
-        if (!advanceHdrItr(compImgSetVerStr.size(), descriptorDataLen))
+        if (!advanceHdrItr(devIdentificationInfo->comImgSetVerStrLen,
+                           descriptorDataLen))
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for descriptorData");
             break;
         }
         std::vector<uint8_t> descriptorData(hdrItr, hdrItr + descriptorDataLen);
-        uint16_t initialDescriptorType;
-        DescriptorsMap pkgDescriptorRecords;
         unpackDescriptors(devIdentificationInfo->descriptorCount,
-                          descriptorData, initialDescriptorType,
-                          pkgDescriptorRecords);
-        if (!findMatchedTerminus(foundDescriptorCount, pkgDescriptorRecords))
-        {
-            phosphor::logging::log<phosphor::logging::level::INFO>(
-                "processDevIdentificationInfo: descriptors not matched",
-                phosphor::logging::entry("DESCRIPTOR=%d",
-                                         foundDescriptorCount));
-        }
+                          descriptorData, record.initialDescriptorType,
+                          record.descriptors);
         fwDevPkgDataLen = htole16(devIdentificationInfo->fwDevPkgDataLen);
 
         if (!advanceHdrItr(descriptorData.size(), fwDevPkgDataLen))
@@ -396,12 +682,9 @@ bool PLDMImg::processDevIdentificationInfo()
                 "no bytes left for fwDevPkgData");
             break;
         }
-        std::vector<uint8_t> fwDevPkgData(hdrItr, hdrItr + fwDevPkgDataLen);
+        record.fwDevPkgDataOffset = getHdrItrOffset();
         std::advance(hdrItr, fwDevPkgDataLen);
-        copyDevIdentificationInfoToMap(
-            foundDescriptorCount, initialDescriptorType, devIdentificationInfo,
-            applicableComponents, compImgSetVerStr, fwDevPkgData,
-            pkgDescriptorRecords);
+        pkgIndex->devIDRecords.emplace_back(std::move(record));
         foundDescriptorCount++;
     }
 
@@ -415,64 +698,9 @@ bool PLDMImg::processDevIdentificationInfo()
                                      deviceIDRecordCount));
         return false;
     }
-    if (!matchedTermini.size())
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Descriptors not matched with descriptors in device ID records");
-        return false;
-    }
     return true;
 }
 
-void PLDMImg::copyDevIdentificationInfoToMap(
-    const uint8_t deviceIDRecord, const uint16_t initialDescriptorType,
-    const FWDevIdRecord* devIdentificationInfo,
-    const std::vector<uint8_t>& applicableComponents,
-    const std::string& compImgSetVerStr,
-    const std::vector<uint8_t>& fwDevPkgData,
-    DescriptorsMap& pkgDescriptorRecords)
-{
-    FWUProperties devIdentificationProps;
-    devIdentificationProps["InitialDescriptorType"] = initialDescriptorType;
-    devIdentificationProps["DeviceIDRecordCount"] = deviceIDRecord;
-    devIdentificationProps["RecordLength"] =
-        htole16(devIdentificationInfo->recordLength);
-    devIdentificationProps["DescriptorCount"] =
-        devIdentificationInfo->descriptorCount;
-    devIdentificationProps["DeviceUpdateOptionFlags"] =
-        htole32(devIdentificationInfo->deviceUpdateOptionFlags);
-    devIdentificationProps["ComImgSetVerStrType"] =
-        devIdentificationInfo->comImgSetVerStrType;
-    devIdentificationProps["ComImgSetVerStrLen"] =
-        devIdentificationInfo->comImgSetVerStrLen;
-    devIdentificationProps["FWDevPkgDataLen"] =
-        htole16(devIdentificationInfo->fwDevPkgDataLen);
-    devIdentificationProps["ApplicableComponents"] = applicableComponents;
-    devIdentificationProps["CompImgSetVerStr"] = compImgSetVerStr;
-    devIdentificationProps["FirmwareDevicePackageData"] = fwDevPkgData;
-    pkgDevIDRecords[deviceIDRecord] =
-        std::make_pair(devIdentificationProps, pkgDescriptorRecords);
-}
-
-void PLDMImg::copyCompImgInfoToMap(const uint16_t count,
-                                   const CompImgInfo* compInfo,
-                                   const std::string& compVerStr)
-{
-    std::map<std::string, FWUVariantType> properties;
-    properties["CompClassification"] = htole16(compInfo->compClassification);
-    properties["CompIdentifier"] = htole16(compInfo->compIdentifier);
-    properties["CompComparisonStamp"] = htole32(compInfo->compComparisonStamp);
-    properties["CompOptions"] = htole16(compInfo->compOptions);
-    properties["RequestedCompActivationMethod"] =
-        htole16(compInfo->requestedCompActivationMethod);
-    properties["CompLocationOffset"] = htole32(compInfo->compLocationOffset);
-    properties["CompSize"] = htole32(compInfo->compSize);
-    properties["CmpVerStrType"] = compInfo->compVerStrType;
-    properties["CompVerStrLen"] = compInfo->compVerStrLen;
-    properties["CompVerStr"] = compVerStr;
-    pkgCompProperties[count] = properties;
-}
-
 size_t PLDMImg::getDescriptorDataLen(const FWDevIdRecord& data,
                                      const size_t applicableComponentsLen)
 {
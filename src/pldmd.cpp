@@ -15,11 +15,19 @@
 */
 
 #include "base.hpp"
+#include "command_stats.hpp"
 #include "mctp_wrapper.hpp"
+#include "packet_capture.hpp"
 #include "platform.hpp"
+#include "platform_association.hpp"
 #include "pldm.hpp"
+#include "transport.hpp"
 #include "utils.hpp"
 
+#ifdef PLDM_SIMULATOR
+#include "simulated_transport.hpp"
+#endif
+
 #include <queue>
 
 extern "C" {
@@ -40,13 +48,13 @@ static pldm_tid_t reservedTID = pldmInvalidTid;
 static uint8_t reservedPLDMType = pldmInvalidType;
 
 TIDMapper tidMapper;
-std::unique_ptr<mctpw::MCTPWrapper> mctpWrapper;
+std::unique_ptr<Transport> transport;
 
 void triggerDeviceDiscovery(const pldm_tid_t tid)
 {
     if (auto eidPtr = tidMapper.getMappedEID(tid))
     {
-        mctpWrapper->triggerMCTPDeviceDiscovery(*eidPtr);
+        transport->triggerDeviceDiscovery(*eidPtr);
     }
 }
 
@@ -77,7 +85,7 @@ bool reserveBandwidth(const boost::asio::yield_context yield,
     {
         return false;
     }
-    if (mctpWrapper->reserveBandwidth(yield, eid, timeout) < 0)
+    if (transport->reserveBandwidth(yield, eid, timeout) < 0)
     {
         return false;
     }
@@ -107,7 +115,7 @@ bool releaseBandwidth(const boost::asio::yield_context yield,
     {
         return false;
     }
-    if (mctpWrapper->releaseBandwidth(yield, *eid) < 0)
+    if (transport->releaseBandwidth(yield, *eid) < 0)
     {
         return false;
     }
@@ -121,7 +129,7 @@ std::optional<std::string> getDeviceLocation(const pldm_tid_t tid)
 {
     std::optional<mctpw_eid_t> eid = tidMapper.getMappedEID(tid);
     if (eid.has_value()) {
-        return mctpWrapper->getDeviceLocation(eid.value());
+        return transport->getDeviceLocation(eid.value());
     }
     return std::nullopt;
 }
@@ -262,148 +270,214 @@ bool validatePLDMRespDecode(const pldm_tid_t tid, const int rc,
     return true;
 }
 
-static bool doSendReceievePldmMessage(boost::asio::yield_context yield,
-                                      const mctpw_eid_t dstEid,
-                                      const uint16_t timeout,
-                                      std::vector<uint8_t>& pldmReq,
-                                      std::vector<uint8_t>& pldmResp)
-{
-    auto sendStatus = mctpWrapper->sendReceiveYield(
-        yield, dstEid, pldmReq, std::chrono::milliseconds(timeout));
-    pldmResp = sendStatus.second;
-    utils::printVect("Request(MCTP payload):", pldmReq);
-    utils::printVect("Response(MCTP payload):", pldmResp);
-    return sendStatus.first ? false : true;
-}
-
-bool sendReceivePldmMessage(boost::asio::yield_context yield,
-                            const pldm_tid_t tid, const uint16_t timeout,
-                            size_t retryCount, std::vector<uint8_t> pldmReq,
-                            std::vector<uint8_t>& pldmResp,
-                            std::optional<mctpw_eid_t> eid)
+static bool isSendAllowed(const pldm_tid_t tid,
+                          const std::vector<uint8_t>& pldmMsg,
+                          const std::string& apiName)
 {
-    pldm_msg_hdr* hdr = reinterpret_cast<pldm_msg_hdr*>(pldmReq.data());
+    auto hdr = reinterpret_cast<const pldm_msg_hdr*>(pldmMsg.data());
     if (validateReserveBW(tid, hdr->type))
     {
         phosphor::logging::log<phosphor::logging::level::INFO>(
-            ("sendReceivePldmMessage is not allowed. Reserve bandwidth is "
-             "active for TID: " +
+            (apiName +
+             " is not allowed. Reserve bandwidth is active for TID: " +
              std::to_string(reservedTID) +
              " RESERVED_PLDM_TYPE: " + std::to_string(reservedPLDMType))
                 .c_str());
         return false;
     }
-    // Retry the request if
-    //  1) No response
-    //  2) payload.size() < 4
-    //  3) If response bit is not set in PLDM header
-    //  4) Invalid message type
-    //  5) Invalid instance id
+    return true;
+}
 
-    // Upper cap of retryCount = 5
-    constexpr size_t maxRetryCount = 5;
-    if (retryCount > maxRetryCount)
+static std::optional<mctpw_eid_t>
+    getDestinationEid(const pldm_tid_t tid,
+                      const std::optional<mctpw_eid_t> eid)
+{
+    // Input EID takes precedence over TID
+    // Usecase: TID reassignment
+    if (eid)
     {
-        retryCount = maxRetryCount;
+        return eid.value();
     }
 
-    for (size_t retry = 0; retry < retryCount; retry++)
+    // A PLDM device removal can cause an update to TID mapper. In such
+    // case the retry should be aborted immediately.
+    if (auto eidPtr = tidMapper.getMappedEID(tid))
+    {
+        return *eidPtr;
+    }
+    phosphor::logging::log<phosphor::logging::level::ERR>(
+        "PLDM message send failed. Invalid TID/EID");
+    return std::nullopt;
+}
+
+// Retry the request if
+//  1) No response
+//  2) payload.size() < 4
+//  3) If response bit is not set in PLDM header
+//  4) Invalid message type
+//  5) Invalid instance id
+static bool validatePldmResponse(std::vector<uint8_t>& pldmReq,
+                                 std::vector<uint8_t>& pldmResp)
+{
+    constexpr size_t minPldmMsgSize = 4;
+    if (pldmResp.size() < minPldmMsgSize)
     {
-        mctpw_eid_t dstEid;
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Invalid response length");
+        return false;
+    }
 
-        // Input EID takes precedence over TID
-        // Usecase: TID reassignment
-        if (eid)
+    // Verify the message received is a response
+    if (auto msgTypePtr = getPldmPacketType(pldmResp))
+    {
+        if (*msgTypePtr != PLDM_RESPONSE)
         {
-            dstEid = eid.value();
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "PLDM message received is not response");
+            return false;
         }
-        else
+    }
+    else
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Unable to get message type");
+        return false;
+    }
+
+    // Verify the response received is of type PLDM
+    constexpr int mctpMsgType = 0;
+    if (pldmResp.at(mctpMsgType) ==
+        static_cast<uint8_t>(mctpw::MessageType::pldm))
+    {
+        // Remove the MCTP message type and IC bit from req and resp
+        // payload.
+        // Why: Upper layer handlers(PLDM message type handlers)
+        // are not intrested in MCTP message type information and
+        // integrity check fields.
+        pldmResp.erase(pldmResp.begin());
+        pldmReq.erase(pldmReq.begin());
+    }
+    else
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Response received is not of message type PLDM");
+        return false;
+    }
+
+    // Verify request and response instance ID matches
+    if (auto reqInstanceId = getInstanceId(pldmReq))
+    {
+        if (auto respInstanceId = getInstanceId(pldmResp))
         {
-            // A PLDM device removal can cause an update to TID mapper. In such
-            // case the retry should be aborted immediately.
-            if (auto eidPtr = tidMapper.getMappedEID(tid))
-            {
-                dstEid = *eidPtr;
-            }
-            else
+            if (*reqInstanceId == *respInstanceId)
             {
-                phosphor::logging::log<phosphor::logging::level::ERR>(
-                    "PLDM message send failed. Invalid TID/EID");
-                return false;
+                return true;
             }
         }
+    }
+    phosphor::logging::log<phosphor::logging::level::WARNING>(
+        "Instance ID check failed");
+    return false;
+}
 
-        // Insert MCTP Message Type to start of the payload
-        if (retry == 0)
-        {
-            pldmReq.insert(pldmReq.begin(),
-                           static_cast<uint8_t>(mctpw::MessageType::pldm));
-        }
+// Upper cap of retryCount
+constexpr size_t maxRetryCount = 5;
 
-        // Clear the resp vector each time before a retry
-        pldmResp.clear();
-        if (doSendReceievePldmMessage(yield, dstEid, timeout, pldmReq,
-                                      pldmResp))
-        {
-            constexpr size_t minPldmMsgSize = 4;
-            if (pldmResp.size() < minPldmMsgSize)
-            {
-                phosphor::logging::log<phosphor::logging::level::WARNING>(
-                    "Invalid response length");
-                continue;
-            }
+// Per-attempt bookkeeping shared by the yield and awaitable variants of
+// sendReceivePldmMessage. Only the transport call differs between them.
+struct SendReceiveAttempt
+{
+    mctpw_eid_t dstEid;
+    std::chrono::steady_clock::time_point sendTime;
+};
 
-            // Verify the message received is a response
-            if (auto msgTypePtr = getPldmPacketType(pldmResp))
-            {
-                if (*msgTypePtr != PLDM_RESPONSE)
-                {
-                    phosphor::logging::log<phosphor::logging::level::WARNING>(
-                        "PLDM message received is not response");
-                    continue;
-                }
-            }
-            else
-            {
-                phosphor::logging::log<phosphor::logging::level::WARNING>(
-                    "Unable to get message type");
-                continue;
-            }
+static std::optional<SendReceiveAttempt>
+    beginSendReceive(const pldm_tid_t tid, const std::optional<mctpw_eid_t> eid,
+                     const stats::CommandKey& key, const size_t retry,
+                     std::vector<uint8_t>& pldmReq,
+                     std::vector<uint8_t>& pldmResp)
+{
+    auto dstEid = getDestinationEid(tid, eid);
+    if (!dstEid)
+    {
+        return std::nullopt;
+    }
 
-            // Verify the response received is of type PLDM
-            constexpr int mctpMsgType = 0;
-            if (pldmResp.at(mctpMsgType) ==
-                static_cast<uint8_t>(mctpw::MessageType::pldm))
-            {
-                // Remove the MCTP message type and IC bit from req and resp
-                // payload.
-                // Why: Upper layer handlers(PLDM message type handlers)
-                // are not intrested in MCTP message type information and
-                // integrity check fields.
-                pldmResp.erase(pldmResp.begin());
-                pldmReq.erase(pldmReq.begin());
-            }
-            else
-            {
-                phosphor::logging::log<phosphor::logging::level::WARNING>(
-                    "Response received is not of message type PLDM");
-                continue;
-            }
+    // Insert MCTP Message Type to start of the payload
+    if (retry == 0)
+    {
+        pldmReq.insert(pldmReq.begin(),
+                       static_cast<uint8_t>(mctpw::MessageType::pldm));
+        stats::recordRequest(key);
+    }
+    else
+    {
+        stats::recordRetry(key);
+    }
 
-            // Verify request and response instance ID matches
-            if (auto reqInstanceId = getInstanceId(pldmReq))
-            {
-                if (auto respInstanceId = getInstanceId(pldmResp))
-                {
-                    if (*reqInstanceId == *respInstanceId)
-                    {
-                        return true;
-                    }
-                }
-            }
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                "Instance ID check failed");
-            continue;
+    // Clear the resp vector each time before a retry
+    pldmResp.clear();
+    capture::capturePacket(capture::Direction::sent, *dstEid, true, 0,
+                           pldmReq);
+    return SendReceiveAttempt{*dstEid, std::chrono::steady_clock::now()};
+}
+
+// Returns true if the attempt got a valid response, false if it has to be
+// retried
+static bool finishSendReceive(const SendReceiveAttempt& attempt,
+                              const stats::CommandKey& key,
+                              Transport::SendReceiveStatus& sendStatus,
+                              std::vector<uint8_t>& pldmReq,
+                              std::vector<uint8_t>& pldmResp)
+{
+    pldmResp = std::move(sendStatus.second);
+    utils::printVect("Request(MCTP payload):", pldmReq);
+    utils::printVect("Response(MCTP payload):", pldmResp);
+    if (sendStatus.first)
+    {
+        stats::recordTimeout(key);
+        return false;
+    }
+    capture::capturePacket(capture::Direction::received, attempt.dstEid, false,
+                           0, pldmResp);
+    if (validatePldmResponse(pldmReq, pldmResp))
+    {
+        stats::recordResponse(
+            key, std::chrono::steady_clock::now() - attempt.sendTime,
+            pldmResp);
+        return true;
+    }
+    stats::recordInvalidResponse(key);
+    return false;
+}
+
+bool sendReceivePldmMessage(boost::asio::yield_context yield,
+                            const pldm_tid_t tid, const uint16_t timeout,
+                            size_t retryCount, std::vector<uint8_t> pldmReq,
+                            std::vector<uint8_t>& pldmResp,
+                            std::optional<mctpw_eid_t> eid)
+{
+    if (!isSendAllowed(tid, pldmReq, "sendReceivePldmMessage"))
+    {
+        return false;
+    }
+    const stats::CommandKey key = stats::getCommandKey(tid, pldmReq);
+
+    retryCount = std::min(retryCount, maxRetryCount);
+    for (size_t retry = 0; retry < retryCount; retry++)
+    {
+        auto attempt =
+            beginSendReceive(tid, eid, key, retry, pldmReq, pldmResp);
+        if (!attempt)
+        {
+            return false;
+        }
+        auto sendStatus = transport->sendReceiveYield(
+            yield, attempt->dstEid, pldmReq,
+            std::chrono::milliseconds(timeout));
+        if (finishSendReceive(*attempt, key, sendStatus, pldmReq, pldmResp))
+        {
+            return true;
         }
     }
     phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -411,70 +485,183 @@ bool sendReceivePldmMessage(boost::asio::yield_context yield,
     return false;
 }
 
+boost::asio::awaitable<bool>
+    sendReceivePldmMessage(const pldm_tid_t tid, const uint16_t timeout,
+                           size_t retryCount, std::vector<uint8_t> pldmReq,
+                           std::vector<uint8_t>& pldmResp,
+                           std::optional<mctpw_eid_t> eid)
+{
+    using SendReceiveStatus = Transport::SendReceiveStatus;
+    if (!isSendAllowed(tid, pldmReq, "sendReceivePldmMessage"))
+    {
+        co_return false;
+    }
+    const stats::CommandKey key = stats::getCommandKey(tid, pldmReq);
+
+    retryCount = std::min(retryCount, maxRetryCount);
+    for (size_t retry = 0; retry < retryCount; retry++)
+    {
+        auto attempt =
+            beginSendReceive(tid, eid, key, retry, pldmReq, pldmResp);
+        if (!attempt)
+        {
+            co_return false;
+        }
+        auto sendStatus = co_await boost::asio::async_initiate<
+            const boost::asio::use_awaitable_t<>, void(SendReceiveStatus)>(
+            [dstEid = attempt->dstEid, timeout, &pldmReq](auto handler) {
+                // Transport callbacks are std::function which needs a
+                // copyable callable
+                auto sharedHandler =
+                    std::make_shared<decltype(handler)>(std::move(handler));
+                transport->sendReceiveAsync(
+                    [sharedHandler](boost::system::error_code ec,
+                                    const auto& response) {
+                        (*sharedHandler)(SendReceiveStatus{ec, response});
+                    },
+                    dstEid, pldmReq, std::chrono::milliseconds(timeout));
+            },
+            boost::asio::use_awaitable);
+        if (finishSendReceive(*attempt, key, sendStatus, pldmReq, pldmResp))
+        {
+            co_return true;
+        }
+    }
+    phosphor::logging::log<phosphor::logging::level::ERR>(
+        "Retry count exceeded. No response");
+    co_return false;
+}
+
+static void logSendFailure(const std::pair<boost::system::error_code, int>& rc)
+{
+    phosphor::logging::log<phosphor::logging::level::WARNING>(
+        ("SendMCTPPayload Failed, retry count exceeded  rc: " +
+         std::to_string(rc.second) + " " + rc.first.message())
+            .c_str());
+}
+
 bool sendPldmMessage(boost::asio::yield_context yield, const pldm_tid_t tid,
                      uint8_t retryCount, const uint8_t msgTag,
                      const bool tagOwner, std::vector<uint8_t> payload)
 
 {
-    constexpr size_t maxRetryCount = 5;
-    pldm_msg_hdr* hdr = reinterpret_cast<pldm_msg_hdr*>(payload.data());
-    if (validateReserveBW(tid, hdr->type))
+    if (!isSendAllowed(tid, payload, "sendPldmMessage"))
     {
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            ("sendPldmMessage is not allowed. Reserve bandwidth is active for "
-             "TID: " +
-             std::to_string(reservedTID) +
-             " RESERVED_PLDM_TYPE: " + std::to_string(reservedPLDMType))
-                .c_str());
         return false;
     }
 
-    mctpw_eid_t dstEid;
-    if (auto eidPtr = tidMapper.getMappedEID(tid))
-    {
-        dstEid = *eidPtr;
-    }
-    else
+    auto dstEid = getDestinationEid(tid, std::nullopt);
+    if (!dstEid)
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "PLDM message send failed. Invalid TID");
         return false;
     }
+    const stats::CommandKey key = stats::getCommandKey(tid, payload);
+    stats::recordRequest(key);
     // Insert MCTP Message Type to start of the payload
     payload.insert(payload.begin(),
                    static_cast<uint8_t>(mctpw::MessageType::pldm));
     utils::printVect("Send PLDM message(MCTP payload):", payload);
     std::pair<boost::system::error_code, int> rc;
 
-    if (retryCount > maxRetryCount)
+    retryCount =
+        static_cast<uint8_t>(std::min<size_t>(retryCount, maxRetryCount));
+    for (size_t retry = 0; retry < retryCount; retry++)
+    {
+        if (retry)
+        {
+            stats::recordRetry(key);
+        }
+        capture::capturePacket(capture::Direction::sent, *dstEid, tagOwner,
+                               msgTag, payload);
+        const auto sendTime = std::chrono::steady_clock::now();
+        rc = transport->sendYield(yield, *dstEid, msgTag, tagOwner, payload);
+        if (rc.first || rc.second < 0)
+        {
+            stats::recordTimeout(key);
+            continue;
+        }
+        stats::recordSent(key, std::chrono::steady_clock::now() - sendTime);
+        break;
+    }
+
+    if (rc.first || rc.second < 0)
+    {
+        logSendFailure(rc);
+        return false;
+    }
+    return true;
+}
+
+boost::asio::awaitable<bool> sendPldmMessage(const pldm_tid_t tid,
+                                             uint8_t retryCount,
+                                             const uint8_t msgTag,
+                                             const bool tagOwner,
+                                             std::vector<uint8_t> payload)
+{
+    if (!isSendAllowed(tid, payload, "sendPldmMessage"))
+    {
+        co_return false;
+    }
+
+    auto dstEid = getDestinationEid(tid, std::nullopt);
+    if (!dstEid)
     {
-        retryCount = maxRetryCount;
+        co_return false;
     }
+    const stats::CommandKey key = stats::getCommandKey(tid, payload);
+    stats::recordRequest(key);
+    // Insert MCTP Message Type to start of the payload
+    payload.insert(payload.begin(),
+                   static_cast<uint8_t>(mctpw::MessageType::pldm));
+    utils::printVect("Send PLDM message(MCTP payload):", payload);
+    using SendStatus = std::pair<boost::system::error_code, int>;
+    SendStatus rc;
 
+    retryCount =
+        static_cast<uint8_t>(std::min<size_t>(retryCount, maxRetryCount));
     for (size_t retry = 0; retry < retryCount; retry++)
     {
-        rc = mctpWrapper->sendYield(yield, dstEid, msgTag, tagOwner, payload);
+        if (retry)
+        {
+            stats::recordRetry(key);
+        }
+        capture::capturePacket(capture::Direction::sent, *dstEid, tagOwner,
+                               msgTag, payload);
+        const auto sendTime = std::chrono::steady_clock::now();
+        rc = co_await boost::asio::async_initiate<
+            const boost::asio::use_awaitable_t<>, void(SendStatus)>(
+            [&payload, dstEid = *dstEid, msgTag, tagOwner](auto handler) {
+                auto sharedHandler =
+                    std::make_shared<decltype(handler)>(std::move(handler));
+                transport->sendAsync(
+                    [sharedHandler](boost::system::error_code ec, int status) {
+                        (*sharedHandler)(SendStatus{ec, status});
+                    },
+                    dstEid, msgTag, tagOwner, payload);
+            },
+            boost::asio::use_awaitable);
         if (rc.first || rc.second < 0)
         {
+            stats::recordTimeout(key);
             continue;
         }
+        stats::recordSent(key, std::chrono::steady_clock::now() - sendTime);
         break;
     }
 
     if (rc.first || rc.second < 0)
     {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            ("SendMCTPPayload Failed, retry count exceeded  rc: " +
-             std::to_string(rc.second) + " " + rc.first.message())
-                .c_str());
-        return false;
+        logSendFailure(rc);
+        co_return false;
     }
-    return true;
+    co_return true;
 }
 
-auto msgRecvCallback = [](void*, mctpw::eid_t srcEid, bool tagOwner,
-                          uint8_t msgTag, const std::vector<uint8_t>& data,
-                          int) {
+void msgRecvCallback(void*, mctpw::eid_t srcEid, bool tagOwner, uint8_t msgTag,
+                     const std::vector<uint8_t>& data, int)
+{
+    capture::capturePacket(capture::Direction::received, srcEid, tagOwner,
+                           msgTag, data);
     // Intentional copy. MCTPWrapper provides const reference in callback
     auto payload = data;
     // Verify the response received is of type PLDM
@@ -514,7 +701,7 @@ auto msgRecvCallback = [](void*, mctpw::eid_t srcEid, bool tagOwner,
             }
         }
     }
-};
+}
 
 uint8_t createInstanceId(pldm_tid_t tid)
 {
@@ -604,6 +791,7 @@ void deleteDevice(const pldm_tid_t tid)
     if (pldm::base::isSupported(tid, PLDM_FRU))
     {
         pldm::fru::deleteFRUDevice(tid);
+        pldm::fru::deleteFRUTransferSize(tid);
     }
     if (pldm::base::isSupported(tid, PLDM_PLATFORM))
     {
@@ -669,6 +857,7 @@ void enableDebug()
     }
 }
 
+#ifndef PLDM_BENCH
 int main(void)
 {
     auto ioc = std::make_shared<boost::asio::io_context>();
@@ -694,22 +883,30 @@ int main(void)
     conn->request_name(pldmService);
     setSdBus(conn);
     setObjServer(objectServer);
+    pldm::platform::association::init();
+    pldm::stats::initializeStatisticsIntf();
+    pldm::capture::initializeCaptureIntf();
 
     enableDebug();
 
-    // TODO - Read from entity manager about the transport bindings to be
-    // supported by PLDM
-    mctpw::MCTPConfiguration config(mctpw::MessageType::pldm,
-                                    mctpw::BindingType::mctpOverSmBus);
+#ifdef PLDM_SIMULATOR
+    pldm::transport = pldm::simulator::createTransportFromEnvironment(
+        *ioc, pldm::msgRecvCallback);
+#endif
+    if (!pldm::transport)
+    {
+        // TODO - Read from entity manager about the transport bindings to be
+        // supported by PLDM
+        mctpw::MCTPConfiguration config(mctpw::MessageType::pldm,
+                                        mctpw::BindingType::mctpOverSmBus);
 
-    pldm::mctpWrapper = std::make_unique<mctpw::MCTPWrapper>(
-        conn, config, onDeviceUpdate, pldm::msgRecvCallback);
+        pldm::transport = std::make_unique<pldm::MCTPTransport>(
+            conn, config, onDeviceUpdate, pldm::msgRecvCallback);
+    }
 
     boost::asio::spawn(*ioc, [](boost::asio::yield_context yield) {
-        pldm::mctpWrapper->detectMctpEndpoints(yield);
-        mctpw::MCTPWrapper::EndpointMap eidMap =
-            pldm::mctpWrapper->getEndpointMap();
-        for (auto& [eid, service] : eidMap)
+        pldm::transport->detectEndpoints(yield);
+        for (const mctpw_eid_t eid : pldm::transport->getEndpoints())
         {
             pldm::platform::pauseSensorPolling();
             initDevice(eid, yield);
@@ -721,3 +918,4 @@ int main(void)
 
     return 0;
 }
+#endif
@@ -38,6 +38,15 @@ std::shared_ptr<boost::asio::io_context> getIoContext()
     return ioCtx;
 }
 
+boost::asio::thread_pool& getWorkerPool()
+{
+    // Only a couple of threads, offloaded stages are short and the BMC has
+    // few cores to spare next to the io_context thread
+    constexpr size_t workerThreadCount = 2;
+    static boost::asio::thread_pool workerPool(workerThreadCount);
+    return workerPool;
+}
+
 void setSdBus(const std::shared_ptr<sdbusplus::asio::connection>& newBus)
 {
     sdbusp = newBus;
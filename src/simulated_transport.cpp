@@ -0,0 +1,1416 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "simulated_transport.hpp"
+
+#include <algorithm>
+#include <boost/asio/steady_timer.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <phosphor-logging/log.hpp>
+#include <span>
+
+#include "base.h"
+#include "utils.h"
+
+namespace pldm
+{
+namespace simulator
+{
+// Firmware device states as defined by DSP0267
+enum class FDState : uint8_t
+{
+    idle = 0,
+    learnComponents = 1,
+    readyXfer = 2,
+    download = 3,
+    verify = 4,
+    apply = 5,
+    activate = 6
+};
+
+constexpr uint8_t mctpTypePLDM = 0x01;
+constexpr uint8_t requestBit = 0x80;
+constexpr uint8_t instanceIdMask = 0x1F;
+constexpr uint8_t pldmTypeMask = 0x3F;
+constexpr size_t msgHeaderSize = 4; // MCTP type plus PLDM header
+constexpr size_t fruTableChunkSize = 256;
+constexpr uint32_t fdMinTransferSize = 32;
+constexpr std::chrono::milliseconds fdResponseTimeout{5000};
+// PLDM version 1.0.0 in the byte order used on the wire
+constexpr std::array<uint8_t, 4> pldmVersion = {0xF1, 0xF0, 0xF0, 0x00};
+constexpr std::array<uint8_t, 4> platformVersion = {0xF1, 0xF2, 0xF0, 0x00};
+
+static size_t getDataSizeBytes(const uint8_t dataSize)
+{
+    // uint8, sint8, uint16, sint16, uint32, sint32
+    constexpr std::array<size_t, 6> sizes = {1, 1, 2, 2, 4, 4};
+    return dataSize < sizes.size() ? sizes[dataSize] : 0;
+}
+
+/** @brief Little endian PLDM message builder */
+class MessageWriter
+{
+  public:
+    /** @brief Start a payload or a record without a message header */
+    MessageWriter() = default;
+
+    /** @brief Start a message with MCTP type and PLDM header */
+    MessageWriter(const uint8_t headerByte, const uint8_t pldmType,
+                  const uint8_t pldmCommand) :
+        buffer{mctpTypePLDM, headerByte, pldmType, pldmCommand}
+    {
+    }
+
+    template <typename T>
+    MessageWriter& put(const T value)
+    {
+        static_assert(std::is_unsigned_v<T>);
+        for (size_t i = 0; i < sizeof(T); i++)
+        {
+            buffer.emplace_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+        return *this;
+    }
+
+    MessageWriter& putBytes(std::span<const uint8_t> data)
+    {
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        return *this;
+    }
+
+    MessageWriter& putValue(const NumericValue& value)
+    {
+        for (size_t i = 0; i < getDataSizeBytes(value.dataSize); i++)
+        {
+            buffer.emplace_back(static_cast<uint8_t>(value.value >> (8 * i)));
+        }
+        return *this;
+    }
+
+    std::vector<uint8_t> take()
+    {
+        return std::move(buffer);
+    }
+
+  private:
+    std::vector<uint8_t> buffer;
+};
+
+/** @brief Little endian PLDM payload reader */
+class MessageReader
+{
+  public:
+    explicit MessageReader(std::span<const uint8_t> payload) : data(payload)
+    {
+    }
+
+    template <typename T>
+    bool get(T& value)
+    {
+        static_assert(std::is_unsigned_v<T>);
+        if (data.size() < sizeof(T))
+        {
+            return false;
+        }
+        uint64_t result = 0;
+        for (size_t i = 0; i < sizeof(T); i++)
+        {
+            result |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        value = static_cast<T>(result);
+        data = data.subspan(sizeof(T));
+        return true;
+    }
+
+    bool skip(const size_t count)
+    {
+        if (data.size() < count)
+        {
+            return false;
+        }
+        data = data.subspan(count);
+        return true;
+    }
+
+    std::span<const uint8_t> remaining() const
+    {
+        return data;
+    }
+
+  private:
+    std::span<const uint8_t> data;
+};
+
+/** @brief PLDM responder state of one simulated terminus */
+class SimulatedTerminus
+{
+  public:
+    SimulatedTerminus(SimulatedTransport& _transport, TerminusConfig _config) :
+        config(std::move(_config)), transport(_transport)
+    {
+    }
+
+    /** @brief Handle a request sent by pldmd and build the response */
+    std::vector<uint8_t> handleRequest(const std::vector<uint8_t>& request);
+
+    /** @brief Handle the response to a request sent by the firmware device */
+    void handleResponse(const uint8_t msgTag, std::vector<uint8_t> response);
+
+    TerminusConfig config;
+    std::map<std::pair<uint8_t, uint8_t>, CommandStats> stats;
+
+  private:
+    void record(const uint8_t pldmType, const uint8_t cmd);
+    std::vector<uint8_t> handleBase(MessageWriter& resp, const uint8_t cmd,
+                                    MessageReader& req);
+    std::vector<uint8_t> handlePlatform(MessageWriter& resp, const uint8_t cmd,
+                                        MessageReader& req);
+    std::vector<uint8_t> handleFRU(MessageWriter& resp, const uint8_t cmd,
+                                   MessageReader& req);
+    std::vector<uint8_t> handleFWU(MessageWriter& resp, const uint8_t cmd,
+                                   MessageReader& req);
+    std::vector<uint8_t> getPDR(MessageWriter& resp, MessageReader& req);
+    std::vector<uint8_t> getPLDMTypes(MessageWriter& resp);
+    std::vector<uint8_t> getPLDMCommands(MessageWriter& resp,
+                                         MessageReader& req);
+    std::vector<uint8_t> getFirmwareParameters(MessageWriter& resp);
+    std::vector<uint8_t> getFRURecordTable(MessageWriter& resp,
+                                           MessageReader& req);
+    std::vector<uint8_t> getFRURecordTableMetadata(MessageWriter& resp);
+
+    void setFDState(const FDState newState);
+    void startDownload(const uint32_t imageSize);
+    std::optional<std::vector<uint8_t>>
+        sendFDRequest(boost::asio::yield_context yield, const uint8_t cmd,
+                      const std::vector<uint8_t>& payload);
+    std::vector<uint8_t> getPaddedFRUTable() const;
+
+    SimulatedTransport& transport;
+    uint8_t tid = 0;
+    FDState fdState = FDState::idle;
+    FDState fdPrevState = FDState::idle;
+    uint32_t maxTransferSize = fdMinTransferSize;
+    uint32_t downloadedBytes = 0;
+    uint32_t imageSize = 0;
+    uint32_t updateGeneration = 0;
+    uint8_t nextMsgTag = 0;
+    uint8_t nextInstanceId = 0;
+    std::map<uint8_t, std::function<void(std::vector<uint8_t>)>>
+        pendingRequests;
+};
+
+std::vector<uint8_t>
+    SimulatedTerminus::handleRequest(const std::vector<uint8_t>& request)
+{
+    const uint8_t instanceId =
+        static_cast<uint8_t>(request.at(1) & instanceIdMask);
+    const uint8_t pldmType = static_cast<uint8_t>(request.at(2) & pldmTypeMask);
+    const uint8_t cmd = request.at(3);
+    record(pldmType, cmd);
+    MessageWriter resp(instanceId, pldmType, cmd);
+    MessageReader req{std::span(request).subspan(msgHeaderSize)};
+
+    switch (pldmType)
+    {
+        case PLDM_BASE:
+            return handleBase(resp, cmd, req);
+        case PLDM_PLATFORM:
+            return handlePlatform(resp, cmd, req);
+        case PLDM_FRU:
+            return handleFRU(resp, cmd, req);
+        case PLDM_FWUP:
+            if (config.firmwareDevice)
+            {
+                return handleFWU(resp, cmd, req);
+            }
+            break;
+        default:
+            break;
+    }
+    return resp.put<uint8_t>(PLDM_ERROR_INVALID_PLDM_TYPE).take();
+}
+
+void SimulatedTerminus::handleResponse(const uint8_t msgTag,
+                                       std::vector<uint8_t> response)
+{
+    auto it = pendingRequests.find(msgTag);
+    if (it == pendingRequests.end() || response.size() < msgHeaderSize)
+    {
+        return;
+    }
+    record(static_cast<uint8_t>(response[2] & pldmTypeMask), response[3]);
+    response.erase(response.begin(), response.begin() + msgHeaderSize);
+    it->second(std::move(response));
+}
+
+void SimulatedTerminus::record(const uint8_t pldmType, const uint8_t cmd)
+{
+    CommandStats& entry = stats[{pldmType, cmd}];
+    const auto now = std::chrono::steady_clock::now();
+    if (!entry.count++)
+    {
+        entry.first = now;
+    }
+    entry.last = now;
+}
+
+std::vector<uint8_t> SimulatedTerminus::handleBase(MessageWriter& resp,
+                                                   const uint8_t cmd,
+                                                   MessageReader& req)
+{
+    switch (cmd)
+    {
+        case command::getTID:
+            return resp.put<uint8_t>(PLDM_SUCCESS).put(tid).take();
+        case command::setTID:
+            if (!req.get(tid))
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_LENGTH).take();
+            }
+            return resp.put<uint8_t>(PLDM_SUCCESS).take();
+        case command::getPLDMTypes:
+            return getPLDMTypes(resp);
+        case command::getPLDMVersion: {
+            uint32_t transferHandle = 0;
+            uint8_t transferOpFlag = 0;
+            uint8_t type = 0;
+            if (!req.get(transferHandle) || !req.get(transferOpFlag) ||
+                !req.get(type))
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_LENGTH).take();
+            }
+            const auto& version =
+                type == PLDM_PLATFORM ? platformVersion : pldmVersion;
+            uint32_t crc = crc32(version.data(), version.size());
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put<uint32_t>(0)
+                .put<uint8_t>(PLDM_START_AND_END)
+                .putBytes(version)
+                .put(crc)
+                .take();
+        }
+        case command::getPLDMCommands:
+            return getPLDMCommands(resp, req);
+        default:
+            break;
+    }
+    return resp.put<uint8_t>(PLDM_ERROR_UNSUPPORTED_PLDM_CMD).take();
+}
+
+std::vector<uint8_t> SimulatedTerminus::getPLDMTypes(MessageWriter& resp)
+{
+    uint64_t types = (1 << PLDM_BASE) | (1 << PLDM_PLATFORM) | (1 << PLDM_FRU);
+    if (config.firmwareDevice)
+    {
+        types |= (1 << PLDM_FWUP);
+    }
+    return resp.put<uint8_t>(PLDM_SUCCESS).put(types).take();
+}
+
+std::vector<uint8_t> SimulatedTerminus::getPLDMCommands(MessageWriter& resp,
+                                                        MessageReader& req)
+{
+    uint8_t type = 0;
+    if (!req.get(type))
+    {
+        return resp.put<uint8_t>(PLDM_ERROR_INVALID_LENGTH).take();
+    }
+
+    std::vector<uint8_t> commands;
+    switch (type)
+    {
+        case PLDM_BASE:
+            commands = {command::setTID, command::getTID,
+                        command::getPLDMVersion, command::getPLDMTypes,
+                        command::getPLDMCommands};
+            break;
+        case PLDM_PLATFORM:
+            commands = {command::getTerminusUID,
+                        command::setEventReceiver,
+                        command::setNumericSensorEnable,
+                        command::getSensorReading,
+                        command::setStateSensorEnables,
+                        command::getStateSensorReadings,
+                        command::setNumericEffecterEnable,
+                        command::setNumericEffecterValue,
+                        command::getNumericEffecterValue,
+                        command::setStateEffecterEnables,
+                        command::setStateEffecterStates,
+                        command::getStateEffecterStates,
+                        command::getPDRRepositoryInfo,
+                        command::getPDR};
+            break;
+        case PLDM_FRU:
+            commands = {command::getFRURecordTableMetadata,
+                        command::getFRURecordTable};
+            break;
+        case PLDM_FWUP:
+            if (config.firmwareDevice)
+            {
+                commands = {command::queryDeviceIdentifiers,
+                            command::getFirmwareParameters,
+                            command::requestUpdate,
+                            command::passComponentTable,
+                            command::updateComponent,
+                            command::activateFirmware,
+                            command::getStatus,
+                            command::cancelUpdateComponent,
+                            command::cancelUpdate};
+                break;
+            }
+            return resp.put<uint8_t>(PLDM_ERROR_INVALID_PLDM_TYPE).take();
+        default:
+            return resp.put<uint8_t>(PLDM_ERROR_INVALID_PLDM_TYPE).take();
+    }
+
+    std::array<uint8_t, 32> bitmap = {};
+    for (const uint8_t cmd : commands)
+    {
+        bitmap[cmd / 8] =
+            static_cast<uint8_t>(bitmap[cmd / 8] | 1 << (cmd % 8));
+    }
+    return resp.put<uint8_t>(PLDM_SUCCESS).putBytes(bitmap).take();
+}
+
+std::vector<uint8_t> SimulatedTerminus::handlePlatform(MessageWriter& resp,
+                                                       const uint8_t cmd,
+                                                       MessageReader& req)
+{
+    switch (cmd)
+    {
+        case command::getTerminusUID:
+            return resp.put<uint8_t>(PLDM_SUCCESS).putBytes(config.uuid).take();
+        case command::setEventReceiver:
+        case command::setNumericSensorEnable:
+        case command::setStateSensorEnables:
+        case command::setNumericEffecterEnable:
+        case command::setStateEffecterEnables:
+            return resp.put<uint8_t>(PLDM_SUCCESS).take();
+        case command::getPDRRepositoryInfo: {
+            uint32_t repoSize = 0;
+            uint32_t largestRecord = 0;
+            for (const auto& pdr : config.pdrs)
+            {
+                repoSize += static_cast<uint32_t>(pdr.size());
+                largestRecord =
+                    std::max(largestRecord, static_cast<uint32_t>(pdr.size()));
+            }
+            constexpr std::array<uint8_t, 13> updateTime = {};
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put<uint8_t>(0) // repositoryState: available
+                .putBytes(updateTime)
+                .putBytes(updateTime)
+                .put(static_cast<uint32_t>(config.pdrs.size()))
+                .put(repoSize)
+                .put(largestRecord)
+                .put<uint8_t>(0)
+                .take();
+        }
+        case command::getPDR:
+            return getPDR(resp, req);
+        case command::getSensorReading: {
+            uint16_t sensorID = 0;
+            auto it = req.get(sensorID) ? config.numericSensors.find(sensorID)
+                                        : config.numericSensors.end();
+            if (it == config.numericSensors.end())
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_DATA).take();
+            }
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put(it->second.dataSize)
+                .put<uint8_t>(0) // sensorOperationalState: enabled
+                .put<uint8_t>(0) // sensorEventMessageEnable
+                .put<uint8_t>(1) // presentState: normal
+                .put<uint8_t>(1) // previousState: normal
+                .put<uint8_t>(1) // eventState: normal
+                .putValue(it->second)
+                .take();
+        }
+        case command::getStateSensorReadings: {
+            uint16_t sensorID = 0;
+            auto it = req.get(sensorID) ? config.stateSensors.find(sensorID)
+                                        : config.stateSensors.end();
+            if (it == config.stateSensors.end())
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_DATA).take();
+            }
+            resp.put<uint8_t>(PLDM_SUCCESS)
+                .put(static_cast<uint8_t>(it->second.size()));
+            for (const uint8_t state : it->second)
+            {
+                resp.put<uint8_t>(0).put(state).put(state).put(state);
+            }
+            return resp.take();
+        }
+        case command::getNumericEffecterValue: {
+            uint16_t effecterID = 0;
+            auto it = req.get(effecterID)
+                          ? config.numericEffecters.find(effecterID)
+                          : config.numericEffecters.end();
+            if (it == config.numericEffecters.end())
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_DATA).take();
+            }
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put(it->second.dataSize)
+                .put<uint8_t>(1) // effecterOperState: enabled-noUpdatePending
+                .putValue(it->second)
+                .putValue(it->second)
+                .take();
+        }
+        case command::setNumericEffecterValue: {
+            uint16_t effecterID = 0;
+            uint8_t dataSize = 0;
+            auto it = req.get(effecterID)
+                          ? config.numericEffecters.find(effecterID)
+                          : config.numericEffecters.end();
+            if (it == config.numericEffecters.end() || !req.get(dataSize) ||
+                dataSize != it->second.dataSize)
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_DATA).take();
+            }
+            uint32_t value = 0;
+            auto data = req.remaining();
+            for (size_t i = 0;
+                 i < std::min(data.size(), getDataSizeBytes(dataSize)); i++)
+            {
+                value |= static_cast<uint32_t>(data[i]) << (8 * i);
+            }
+            it->second.value = value;
+            return resp.put<uint8_t>(PLDM_SUCCESS).take();
+        }
+        case command::getStateEffecterStates: {
+            uint16_t effecterID = 0;
+            auto it = req.get(effecterID)
+                          ? config.stateEffecters.find(effecterID)
+                          : config.stateEffecters.end();
+            if (it == config.stateEffecters.end())
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_DATA).take();
+            }
+            resp.put<uint8_t>(PLDM_SUCCESS)
+                .put(static_cast<uint8_t>(it->second.size()));
+            for (const uint8_t state : it->second)
+            {
+                resp.put<uint8_t>(1).put(state).put(state);
+            }
+            return resp.take();
+        }
+        case command::setStateEffecterStates: {
+            uint16_t effecterID = 0;
+            uint8_t count = 0;
+            auto it = req.get(effecterID)
+                          ? config.stateEffecters.find(effecterID)
+                          : config.stateEffecters.end();
+            if (it == config.stateEffecters.end() || !req.get(count))
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_DATA).take();
+            }
+            for (size_t i = 0; i < std::min<size_t>(count, it->second.size());
+                 i++)
+            {
+                uint8_t setRequest = 0;
+                uint8_t state = 0;
+                if (!req.get(setRequest) || !req.get(state))
+                {
+                    return resp.put<uint8_t>(PLDM_ERROR_INVALID_LENGTH).take();
+                }
+                if (setRequest)
+                {
+                    it->second[i] = state;
+                }
+            }
+            return resp.put<uint8_t>(PLDM_SUCCESS).take();
+        }
+        default:
+            break;
+    }
+    return resp.put<uint8_t>(PLDM_ERROR_UNSUPPORTED_PLDM_CMD).take();
+}
+
+std::vector<uint8_t> SimulatedTerminus::getPDR(MessageWriter& resp,
+                                               MessageReader& req)
+{
+    uint32_t recordHandle = 0;
+    uint32_t dataTransferHandle = 0;
+    uint8_t transferOpFlag = 0;
+    uint16_t requestCount = 0;
+    if (!req.get(recordHandle) || !req.get(dataTransferHandle) ||
+        !req.get(transferOpFlag) || !req.get(requestCount))
+    {
+        return resp.put<uint8_t>(PLDM_ERROR_INVALID_LENGTH).take();
+    }
+
+    auto getHandle = [](const std::vector<uint8_t>& pdr) {
+        MessageReader reader(pdr);
+        uint32_t handle = 0;
+        reader.get(handle);
+        return handle;
+    };
+    auto it = config.pdrs.begin();
+    if (recordHandle != 0)
+    {
+        it = std::find_if(config.pdrs.begin(), config.pdrs.end(),
+                          [&](const auto& pdr) {
+                              return getHandle(pdr) == recordHandle;
+                          });
+    }
+    const size_t offset =
+        transferOpFlag == PLDM_GET_FIRSTPART ? 0 : dataTransferHandle;
+    if (it == config.pdrs.end() || offset >= it->size() || requestCount == 0)
+    {
+        // PLDM_PLATFORM_INVALID_RECORD_HANDLE
+        return resp.put<uint8_t>(0x82).take();
+    }
+
+    const std::vector<uint8_t>& pdr = *it;
+    const size_t count = std::min<size_t>(requestCount, pdr.size() - offset);
+    const bool isLast = offset + count == pdr.size();
+    uint8_t transferFlag = 0;
+    if (offset == 0)
+    {
+        transferFlag = isLast ? PLDM_START_AND_END : PLDM_START;
+    }
+    else
+    {
+        transferFlag = isLast ? PLDM_END : PLDM_MIDDLE;
+    }
+    auto next = std::next(it);
+    resp.put<uint8_t>(PLDM_SUCCESS)
+        .put(next == config.pdrs.end() ? 0 : getHandle(*next))
+        .put(static_cast<uint32_t>(isLast ? 0 : offset + count))
+        .put(transferFlag)
+        .put(static_cast<uint16_t>(count))
+        .putBytes(std::span(pdr).subspan(offset, count));
+    if (transferFlag == PLDM_END)
+    {
+        resp.put(crc8(pdr.data(), pdr.size()));
+    }
+    return resp.take();
+}
+
+std::vector<uint8_t> SimulatedTerminus::getPaddedFRUTable() const
+{
+    std::vector<uint8_t> table = config.fruTable;
+    table.resize((table.size() + 3) & ~static_cast<size_t>(3), 0);
+    return table;
+}
+
+std::vector<uint8_t> SimulatedTerminus::handleFRU(MessageWriter& resp,
+                                                  const uint8_t cmd,
+                                                  MessageReader& req)
+{
+    switch (cmd)
+    {
+        case command::getFRURecordTableMetadata:
+            return getFRURecordTableMetadata(resp);
+        case command::getFRURecordTable:
+            return getFRURecordTable(resp, req);
+        default:
+            break;
+    }
+    return resp.put<uint8_t>(PLDM_ERROR_UNSUPPORTED_PLDM_CMD).take();
+}
+
+std::vector<uint8_t>
+    SimulatedTerminus::getFRURecordTableMetadata(MessageWriter& resp)
+{
+    std::vector<uint8_t> padded = getPaddedFRUTable();
+    return resp.put<uint8_t>(PLDM_SUCCESS)
+        .put<uint8_t>(1) // FRUDataMajorVersion
+        .put<uint8_t>(0) // FRUDataMinorVersion
+        .put(static_cast<uint32_t>(padded.size()))
+        .put(static_cast<uint32_t>(config.fruTable.size()))
+        .put(config.fruRecordSetCount)
+        .put(config.fruRecordCount)
+        .put(crc32(padded.data(), padded.size()))
+        .take();
+}
+
+std::vector<uint8_t> SimulatedTerminus::getFRURecordTable(MessageWriter& resp,
+                                                          MessageReader& req)
+{
+    uint32_t dataTransferHandle = 0;
+    uint8_t transferOpFlag = 0;
+    if (!req.get(dataTransferHandle) || !req.get(transferOpFlag))
+    {
+        return resp.put<uint8_t>(PLDM_ERROR_INVALID_LENGTH).take();
+    }
+    const size_t offset =
+        transferOpFlag == PLDM_GET_FIRSTPART ? 0 : dataTransferHandle;
+    const std::vector<uint8_t>& table = config.fruTable;
+    if (offset > table.size())
+    {
+        return resp.put<uint8_t>(PLDM_ERROR_INVALID_DATA).take();
+    }
+    const size_t count = std::min(fruTableChunkSize, table.size() - offset);
+    const bool isLast = offset + count == table.size();
+    uint8_t transferFlag = 0;
+    if (offset == 0)
+    {
+        transferFlag = isLast ? PLDM_START_AND_END : PLDM_START;
+    }
+    else
+    {
+        transferFlag = isLast ? PLDM_END : PLDM_MIDDLE;
+    }
+    return resp.put<uint8_t>(PLDM_SUCCESS)
+        .put(static_cast<uint32_t>(isLast ? 0 : offset + count))
+        .put(transferFlag)
+        .putBytes(std::span(table).subspan(offset, count))
+        .take();
+}
+
+static void putVersionString(MessageWriter& writer, const std::string& str)
+{
+    writer.put<uint8_t>(1) // ASCII
+        .put(static_cast<uint8_t>(str.size()))
+        .putBytes(std::span(reinterpret_cast<const uint8_t*>(str.data()),
+                            str.size()));
+}
+
+std::vector<uint8_t> SimulatedTerminus::handleFWU(MessageWriter& resp,
+                                                  const uint8_t cmd,
+                                                  MessageReader& req)
+{
+    const FirmwareDevice& fd = *config.firmwareDevice;
+    switch (cmd)
+    {
+        case command::queryDeviceIdentifiers: {
+            uint32_t length = 0;
+            for (const auto& descriptor : fd.descriptors)
+            {
+                length += static_cast<uint32_t>(4 + descriptor.data.size());
+            }
+            resp.put<uint8_t>(PLDM_SUCCESS)
+                .put(length)
+                .put(static_cast<uint8_t>(fd.descriptors.size()));
+            for (const auto& descriptor : fd.descriptors)
+            {
+                resp.put(descriptor.type)
+                    .put(static_cast<uint16_t>(descriptor.data.size()))
+                    .putBytes(descriptor.data);
+            }
+            return resp.take();
+        }
+        case command::getFirmwareParameters:
+            return getFirmwareParameters(resp);
+        case command::requestUpdate: {
+            uint32_t transferSize = 0;
+            if (!req.get(transferSize))
+            {
+                return resp.put<uint8_t>(PLDM_ERROR_INVALID_LENGTH).take();
+            }
+            if (fdState != FDState::idle)
+            {
+                // ALREADY_IN_UPDATE_MODE
+                return resp.put<uint8_t>(0x81).take();
+            }
+            maxTransferSize = std::max(transferSize, fdMinTransferSize);
+            setFDState(FDState::learnComponents);
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put<uint16_t>(0) // FirmwareDeviceMetaDataLength
+                .put<uint8_t>(0)  // FDWillSendGetPackageDataCommand
+                .take();
+        }
+        case command::passComponentTable: {
+            uint8_t transferFlag = 0;
+            if (fdState != FDState::learnComponents || !req.get(transferFlag))
+            {
+                // INVALID_STATE_FOR_COMMAND
+                return resp.put<uint8_t>(0x84).take();
+            }
+            if (transferFlag & PLDM_END)
+            {
+                setFDState(FDState::readyXfer);
+            }
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put<uint8_t>(0) // ComponentResponse: can be updated
+                .put<uint8_t>(0) // ComponentResponseCode
+                .take();
+        }
+        case command::updateComponent: {
+            uint32_t size = 0;
+            if (fdState != FDState::readyXfer || !req.skip(9) ||
+                !req.get(size))
+            {
+                return resp.put<uint8_t>(0x84).take();
+            }
+            startDownload(size);
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put<uint8_t>(0)  // ComponentCompatibilityResponse
+                .put<uint8_t>(0)  // ComponentCompatibilityResponseCode
+                .put<uint32_t>(0) // UpdateOptionFlagsEnabled
+                .put<uint16_t>(0) // TimeBeforeRequestFWData
+                .take();
+        }
+        case command::activateFirmware:
+            if (fdState != FDState::readyXfer)
+            {
+                return resp.put<uint8_t>(0x84).take();
+            }
+            setFDState(FDState::activate);
+            setFDState(FDState::idle);
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put<uint16_t>(0) // EstimatedTimeForSelfContainedActivation
+                .take();
+        case command::getStatus: {
+            uint8_t progress = 0;
+            if (fdState == FDState::download && imageSize)
+            {
+                progress = static_cast<uint8_t>(
+                    static_cast<uint64_t>(downloadedBytes) * 100 / imageSize);
+            }
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put(static_cast<uint8_t>(fdState))
+                .put(static_cast<uint8_t>(fdPrevState))
+                .put<uint8_t>(0) // AuxState
+                .put<uint8_t>(0) // AuxStateStatus
+                .put(progress)
+                .put<uint8_t>(0)  // ReasonCode
+                .put<uint32_t>(0) // UpdateOptionFlagsEnabled
+                .take();
+        }
+        case command::cancelUpdateComponent:
+            if (fdState == FDState::download || fdState == FDState::verify ||
+                fdState == FDState::apply)
+            {
+                updateGeneration++;
+                setFDState(FDState::readyXfer);
+            }
+            return resp.put<uint8_t>(PLDM_SUCCESS).take();
+        case command::cancelUpdate:
+            updateGeneration++;
+            setFDState(FDState::idle);
+            return resp.put<uint8_t>(PLDM_SUCCESS)
+                .put<uint8_t>(0)  // NonFunctioningComponentIndication
+                .put<uint64_t>(0) // NonFunctioningComponentBitmap
+                .take();
+        default:
+            break;
+    }
+    return resp.put<uint8_t>(PLDM_ERROR_UNSUPPORTED_PLDM_CMD).take();
+}
+
+std::vector<uint8_t>
+    SimulatedTerminus::getFirmwareParameters(MessageWriter& resp)
+{
+    const FirmwareDevice& fd = *config.firmwareDevice;
+    constexpr std::array<uint8_t, 8> releaseDate = {};
+    resp.put<uint8_t>(PLDM_SUCCESS)
+        .put<uint32_t>(0) // CapabilitiesDuringUpdate
+        .put(static_cast<uint16_t>(fd.components.size()))
+        .put<uint8_t>(1) // ActiveComponentImageSetVersionStringType
+        .put(static_cast<uint8_t>(fd.activeImageSetVersion.size()))
+        .put<uint8_t>(1)
+        .put(static_cast<uint8_t>(fd.pendingImageSetVersion.size()));
+    auto putString = [&resp](const std::string& str) {
+        resp.putBytes(std::span(reinterpret_cast<const uint8_t*>(str.data()),
+                                str.size()));
+    };
+    putString(fd.activeImageSetVersion);
+    putString(fd.pendingImageSetVersion);
+    for (const auto& component : fd.components)
+    {
+        resp.put(component.classification)
+            .put(component.identifier)
+            .put<uint8_t>(0) // ComponentClassificationIndex
+            .put(component.comparisonStamp)
+            .put<uint8_t>(1)
+            .put(static_cast<uint8_t>(component.activeVersion.size()))
+            .putBytes(releaseDate)
+            .put(component.comparisonStamp)
+            .put<uint8_t>(1)
+            .put(static_cast<uint8_t>(component.pendingVersion.size()))
+            .putBytes(releaseDate)
+            .put<uint16_t>(0)  // ComponentActivationMethods
+            .put<uint32_t>(0); // CapabilitiesDuringUpdate
+        putString(component.activeVersion);
+        putString(component.pendingVersion);
+    }
+    return resp.take();
+}
+
+void SimulatedTerminus::setFDState(const FDState newState)
+{
+    fdPrevState = fdState;
+    fdState = newState;
+}
+
+void SimulatedTerminus::startDownload(const uint32_t size)
+{
+    setFDState(FDState::download);
+    imageSize = size;
+    downloadedBytes = 0;
+    const uint32_t generation = ++updateGeneration;
+    boost::asio::spawn(transport.ioc, [this, generation](
+                                          boost::asio::yield_context yield) {
+        auto isCancelled = [this, generation]() {
+            return generation != updateGeneration;
+        };
+        while (downloadedBytes < imageSize && !isCancelled())
+        {
+            auto resp = sendFDRequest(yield, command::requestFirmwareData,
+                                      MessageWriter()
+                                          .put(downloadedBytes)
+                                          .put(maxTransferSize)
+                                          .take());
+            if (isCancelled())
+            {
+                return;
+            }
+            if (!resp || resp->empty() || resp->at(0) != PLDM_SUCCESS)
+            {
+                // The update agent did not answer, retry the same chunk
+                continue;
+            }
+            downloadedBytes += std::min(maxTransferSize,
+                                        imageSize - downloadedBytes);
+        }
+
+        sendFDRequest(yield, command::transferComplete,
+                      MessageWriter().put<uint8_t>(0).take());
+        if (isCancelled())
+        {
+            return;
+        }
+        setFDState(FDState::verify);
+        sendFDRequest(yield, command::verifyComplete,
+                      MessageWriter().put<uint8_t>(0).take());
+        if (isCancelled())
+        {
+            return;
+        }
+        setFDState(FDState::apply);
+        sendFDRequest(yield, command::applyComplete,
+                      MessageWriter().put<uint8_t>(0).put<uint16_t>(0).take());
+        if (!isCancelled())
+        {
+            setFDState(FDState::readyXfer);
+        }
+    });
+}
+
+std::optional<std::vector<uint8_t>>
+    SimulatedTerminus::sendFDRequest(boost::asio::yield_context yield,
+                                     const uint8_t cmd,
+                                     const std::vector<uint8_t>& payload)
+{
+    const uint8_t msgTag = nextMsgTag;
+    nextMsgTag = static_cast<uint8_t>((nextMsgTag + 1) & 0x07);
+    const uint8_t instanceId = nextInstanceId;
+    nextInstanceId =
+        static_cast<uint8_t>((nextInstanceId + 1) & instanceIdMask);
+    MessageWriter request(static_cast<uint8_t>(requestBit | instanceId),
+                          PLDM_FWUP, cmd);
+    request.putBytes(payload);
+
+    std::optional<std::vector<uint8_t>> response;
+    boost::asio::steady_timer timer(transport.ioc, fdResponseTimeout);
+    pendingRequests[msgTag] = [&response, &timer](std::vector<uint8_t> resp) {
+        response = std::move(resp);
+        timer.cancel();
+    };
+    transport.deliverToHost(*this, msgTag, true, request.take());
+    boost::system::error_code ec;
+    timer.async_wait(yield[ec]);
+    pendingRequests.erase(msgTag);
+    return response;
+}
+
+SimulatedTransport::SimulatedTransport(
+    boost::asio::io_context& _ioc, std::vector<TerminusConfig> terminusConfigs,
+    const mctpw::ReceiveMessageCallback& _onMessage, const uint32_t seed) :
+    ioc(_ioc),
+    onMessage(_onMessage), rng(seed)
+{
+    for (auto& config : terminusConfigs)
+    {
+        const mctpw::eid_t eid = config.eid;
+        termini.insert_or_assign(
+            eid, std::make_unique<SimulatedTerminus>(*this, std::move(config)));
+    }
+}
+
+SimulatedTransport::~SimulatedTransport() = default;
+
+void SimulatedTransport::detectEndpoints(boost::asio::yield_context)
+{
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Simulated transport with " + std::to_string(termini.size()) +
+         " termini")
+            .c_str());
+}
+
+std::vector<mctpw::eid_t> SimulatedTransport::getEndpoints()
+{
+    std::vector<mctpw::eid_t> endpoints;
+    for (const auto& [eid, terminus] : termini)
+    {
+        endpoints.emplace_back(eid);
+    }
+    return endpoints;
+}
+
+std::chrono::steady_clock::time_point
+    SimulatedTransport::reserveSlot(const SimulatedTerminus& terminus)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (terminus.config.mux != 0)
+    {
+        auto& busyUntil = muxBusyUntil[terminus.config.mux];
+        start = std::max(start, busyUntil);
+        busyUntil = start + terminus.config.latency;
+    }
+    return start + terminus.config.latency;
+}
+
+void SimulatedTransport::runAt(const std::chrono::steady_clock::time_point when,
+                               std::function<void()> action)
+{
+    auto timer = std::make_shared<boost::asio::steady_timer>(ioc, when);
+    timer->async_wait(
+        [timer, action{std::move(action)}](const boost::system::error_code&) {
+            action();
+        });
+}
+
+bool SimulatedTransport::isLost(const SimulatedTerminus& terminus)
+{
+    if (terminus.config.lossRate <= 0.0)
+    {
+        return false;
+    }
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    return distribution(rng) < terminus.config.lossRate;
+}
+
+void SimulatedTransport::deliverToHost(SimulatedTerminus& terminus,
+                                       const uint8_t msgTag,
+                                       const bool tagOwner,
+                                       std::vector<uint8_t> message)
+{
+    runAt(reserveSlot(terminus),
+          [this, eid = terminus.config.eid, msgTag, tagOwner,
+           message{std::move(message)}]() {
+              onMessage(nullptr, eid, tagOwner, msgTag, message, 0);
+          });
+}
+
+void SimulatedTransport::deliverToTerminus(SimulatedTerminus& terminus,
+                                           const uint8_t msgTag,
+                                           const bool tagOwner,
+                                           std::vector<uint8_t> message)
+{
+    if (message.size() < msgHeaderSize)
+    {
+        return;
+    }
+    runAt(reserveSlot(terminus), [&terminus, msgTag, tagOwner,
+                                  message{std::move(message)}]() {
+        if (!tagOwner)
+        {
+            terminus.handleResponse(msgTag, message);
+        }
+        else if (message[1] & requestBit)
+        {
+            // Request without a response expected by pldmd
+            terminus.handleRequest(message);
+        }
+    });
+}
+
+Transport::SendReceiveStatus SimulatedTransport::sendReceiveYield(
+    boost::asio::yield_context yield, const mctpw::eid_t dstEid,
+    const std::vector<uint8_t>& request,
+    const std::chrono::milliseconds timeout)
+{
+    boost::system::error_code ec;
+    auto yieldWithEc = yield[ec];
+    std::vector<uint8_t> response = boost::asio::async_initiate<
+        boost::asio::yield_context,
+        void(boost::system::error_code, std::vector<uint8_t>)>(
+        [this, dstEid, &request, timeout](auto handler) {
+            auto sharedHandler =
+                std::make_shared<decltype(handler)>(std::move(handler));
+            sendReceiveAsync(
+                [sharedHandler](boost::system::error_code errorCode,
+                                const std::vector<uint8_t>& resp) {
+                    (*sharedHandler)(errorCode, resp);
+                },
+                dstEid, request, timeout);
+        },
+        yieldWithEc);
+    return {ec, std::move(response)};
+}
+
+void SimulatedTransport::sendReceiveAsync(
+    ReceiveCallback callback, const mctpw::eid_t dstEid,
+    const std::vector<uint8_t>& request,
+    const std::chrono::milliseconds timeout)
+{
+    auto it = termini.find(dstEid);
+    if (it == termini.end() || request.size() < msgHeaderSize ||
+        !(request[1] & requestBit))
+    {
+        boost::asio::post(ioc, [callback]() {
+            callback(boost::asio::error::host_unreachable, {});
+        });
+        return;
+    }
+
+    SimulatedTerminus& terminus = *it->second;
+    const auto now = std::chrono::steady_clock::now();
+    const auto requestArrival = reserveSlot(terminus);
+    if (isLost(terminus) ||
+        requestArrival + terminus.config.latency - now > timeout)
+    {
+        runAt(now + timeout, [callback]() {
+            callback(boost::asio::error::timed_out, {});
+        });
+        return;
+    }
+    runAt(requestArrival, [this, &terminus, callback, request]() {
+        // The response travels back over the same mux
+        runAt(reserveSlot(terminus),
+              [callback, response{terminus.handleRequest(request)}]() {
+                  callback(boost::system::error_code{}, response);
+              });
+    });
+}
+
+Transport::SendStatus SimulatedTransport::sendYield(
+    boost::asio::yield_context, const mctpw::eid_t dstEid, const uint8_t msgTag,
+    const bool tagOwner, const std::vector<uint8_t>& payload)
+{
+    auto it = termini.find(dstEid);
+    if (it == termini.end())
+    {
+        return {boost::asio::error::host_unreachable, -1};
+    }
+    deliverToTerminus(*it->second, msgTag, tagOwner, payload);
+    return {boost::system::error_code{}, 0};
+}
+
+void SimulatedTransport::sendAsync(SendCallback callback,
+                                   const mctpw::eid_t dstEid,
+                                   const uint8_t msgTag, const bool tagOwner,
+                                   const std::vector<uint8_t>& payload)
+{
+    SendStatus status{boost::asio::error::host_unreachable, -1};
+    auto it = termini.find(dstEid);
+    if (it != termini.end())
+    {
+        deliverToTerminus(*it->second, msgTag, tagOwner, payload);
+        status = {boost::system::error_code{}, 0};
+    }
+    boost::asio::post(ioc, [callback, status]() {
+        callback(status.first, status.second);
+    });
+}
+
+int SimulatedTransport::reserveBandwidth(boost::asio::yield_context,
+                                         const mctpw::eid_t, const uint16_t)
+{
+    return 0;
+}
+
+int SimulatedTransport::releaseBandwidth(boost::asio::yield_context,
+                                         const mctpw::eid_t)
+{
+    return 0;
+}
+
+void SimulatedTransport::triggerDeviceDiscovery(const mctpw::eid_t)
+{
+}
+
+std::optional<std::string>
+    SimulatedTransport::getDeviceLocation(const mctpw::eid_t dstEid)
+{
+    auto it = termini.find(dstEid);
+    if (it == termini.end())
+    {
+        return std::nullopt;
+    }
+    return "Simulated mux " + std::to_string(it->second->config.mux);
+}
+
+bool SimulatedTransport::supportsConcurrentRequests(const mctpw::eid_t dstEid)
+{
+    auto it = termini.find(dstEid);
+    return it != termini.end() && it->second->config.mux == 0;
+}
+
+TerminusConfig* SimulatedTransport::getTerminusConfig(const mctpw::eid_t eid)
+{
+    auto it = termini.find(eid);
+    return it == termini.end() ? nullptr : &it->second->config;
+}
+
+CommandStats SimulatedTransport::getCommandStats(const uint8_t pldmType,
+                                                const uint8_t command) const
+{
+    CommandStats total;
+    for (const auto& [eid, terminus] : termini)
+    {
+        auto it = terminus->stats.find({pldmType, command});
+        if (it == terminus->stats.end())
+        {
+            continue;
+        }
+        const CommandStats& entry = it->second;
+        total.first =
+            total.count ? std::min(total.first, entry.first) : entry.first;
+        total.last = std::max(total.last, entry.last);
+        total.count += entry.count;
+    }
+    return total;
+}
+
+void SimulatedTransport::resetStats()
+{
+    for (auto& [eid, terminus] : termini)
+    {
+        terminus->stats.clear();
+    }
+}
+
+static void putPDRHeader(MessageWriter& pdr, const uint32_t recordHandle,
+                         const uint8_t pdrType)
+{
+    pdr.put(recordHandle)
+        .put<uint8_t>(1) // PDRHeaderVersion
+        .put(pdrType)
+        .put<uint16_t>(0)  // recordChangeNumber
+        .put<uint16_t>(0); // dataLength, patched by finishPDR
+}
+
+static std::vector<uint8_t> finishPDR(MessageWriter& pdr)
+{
+    std::vector<uint8_t> record = pdr.take();
+    constexpr size_t pdrHeaderSize = 10;
+    const uint16_t dataLength =
+        static_cast<uint16_t>(record.size() - pdrHeaderSize);
+    record[8] = static_cast<uint8_t>(dataLength);
+    record[9] = static_cast<uint8_t>(dataLength >> 8);
+    return record;
+}
+
+static uint32_t toReal32(const float value)
+{
+    uint32_t raw = 0;
+    std::memcpy(&raw, &value, sizeof(raw));
+    return raw;
+}
+
+std::vector<uint8_t> makeNumericSensorPDR(const uint32_t recordHandle,
+                                          const uint16_t sensorID,
+                                          const uint16_t entityType,
+                                          const uint16_t entityInstance,
+                                          const uint8_t baseUnit)
+{
+    constexpr uint8_t numericSensorPDR = 2;
+    MessageWriter pdr;
+    putPDRHeader(pdr, recordHandle, numericSensorPDR);
+    pdr.put<uint16_t>(0) // PLDMTerminusHandle
+        .put(sensorID)
+        .put(entityType)
+        .put(entityInstance)
+        .put<uint16_t>(0) // containerID
+        .put<uint8_t>(0)  // sensorInit: noInit
+        .put<uint8_t>(0)  // sensorAuxiliaryNamesPDR
+        .put(baseUnit)
+        .put<uint8_t>(0) // unitModifier
+        .put<uint8_t>(0) // rateUnit
+        .put<uint8_t>(0) // baseOEMUnitHandle
+        .put<uint8_t>(0) // auxUnit
+        .put<uint8_t>(0) // auxUnitModifier
+        .put<uint8_t>(0) // auxRateUnit
+        .put<uint8_t>(0) // rel
+        .put<uint8_t>(0) // auxOEMUnitHandle
+        .put<uint8_t>(1) // isLinear
+        .put<uint8_t>(0) // sensorDataSize: uint8
+        .put(toReal32(1.0f))
+        .put(toReal32(0.0f))
+        .put<uint16_t>(0) // accuracy
+        .put<uint8_t>(0)  // plusTolerance
+        .put<uint8_t>(0)  // minusTolerance
+        .put<uint8_t>(0)  // hysteresis
+        .put<uint8_t>(0)  // supportedThresholds
+        .put<uint8_t>(0)  // thresholdAndHysteresisVolatility
+        .put(toReal32(0.0f))
+        .put(toReal32(1.0f)) // updateInterval
+        .put<uint8_t>(255)   // maxReadable
+        .put<uint8_t>(0)     // minReadable
+        .put<uint8_t>(0)     // rangeFieldFormat: uint8
+        .put<uint8_t>(0);    // rangeFieldSupport
+    for (size_t i = 0; i < 9; i++)
+    {
+        // nominalValue, normal, warning, critical and fatal limits
+        pdr.put<uint8_t>(0);
+    }
+    return finishPDR(pdr);
+}
+
+std::vector<uint8_t> makeStateSensorPDR(const uint32_t recordHandle,
+                                        const uint16_t sensorID,
+                                        const uint16_t entityType,
+                                        const uint16_t entityInstance,
+                                        const uint16_t stateSetID,
+                                        const uint8_t possibleStates)
+{
+    constexpr uint8_t stateSensorPDR = 4;
+    MessageWriter pdr;
+    putPDRHeader(pdr, recordHandle, stateSensorPDR);
+    pdr.put<uint16_t>(0) // PLDMTerminusHandle
+        .put(sensorID)
+        .put(entityType)
+        .put(entityInstance)
+        .put<uint16_t>(0) // containerID
+        .put<uint8_t>(0)  // sensorInit: noInit
+        .put<uint8_t>(0)  // sensorAuxiliaryNamesPDR
+        .put<uint8_t>(1)  // compositeSensorCount
+        .put(stateSetID)
+        .put<uint8_t>(1) // possibleStatesSize
+        .put(possibleStates);
+    return finishPDR(pdr);
+}
+
+std::vector<uint8_t> makeGeneralFRURecord(
+    const uint16_t recordSetID,
+    const std::vector<std::pair<uint8_t, std::string>>& fields)
+{
+    MessageWriter record;
+    record.put(recordSetID)
+        .put<uint8_t>(1) // recordType: general
+        .put(static_cast<uint8_t>(fields.size()))
+        .put<uint8_t>(1); // encodingType: ASCII
+    for (const auto& [type, value] : fields)
+    {
+        record.put(type)
+            .put(static_cast<uint8_t>(value.size()))
+            .putBytes(std::span(reinterpret_cast<const uint8_t*>(value.data()),
+                                value.size()));
+    }
+    return record.take();
+}
+
+TerminusConfig makeDefaultTerminus(const mctpw::eid_t eid,
+                                   const size_t numericSensorCount,
+                                   const size_t stateSensorCount)
+{
+    // Entity and state set values as defined by DSP0249
+    constexpr uint16_t processorEntity = 135;
+    constexpr uint8_t degreesC = 2;
+    constexpr uint16_t operationalFaultStatus = 10;
+    constexpr uint8_t faultStatusStates = 0x0E; // normal, error, fatal
+    constexpr uint16_t stateSensorIDBase = 0x1000;
+
+    TerminusConfig config;
+    config.eid = eid;
+    config.uuid = {'P', 'L', 'D', 'M', 'S', 'I', 'M', 0, 0, 0, 0, 0, 0, 0, 0,
+                   eid};
+    uint32_t recordHandle = 1;
+    for (size_t i = 0; i < numericSensorCount; i++)
+    {
+        const uint16_t sensorID = static_cast<uint16_t>(i + 1);
+        config.pdrs.emplace_back(makeNumericSensorPDR(
+            recordHandle++, sensorID, processorEntity, sensorID, degreesC));
+        config.numericSensors.emplace(
+            sensorID, NumericValue{0, static_cast<uint32_t>(40 + i % 20)});
+    }
+    for (size_t i = 0; i < stateSensorCount; i++)
+    {
+        const uint16_t sensorID = static_cast<uint16_t>(stateSensorIDBase + i);
+        config.pdrs.emplace_back(makeStateSensorPDR(
+            recordHandle++, sensorID, processorEntity,
+            static_cast<uint16_t>(i + 1), operationalFaultStatus,
+            faultStatusStates));
+        config.stateSensors.emplace(sensorID, std::vector<uint8_t>{1});
+    }
+
+    // General FRU field types as defined by DSP0257
+    const std::string eidStr = std::to_string(eid);
+    config.fruTable = makeGeneralFRURecord(
+        1, {{8, "Simulated Terminus " + eidStr},
+            {5, "Intel Corporation"},
+            {3, "SIM-" + eidStr},
+            {4, "SN" + eidStr}});
+    config.fruRecordSetCount = 1;
+    config.fruRecordCount = 1;
+
+    FirmwareDevice fd;
+    constexpr uint16_t pciVendorID = 0x0000;
+    fd.descriptors.push_back({pciVendorID, {0x86, 0x80}});
+    fd.activeImageSetVersion = "1.0.0";
+    fd.components.push_back({0x000A, 1, 1, "1.0.0", ""});
+    config.firmwareDevice = std::move(fd);
+    return config;
+}
+
+static std::optional<unsigned long> getEnvNumber(const char* name)
+{
+    const char* value = std::getenv(name);
+    if (!value || !*value)
+    {
+        return std::nullopt;
+    }
+    return std::strtoul(value, nullptr, 0);
+}
+
+std::unique_ptr<Transport>
+    createTransportFromEnvironment(boost::asio::io_context& ioc,
+                                   const mctpw::ReceiveMessageCallback& onMsg)
+{
+    auto terminusCount = getEnvNumber("PLDM_SIMULATOR_TERMINI");
+    if (!terminusCount || *terminusCount == 0)
+    {
+        return nullptr;
+    }
+    constexpr mctpw::eid_t firstEid = 8;
+    constexpr unsigned long maxTermini = 0xFF - firstEid;
+    constexpr size_t numericSensorCount = 16;
+    constexpr size_t stateSensorCount = 4;
+    const unsigned long count = std::min(*terminusCount, maxTermini);
+    const auto latency = std::chrono::microseconds(
+        getEnvNumber("PLDM_SIMULATOR_LATENCY_US").value_or(0));
+    const unsigned long muxCount =
+        getEnvNumber("PLDM_SIMULATOR_MUXES").value_or(0);
+    const char* lossEnv = std::getenv("PLDM_SIMULATOR_LOSS");
+    const double lossRate = lossEnv ? std::strtod(lossEnv, nullptr) : 0.0;
+
+    std::vector<TerminusConfig> termini;
+    for (unsigned long i = 0; i < count; i++)
+    {
+        TerminusConfig config =
+            makeDefaultTerminus(static_cast<mctpw::eid_t>(firstEid + i),
+                                numericSensorCount, stateSensorCount);
+        config.latency = latency;
+        config.lossRate = lossRate;
+        config.mux =
+            muxCount ? static_cast<uint8_t>(1 + i % std::min(muxCount, 255UL))
+                     : 0;
+        termini.emplace_back(std::move(config));
+    }
+    phosphor::logging::log<phosphor::logging::level::WARNING>(
+        "Using simulated PLDM transport instead of MCTP");
+    return std::make_unique<SimulatedTransport>(
+        ioc, std::move(termini), onMsg,
+        static_cast<uint32_t>(getEnvNumber("PLDM_SIMULATOR_SEED").value_or(1)));
+}
+} // namespace simulator
+} // namespace pldm
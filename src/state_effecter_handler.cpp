@@ -54,7 +54,8 @@ void StateEffecterHandler::setInitialProperties()
     effecterInterface->register_property("StateSetID",
                                          _pdr->possibleStates[0].stateSetID);
     effecterInterface->register_property(
-        "PossibleStates", _pdr->possibleStates[0].possibleStateSetValues);
+        "PossibleStates",
+        getPossibleStateValues(_pdr->possibleStates[0].possibleStateSetValues));
 
     availableInterface = addUniqueInterface(
         path, "xyz.openbmc_project.State.Decorator.Availability");
@@ -408,10 +409,7 @@ bool StateEffecterHandler::populateEffecterValue(
 bool StateEffecterHandler::isEffecterStateSettable(const uint8_t state)
 {
     // Note:- possibleStates will never be empty
-    auto itr =
-        std::find(_pdr->possibleStates[0].possibleStateSetValues.begin(),
-                  _pdr->possibleStates[0].possibleStateSetValues.end(), state);
-    if (itr != _pdr->possibleStates[0].possibleStateSetValues.end())
+    if (_pdr->possibleStates[0].possibleStateSetValues[state])
     {
         return true;
     }
@@ -492,12 +490,19 @@ void StateEffecterHandler::registerSetEffecter()
                 throw sdbusplus::exception::SdBusError(
                     -EINVAL, "Unsupported effecter state");
             }
-            if (!setEffecter(yield, effecterState))
+            // The handler may be destroyed while the write waits
+            const EffecterID effecterID = _effecterID;
+            const pldm_tid_t tid = _tid;
+            if (!writeQueue.write(yield, effecterState,
+                                  [this](boost::asio::yield_context yieldCtx,
+                                         uint8_t state) {
+                                      return setEffecter(yieldCtx, state);
+                                  }))
             {
                 phosphor::logging::log<phosphor::logging::level::ERR>(
                     "Failed to SetStateEffecterStates",
-                    phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
-                    phosphor::logging::entry("TID=%d", _tid));
+                    phosphor::logging::entry("EFFECTER_ID=0x%0X", effecterID),
+                    phosphor::logging::entry("TID=%d", tid));
 
                 throw sdbusplus::exception::SdBusError(
                     -EINVAL, "SetStateEffecterStates failed");
@@ -516,6 +521,12 @@ void StateEffecterHandler::registerSetEffecter()
                     boost::asio::chrono::seconds(transitionIntervalSec));
                 transitionIntervalTimer->async_wait(
                     [this](const boost::system::error_code& e) {
+                        // Re-armed by a later set, only the last one reads
+                        // back the state
+                        if (e == boost::asio::error::operation_aborted)
+                        {
+                            return;
+                        }
                         if (e)
                         {
                             phosphor::logging::log<
@@ -542,6 +553,10 @@ void StateEffecterHandler::registerSetEffecter()
             // Refresh the value on D-Bus
             getIoContext()->post(refreshEffecterInterfaces);
         });
+    // Returns requests, sets sent, superseded requests and current depth
+    setEffecterInterface->register_method(
+        "GetWriteQueueStatistics",
+        [this]() { return writeQueue.getStatistics(); });
     setEffecterInterface->initialize();
 }
 
@@ -569,5 +584,19 @@ bool StateEffecterHandler::effecterHandlerInit(boost::asio::yield_context yield)
     return true;
 }
 
+void StateEffecterHandler::addMemoryUsage(MemoryUsage& usage) const
+{
+    usage.effecters++;
+    usage.bytes += sizeof(StateEffecterHandler) + sizeof(StateEffecterPDR) +
+                   getMemoryUsage(_pdr->possibleStates);
+    usage.addString(_name);
+    usage.addInterfaces(effecterInterface, availableInterface,
+                        operationalInterface, setEffecterInterface);
+    if (transitionIntervalTimer)
+    {
+        usage.bytes += sizeof(boost::asio::steady_timer);
+    }
+}
+
 } // namespace platform
 } // namespace pldm
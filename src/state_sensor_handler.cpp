@@ -35,57 +35,78 @@ StateSensorHandler::StateSensorHandler(
     _tid(tid),
     _sensorID(sensorID), _name(name), _pdr(pdr)
 {
-    if (_pdr->possibleStates.empty())
+    if (_pdr->possibleStates.empty() ||
+        _pdr->possibleStates.size() > maxCompositeSensorCount)
     {
         throw std::runtime_error("State sensor PDR data invalid");
     }
 
+    compositeSensors.resize(_pdr->possibleStates.size());
     setInitialProperties();
 }
 
-void StateSensorHandler::setInitialProperties()
+std::string
+    StateSensorHandler::getCompositeSensorName(const size_t offset) const
 {
-    std::string path =
-        pldmPath + std::to_string(_tid) + "/state_sensor/" + _name;
-
-    sensorInterface =
-        addUniqueInterface(path, "xyz.openbmc_project.Sensor.State");
-    // Composite sensors are not supported. Thus extract only first sensor
-    // states
-    sensorInterface->register_property("StateSetID",
-                                       _pdr->possibleStates[0].stateSetID);
-    sensorInterface->register_property(
-        "PossibleStates", _pdr->possibleStates[0].possibleStateSetValues);
-
-    availableInterface = addUniqueInterface(
-        path, "xyz.openbmc_project.State.Decorator.Availability");
-
-    operationalInterface = addUniqueInterface(
-        path, "xyz.openbmc_project.State.Decorator.OperationalStatus");
+    // First offset keeps the sensor name so that non-composite sensors are
+    // exposed as before
+    if (offset == 0)
+    {
+        return _name;
+    }
+    return _name + "_" + std::to_string(offset);
 }
 
-void StateSensorHandler::initializeInterface()
+void StateSensorHandler::setInitialProperties()
 {
-    if (!interfaceInitialized)
+    for (size_t offset = 0; offset < compositeSensors.size(); offset++)
     {
-        sensorInterface->register_property("PreviousState",
-                                           previousStateReading);
-        sensorInterface->register_property("CurrentState", currentStateReading);
-        sensorInterface->initialize();
-
-        availableInterface->register_property("Available", isAvailableReading);
-        availableInterface->initialize();
+        CompositeSensor& sensor = compositeSensors[offset];
+        const PossibleStates& possibleStates = _pdr->possibleStates[offset];
+        std::string path = pldmPath + std::to_string(_tid) + "/state_sensor/" +
+                           getCompositeSensorName(offset);
+
+        sensor.sensorInterface =
+            addUniqueInterface(path, "xyz.openbmc_project.Sensor.State");
+        sensor.sensorInterface->register_property("StateSetID",
+                                                  possibleStates.stateSetID);
+        sensor.sensorInterface->register_property(
+            "PossibleStates",
+            getPossibleStateValues(possibleStates.possibleStateSetValues));
+
+        sensor.availableInterface = addUniqueInterface(
+            path, "xyz.openbmc_project.State.Decorator.Availability");
+
+        sensor.operationalInterface = addUniqueInterface(
+            path, "xyz.openbmc_project.State.Decorator.OperationalStatus");
+    }
+}
 
-        operationalInterface->register_property("Functional",
-                                                isFuntionalReading);
-        operationalInterface->initialize();
-        interfaceInitialized = true;
+void StateSensorHandler::initializeInterface(CompositeSensor& sensor)
+{
+    if (!sensor.interfaceInitialized)
+    {
+        sensor.sensorInterface->register_property("PreviousState",
+                                                  sensor.previousStateReading);
+        sensor.sensorInterface->register_property("CurrentState",
+                                                  sensor.currentStateReading);
+        sensor.sensorInterface->initialize();
+
+        sensor.availableInterface->register_property(
+            "Available", sensor.isAvailableReading);
+        sensor.availableInterface->initialize();
+
+        sensor.operationalInterface->register_property(
+            "Functional", sensor.isFuntionalReading);
+        sensor.operationalInterface->initialize();
+        sensor.interfaceInitialized = true;
     }
 }
 
-void StateSensorHandler::markFunctional(bool isFunctional)
+void StateSensorHandler::markFunctional(CompositeSensor& sensor,
+                                        bool isFunctional)
 {
-    if (!operationalInterface)
+    if (!sensor.operationalInterface)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Operational interface not initialized",
@@ -94,24 +115,20 @@ void StateSensorHandler::markFunctional(bool isFunctional)
         return;
     }
 
-    if (!interfaceInitialized)
+    if (!sensor.interfaceInitialized)
     {
-        isFuntionalReading = isFunctional;
+        sensor.isFuntionalReading = isFunctional;
     }
     else
     {
-        operationalInterface->set_property("Functional", isFunctional);
-    }
-
-    if (isFunctional)
-    {
-        errCount = 0;
+        sensor.operationalInterface->set_property("Functional", isFunctional);
     }
 }
 
-void StateSensorHandler::markAvailable(bool isAvailable)
+void StateSensorHandler::markAvailable(CompositeSensor& sensor,
+                                       bool isAvailable)
 {
-    if (!availableInterface)
+    if (!sensor.availableInterface)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Avaliable interface not initialized",
@@ -120,13 +137,13 @@ void StateSensorHandler::markAvailable(bool isAvailable)
         return;
     }
 
-    if (!interfaceInitialized)
+    if (!sensor.interfaceInitialized)
     {
-        isAvailableReading = isAvailable;
+        sensor.isAvailableReading = isAvailable;
     }
     else
     {
-        availableInterface->set_property("Available", isAvailable);
+        sensor.availableInterface->set_property("Available", isAvailable);
     }
 }
 
@@ -144,8 +161,8 @@ void StateSensorHandler::incrementError()
             "State sensor reading failed",
             phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
             phosphor::logging::entry("TID=%d", _tid));
-        updateState(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE, sensorAvailable,
-                    sensorNonFunctional);
+        updateStates(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE, sensorAvailable,
+                     sensorNonFunctional);
     }
 }
 
@@ -154,10 +171,26 @@ bool StateSensorHandler::sensorErrorCheck()
     return errCount < errorThreshold;
 }
 
-void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
+void StateSensorHandler::addMemoryUsage(MemoryUsage& usage) const
+{
+    usage.sensors++;
+    usage.bytes += sizeof(StateSensorHandler) + sizeof(StateSensorPDR) +
+                   getMemoryUsage(_pdr->possibleStates);
+    usage.addString(_name);
+    usage.bytes += compositeSensors.capacity() * sizeof(CompositeSensor);
+    for (const CompositeSensor& sensor : compositeSensors)
+    {
+        usage.addInterfaces(sensor.sensorInterface, sensor.availableInterface,
+                            sensor.operationalInterface);
+    }
+}
+
+void StateSensorHandler::logStateChangeEvent(const size_t offset,
+                                             const uint8_t currentState,
                                              const uint8_t previousState)
 {
-    auto stateSetItr = stateSetMap.find(_pdr->possibleStates[0].stateSetID);
+    auto stateSetItr =
+        stateSetMap.find(_pdr->possibleStates[offset].stateSetID);
     if (stateSetItr == stateSetMap.end())
     {
         return;
@@ -184,8 +217,9 @@ void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
 
     std::string messageID =
         "OpenBMC.0.1." + std::string(currentStateSetValueInfo.redfishMessageID);
+    const std::string name = getCompositeSensorName(offset);
     std::string message =
-        std::string(stateSetName) + " of " + _name +
+        std::string(stateSetName) + " of " + name +
         " state sensor changed from " +
         std::string(previousStateSetValueInfo.stateSetValueName) + " to " +
         std::string(currentStateSetValueInfo.stateSetValueName);
@@ -194,79 +228,96 @@ void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
         message.c_str(),
         phosphor::logging::entry("REDFISH_MESSAGE_ID=%s", messageID.c_str()),
         phosphor::logging::entry("REDFISH_MESSAGE_ARGS=%s,%s,%s,%s",
-                                 stateSetName, _name.c_str(),
+                                 stateSetName, name.c_str(),
                                  previousStateSetValueInfo.stateSetValueName,
                                  currentStateSetValueInfo.stateSetValueName));
 }
 
-void StateSensorHandler::updateState(const uint8_t currentState,
+void StateSensorHandler::updateState(const size_t offset,
+                                     const uint8_t currentState,
                                      const uint8_t previousState,
                                      bool isAvailable, bool isFunctional)
 {
-    if (!sensorInterface)
+    CompositeSensor& sensor = compositeSensors[offset];
+    if (!sensor.sensorInterface)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Sensor interface not initialized");
         return;
     }
 
-    if (!interfaceInitialized)
+    if (!sensor.interfaceInitialized)
     {
-        currentStateReading = currentState;
-        previousStateReading = previousState;
+        sensor.currentStateReading = currentState;
+        sensor.previousStateReading = previousState;
     }
     else
     {
-        if ((currentStateReading != currentState &&
+        if ((sensor.currentStateReading != currentState &&
              currentState != PLDM_INVALID_VALUE) ||
-            (previousStateReading != previousState &&
+            (sensor.previousStateReading != previousState &&
              previousState != PLDM_INVALID_VALUE))
         {
-            logStateChangeEvent(currentState, previousState);
+            logStateChangeEvent(offset, currentState, previousState);
         }
-        sensorInterface->set_property("CurrentState", currentState);
-        sensorInterface->set_property("PreviousState", previousState);
-        currentStateReading = currentState;
-        previousStateReading = previousState;
+        sensor.sensorInterface->set_property("CurrentState", currentState);
+        sensor.sensorInterface->set_property("PreviousState", previousState);
+        sensor.currentStateReading = currentState;
+        sensor.previousStateReading = previousState;
     }
 
-    markAvailable(isAvailable);
-    markFunctional(isFunctional);
-    initializeInterface();
+    markAvailable(sensor, isAvailable);
+    markFunctional(sensor, isFunctional);
+    initializeInterface(sensor);
+}
+
+void StateSensorHandler::updateStates(const uint8_t currentState,
+                                      const uint8_t previousState,
+                                      bool isAvailable, bool isFunctional)
+{
+    for (size_t offset = 0; offset < compositeSensors.size(); offset++)
+    {
+        updateState(offset, currentState, previousState, isAvailable,
+                    isFunctional);
+    }
 }
 
 bool StateSensorHandler::handleSensorReading(
-    get_sensor_state_field& stateReading)
+    const size_t offset, get_sensor_state_field& stateReading)
 {
     switch (stateReading.sensor_op_state)
     {
         case PLDM_SENSOR_DISABLED: {
-            updateState(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE, sensorAvailable,
-                        sensorNonFunctional);
+            updateState(offset, PLDM_INVALID_VALUE, PLDM_INVALID_VALUE,
+                        sensorAvailable, sensorNonFunctional);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 "State sensor disabled",
                 phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+                phosphor::logging::entry("OFFSET=%zu", offset),
                 phosphor::logging::entry("TID=%d", _tid));
             break;
         }
         case PLDM_SENSOR_UNAVAILABLE: {
-            updateState(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE,
+            updateState(offset, PLDM_INVALID_VALUE, PLDM_INVALID_VALUE,
                         sensorUnavailable, sensorNonFunctional);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 "State sensor unavailable",
                 phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+                phosphor::logging::entry("OFFSET=%zu", offset),
                 phosphor::logging::entry("TID=%d", _tid));
             return false;
         }
         case PLDM_SENSOR_ENABLED: {
-            updateState(stateReading.present_state, stateReading.previous_state,
-                        sensorAvailable, sensorFunctional);
+            updateState(offset, stateReading.present_state,
+                        stateReading.previous_state, sensorAvailable,
+                        sensorFunctional);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 "GetStateSensorReadings success",
                 phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+                phosphor::logging::entry("OFFSET=%zu", offset),
                 phosphor::logging::entry("TID=%d", _tid));
             break;
         }
@@ -276,6 +327,7 @@ bool StateSensorHandler::handleSensorReading(
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 "State sensor operational status unknown",
                 phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+                phosphor::logging::entry("OFFSET=%zu", offset),
                 phosphor::logging::entry("TID=%d", _tid));
             return false;
         }
@@ -305,8 +357,8 @@ bool StateSensorHandler::setStateSensorEnables(boost::asio::yield_context yield)
             sensorOpState = PLDM_SENSOR_DISABLED;
             /** @brief Sensor disabled flag*/
             sensorDisabled = true;
-            updateState(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE, sensorAvailable,
-                        sensorNonFunctional);
+            updateStates(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE,
+                         sensorAvailable, sensorNonFunctional);
 
             break;
         default:
@@ -318,12 +370,16 @@ bool StateSensorHandler::setStateSensorEnables(boost::asio::yield_context yield)
     }
 
     int rc;
-    // TODO: PLDM events and composite sensor support
-    constexpr uint8_t compositeSensorCount = 1;
-    std::array<state_sensor_op_field, compositeSensorCount> opFields = {
-        {sensorOpState, PLDM_NO_EVENT_GENERATION}};
+    // TODO: PLDM events support
+    // All composite sensor offsets are enabled with the same operational state
+    const uint8_t compositeSensorCount =
+        static_cast<uint8_t>(compositeSensors.size());
+    std::array<state_sensor_op_field, maxCompositeSensorCount> opFields;
+    opFields.fill({sensorOpState, PLDM_NO_EVENT_GENERATION});
     std::vector<uint8_t> req(pldmMsgHdrSize +
-                             sizeof(pldm_set_state_sensor_enable_req));
+                             sizeof(pldm_set_state_sensor_enable_req) +
+                             (compositeSensorCount - 1U) *
+                                 sizeof(state_sensor_op_field));
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
 
     // TODO: Init state as per State Sensor Initialization PDR
@@ -364,14 +420,13 @@ bool StateSensorHandler::setStateSensorEnables(boost::asio::yield_context yield)
     return true;
 }
 
-bool StateSensorHandler::getStateSensorReadings(
-    boost::asio::yield_context yield)
+boost::asio::awaitable<bool> StateSensorHandler::getStateSensorReadings()
 {
     int rc;
     std::vector<uint8_t> req(pldmMsgHdrSize +
                              PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
-    // PLDM events and composite sensor are not supported
+    // PLDM events are not supported
     constexpr bitfield8_t sensorRearm = {0x00};
     constexpr uint8_t reserved = 0x00;
 
@@ -379,25 +434,23 @@ bool StateSensorHandler::getStateSensorReadings(
                                               sensorRearm, reserved, reqMsg);
     if (!validatePLDMReqEncode(_tid, rc, "GetStateSensorReadings"))
     {
-        return false;
+        co_return false;
     }
 
     std::vector<uint8_t> resp;
-    if (!sendReceivePldmMessage(yield, _tid, commandTimeout, commandRetryCount,
-                                req, resp))
+    if (!co_await sendReceivePldmMessage(_tid, commandTimeout,
+                                         commandRetryCount, req, resp))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to send or receive GetStateSensorReadings request",
             phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
             phosphor::logging::entry("TID=%d", _tid));
-        return false;
+        co_return false;
     }
 
     uint8_t completionCode;
-    // Pass compositeSensorCount as 1 to indicate that only one sensor instance
-    // is supported
-    uint8_t compositeSensorCount = 1;
-    constexpr size_t maxCompositeSensorCount = 0x08;
+    // All composite sensor offsets are returned by a single command
+    uint8_t compositeSensorCount = 0;
     std::array<get_sensor_state_field, maxCompositeSensorCount> stateField{};
     auto rspMsg = reinterpret_cast<pldm_msg*>(resp.data());
 
@@ -407,26 +460,44 @@ bool StateSensorHandler::getStateSensorReadings(
     if (!validatePLDMRespDecode(_tid, rc, completionCode,
                                 "GetStateSensorReadings"))
     {
-        return false;
+        co_return false;
+    }
+
+    if (compositeSensorCount != compositeSensors.size())
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Composite sensor count mismatch",
+            phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("COMPOSITE_SENSOR_COUNT=%d",
+                                     compositeSensorCount));
     }
 
-    // Handle only first value. Composite sensor not supported.
-    return handleSensorReading(stateField[0]);
+    bool status = true;
+    const size_t count =
+        std::min<size_t>(compositeSensorCount, compositeSensors.size());
+    for (size_t offset = 0; offset < count; offset++)
+    {
+        status = handleSensorReading(offset, stateField[offset]) && status;
+    }
+    co_return status && count == compositeSensors.size();
 }
 
-bool StateSensorHandler::populateSensorValue(boost::asio::yield_context yield)
+boost::asio::awaitable<bool> StateSensorHandler::populateSensorValue()
 {
     // No need to read the sensor if it is disabled
     if (_pdr->stateSensorData.sensor_init == PLDM_SENSOR_DISABLE)
     {
-        return false;
+        co_return false;
     }
-    if (!getStateSensorReadings(yield))
+    if (!co_await getStateSensorReadings())
     {
         incrementError();
-        return false;
+        co_return false;
     }
-    return true;
+    // Every composite sensor offset was read, so the sensor recovered
+    errCount = 0;
+    co_return true;
 }
 
 bool StateSensorHandler::sensorHandlerInit(boost::asio::yield_context yield)
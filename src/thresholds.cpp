@@ -93,8 +93,7 @@ static std::vector<ChangeParam> checkThresholds(NumericSensor& sensor,
                 {
                     std::stringstream assertLog;
                     assertLog << "Sensor " << sensor.name << " high threshold "
-                              << threshold.value << " assert: value " << value
-                              << " raw data " << sensor.rawValue;
+                              << threshold.value << " assert: value " << value;
                     phosphor::logging::log<phosphor::logging::level::DEBUG>(
                         assertLog.str().c_str());
                 }
@@ -121,8 +120,7 @@ static std::vector<ChangeParam> checkThresholds(NumericSensor& sensor,
                     std::stringstream assertLog;
                     assertLog << "Sensor " << sensor.name << " low threshold "
                               << threshold.value << " assert: value "
-                              << sensor.value << " raw data " << sensor.rawValue
-                              << "\n";
+                              << sensor.value << "\n";
                     phosphor::logging::log<phosphor::logging::level::DEBUG>(
                         assertLog.str().c_str());
                 }
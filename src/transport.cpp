@@ -0,0 +1,110 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "transport.hpp"
+
+namespace pldm
+{
+MCTPTransport::MCTPTransport(
+    std::shared_ptr<sdbusplus::asio::connection> conn,
+    const mctpw::MCTPConfiguration& config,
+    const mctpw::ReconfigurationCallback& onDeviceUpdate,
+    const mctpw::ReceiveMessageCallback& onMessage) :
+    wrapper(conn, config, onDeviceUpdate, onMessage),
+    smbusBinding(config.bindingType == mctpw::BindingType::mctpOverSmBus)
+{
+}
+
+void MCTPTransport::detectEndpoints(boost::asio::yield_context yield)
+{
+    wrapper.detectMctpEndpoints(yield);
+}
+
+std::vector<mctpw::eid_t> MCTPTransport::getEndpoints()
+{
+    std::vector<mctpw::eid_t> endpoints;
+    for (const auto& [eid, service] : wrapper.getEndpointMap())
+    {
+        endpoints.emplace_back(eid);
+    }
+    return endpoints;
+}
+
+Transport::SendReceiveStatus
+    MCTPTransport::sendReceiveYield(boost::asio::yield_context yield,
+                                    const mctpw::eid_t dstEid,
+                                    const std::vector<uint8_t>& request,
+                                    const std::chrono::milliseconds timeout)
+{
+    return wrapper.sendReceiveYield(yield, dstEid, request, timeout);
+}
+
+void MCTPTransport::sendReceiveAsync(ReceiveCallback callback,
+                                     const mctpw::eid_t dstEid,
+                                     const std::vector<uint8_t>& request,
+                                     const std::chrono::milliseconds timeout)
+{
+    wrapper.sendReceiveAsync(
+        [callback](boost::system::error_code ec, const auto& response) {
+            callback(ec, response);
+        },
+        dstEid, request, timeout);
+}
+
+Transport::SendStatus
+    MCTPTransport::sendYield(boost::asio::yield_context yield,
+                             const mctpw::eid_t dstEid, const uint8_t msgTag,
+                             const bool tagOwner,
+                             const std::vector<uint8_t>& payload)
+{
+    return wrapper.sendYield(yield, dstEid, msgTag, tagOwner, payload);
+}
+
+void MCTPTransport::sendAsync(SendCallback callback, const mctpw::eid_t dstEid,
+                              const uint8_t msgTag, const bool tagOwner,
+                              const std::vector<uint8_t>& payload)
+{
+    wrapper.sendAsync(callback, dstEid, msgTag, tagOwner, payload);
+}
+
+int MCTPTransport::reserveBandwidth(boost::asio::yield_context yield,
+                                    const mctpw::eid_t dstEid,
+                                    const uint16_t timeout)
+{
+    return wrapper.reserveBandwidth(yield, dstEid, timeout);
+}
+
+int MCTPTransport::releaseBandwidth(boost::asio::yield_context yield,
+                                    const mctpw::eid_t dstEid)
+{
+    return wrapper.releaseBandwidth(yield, dstEid);
+}
+
+void MCTPTransport::triggerDeviceDiscovery(const mctpw::eid_t dstEid)
+{
+    wrapper.triggerMCTPDeviceDiscovery(dstEid);
+}
+
+std::optional<std::string>
+    MCTPTransport::getDeviceLocation(const mctpw::eid_t dstEid)
+{
+    return wrapper.getDeviceLocation(dstEid);
+}
+
+bool MCTPTransport::supportsConcurrentRequests(const mctpw::eid_t)
+{
+    return !smbusBinding;
+}
+} // namespace pldm
@@ -16,27 +16,143 @@
 
 #include "utils.hpp"
 
-#include <iomanip>
+#include <endian.h>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <phosphor-logging/log.hpp>
-#include <sstream>
 
 namespace utils
 {
 
-void printVect(const std::string& msg, const std::vector<uint8_t>& vec)
+namespace
+{
+constexpr uint32_t crc32Polynomial = 0xEDB88320;
+constexpr size_t crc32Slices = 8;
+using CRC32Table = std::array<std::array<uint32_t, 256>, crc32Slices>;
+
+constexpr CRC32Table makeCRC32Table()
+{
+    CRC32Table table = {};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ crc32Polynomial : crc >> 1;
+        }
+        table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (size_t slice = 1; slice < crc32Slices; slice++)
+        {
+            uint32_t prev = table[slice - 1][i];
+            table[slice][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+        }
+    }
+    return table;
+}
+
+constexpr CRC32Table crc32Table = makeCRC32Table();
+} // namespace
+
+void dumpVect(std::string_view msg, const std::vector<uint8_t>& vec)
 {
     phosphor::logging::log<phosphor::logging::level::DEBUG>(
         ("Length:" + std::to_string(vec.size())).c_str());
 
-    std::stringstream ssVec;
-    ssVec << msg;
+    constexpr std::string_view hexDigits = "0123456789abcdef";
+    constexpr std::string_view bytePrefix = " 0x";
+    std::string dump(msg);
+    dump.reserve(msg.size() + vec.size() * (bytePrefix.size() + 2));
     for (auto re : vec)
     {
-        ssVec << " 0x" << std::hex << std::setfill('0') << std::setw(2)
-              << static_cast<int>(re);
+        dump += bytePrefix;
+        dump += hexDigits[re >> 4];
+        dump += hexDigits[re & 0x0F];
     }
-    phosphor::logging::log<phosphor::logging::level::DEBUG>(
-        ssVec.str().c_str());
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(dump.c_str());
+}
+
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size)
+{
+    crc = ~crc;
+    while (size >= crc32Slices)
+    {
+        uint32_t low = 0;
+        uint32_t high = 0;
+        std::memcpy(&low, data, sizeof(low));
+        std::memcpy(&high, data + sizeof(low), sizeof(high));
+        low = le32toh(low) ^ crc;
+        high = le32toh(high);
+        crc = crc32Table[7][low & 0xFF] ^ crc32Table[6][(low >> 8) & 0xFF] ^
+              crc32Table[5][(low >> 16) & 0xFF] ^ crc32Table[4][low >> 24] ^
+              crc32Table[3][high & 0xFF] ^ crc32Table[2][(high >> 8) & 0xFF] ^
+              crc32Table[1][(high >> 16) & 0xFF] ^ crc32Table[0][high >> 24];
+        data += crc32Slices;
+        size -= crc32Slices;
+    }
+    while (size--)
+    {
+        crc = crc32Table[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::vector<uint8_t> readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        return {};
+    }
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+}
+
+bool writeFileAtomic(const std::filesystem::path& path,
+                     const std::vector<uint8_t>& data, std::string_view name)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            ("Failed to create " + std::string(name) +
+             " directory. ERROR: " + ec.message())
+                .c_str());
+        return false;
+    }
+
+    // Write to a temporary file and rename it so that a crash while saving
+    // never leaves a partially written file behind
+    std::filesystem::path tmpFile = path;
+    tmpFile += ".tmp";
+    {
+        std::ofstream file(tmpFile,
+                           std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()),
+                   static_cast<std::streamsize>(data.size()));
+        if (!file.good())
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                ("Failed to write " + std::string(name)).c_str());
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpFile, path, ec);
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            ("Failed to commit " + std::string(name) +
+             ". ERROR: " + ec.message())
+                .c_str());
+        return false;
+    }
+    return true;
 }
 
 } // namespace utils